@@ -21,273 +21,64 @@
 
 #include "ai_defs.h"
 
-//Make one of these for EVERY TREE YOU MAKE.
-
-
-//     DEATH TREE      //
-/////////////////////////
-//
-//            Root^
-//             |
-//             |
-//         +---+------+
-//         |          |
-//      ShouldDie*   Die
-//         |
-//         |
-//         v
-//     +---+----+
-//     |        |
-//     |        |
-//  Inverter Inverter
-//     |        +
-//     |        |
-//     v        v
-//  InWorld  HasHealth
-//
-/////////////////////////////
-
-BNode* ai::DeathNode()
+namespace
 {
-    std::vector<BNode*> death_nodes;
-    std::vector<BNode*> should_die_nodes;
-    should_die_nodes.push_back(new InverterNode(new InWorld));
-    should_die_nodes.push_back(new InverterNode(new HasHealth));
-
-    PriorityNode* should_die = new PriorityNode(should_die_nodes);
-
-    death_nodes.push_back(should_die);
-    death_nodes.push_back(new Die);
-    return new SequenceNode(death_nodes);
+    /**
+     * The compiled trees, by the name of their root section.
+     */
+    typedef std::map<std::string, std::shared_ptr<const FlatTree>> programs_t;
+
+    const programs_t& programs()
+    {
+        static const programs_t compiled = []()
+        {
+            programs_t result;
+            for(auto& entry : ai::definitions())
+            {
+                if(entry.second.ai_id >= 0)
+                {
+                    BNode* root = ai::build(entry.first);
+                    result[entry.first] = std::make_shared<const FlatTree>(root);
+                    delete root;
+                }
+            }
+            return result;
+        }();
+        return compiled;
+    }
 }
 
-
-//////////////////////////////////////////////////////////////////////////////////////////////////////////
-//              * = Priority
-//              ^ = Sequence
-//              } = Branching Conditional
-//
-//
-//                                Root*
-//                                 +
-//                                 |
-//       +----------------------------------------------------+
-//       |                         |                          |
-//       |                         |                          v
-//    DeathNode                Attack^                    Wander
-//                                 |
-//                                 |
-//                        +--------+------------------+
-//                        |                           |
-//                        |                           v
-//                     GetTarget*                     }
-//                        |                           +
-//                        |                           |
-//                 +------+------+          +-------------------------------+
-//                 |             |          |         |                     |
-//                 v             v          v         |                     |
-//             HasValid   EnemyInRange  LowHealth   RunAway^             Attack^
-//                                                    |                     |
-//                                               +----+----+         +------+-------------+
-//                                               |         |         |                    |
-//                                               |         |         |                    }
-//                                               v         v         v                    |
-//                                            TurnAway Mo^eAway   TurnTowards    +----------------+
-//                                                                               |        |       |
-//                                                                               v        v       v
-//                                                                            NextTo    Attack MoveTowards
-//////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-BehaviorTree ai::GENERIC_AGGRESSIVE(Game* game)
+const behavior_load::nodedefs_t& ai::definitions()
 {
-    BranchingCondition* first = new BranchingCondition(new NextTo, new Attack, new MoveTowards);
-    std::vector<BNode*> attack_seq_nodes;
-    attack_seq_nodes.push_back(new TurnToward);
-    attack_seq_nodes.push_back(first);
-    SequenceNode* attack_seq = new SequenceNode(attack_seq_nodes);
-
-    std::vector<BNode*> run_seq_nodes;
-    run_seq_nodes.push_back(new TurnAway);
-    run_seq_nodes.push_back(new MoveAway);
-    SequenceNode* run_seq = new SequenceNode(run_seq_nodes);
-
-    BranchingCondition* second = new BranchingCondition(new LowHealth, run_seq, attack_seq);
-
-    std::vector<BNode*> has_target;
-    has_target.push_back(new ValidTarget);
-    has_target.push_back(new EnemyInRange);
-    PriorityNode* target_node = new PriorityNode(has_target);
-
-    std::vector<BNode*> attack_nodes;
-    attack_nodes.push_back(target_node);
-    attack_nodes.push_back(second);
-    SequenceNode* attack = new SequenceNode(attack_nodes);
-
-    //see above
-    BNode* death = DeathNode();
-
-    std::vector<BNode*> root;
-    root.push_back(death);
-    root.push_back(attack);
-    root.push_back(new Wander);
-    PriorityNode* root_node = new PriorityNode(root);
-
-
-    BehaviorTree tree = BehaviorTree(root_node, game, 0);
-    return tree;
+    static const behavior_load::nodedefs_t nodedefs = behavior_load::load_conf();
+    return nodedefs;
 }
 
-///////////////////////////////////////////////////////////////////////////////
-//
-//                              Root*
-//                               +
-//                               |
-//         +------------------------------------------------+
-//         |                     |                          |
-//         |                     v                          v
-//      DeathNode              Flee^                     Wander
-//                               +
-//                               |
-//                      +--------+------------+
-//                      |                     |
-//                      |                     |
-//                   GetTarget*             RunAway^
-//                      |                     |
-//                      |                +----+----+
-//               +------+------+         |         |
-//               |             |         |         |
-//               v             v         v         v
-//           HasValid   EnemyInRange  TurnAway Mo^eAway
-//
-////////////////////////////////////////////////////////////////////////////////
-
-BehaviorTree ai::GENERIC_PASSIVE(Game* game)
+BNode* ai::build(const std::string& name)
 {
-
-    std::vector<BNode*> run_seq_nodes;
-    run_seq_nodes.push_back(new TurnAway);
-    run_seq_nodes.push_back(new MoveAway);
-    SequenceNode* run_seq = new SequenceNode(run_seq_nodes);
-
-    std::vector<BNode*> has_target;
-    has_target.push_back(new ValidTarget);
-    has_target.push_back(new EnemyInRange);
-    PriorityNode* target_node = new PriorityNode(has_target);
-
-    std::vector<BNode*> flee_nodes;
-    flee_nodes.push_back(target_node);
-    flee_nodes.push_back(run_seq);
-    SequenceNode* flee = new SequenceNode(flee_nodes);
-
-    BNode* death = DeathNode();
-
-    std::vector<BNode*> root;
-    root.push_back(death);
-    root.push_back(flee);
-    root.push_back(new Wander);
-    PriorityNode* root_node = new PriorityNode(root);
-
-    BehaviorTree tree = BehaviorTree(root_node, game, 1);
-    return tree;
+    return behavior_load::build(definitions(), name);
 }
 
-/////////////////////////////////////////////////////////////////////////////////////
-//                               Root*
-//                                |
-//  +------------------------------------------------------------------------+
-//  |                             |                                          |
-//  |                             |                                          v
-//DeathNode                    Attack^                                      Follow^
-//                                |                                          |
-//             +-----------------------------+                     +---------+----------+
-//             |         |                   |                     |                    |
-//             |         |                   }                     |                    ^
-//             |         |                   |                     v                    |
-//    MHealthChange  GetMTarget    +---------+------------+     TurnTowardsM       +--------+
-//                                 |         |            |                        |        |
-//                                 v         v            v                        |        |
-//                               HasValid  Attack      FreakOut                 Inverter    |
-//                                           |                                     |        |
-//                                           }                                     |        |
-//                                           |                                     v        v
-//                                  +----------------+                          NextToM  MoveTowardM
-//                                  |        |       |
-//                                  v        v       v
-//                               NextTo Mo^eTowards Attack
-//
-////////////////////////////////////////////////////////////////////////////////////////////
-//Note: M designates "Master" here.
-BehaviorTree ai::FOLLOW(Game* game)
+BehaviorTree ai::tree(const std::string& name, Game* game)
 {
-    //Follow
-    std::vector<BNode*> follow_sub_nodes;
-    follow_sub_nodes.push_back(new InverterNode(new NextToM));
-    follow_sub_nodes.push_back(new MoveTowardsM);
-    SequenceNode* follow_sub = new SequenceNode(follow_sub_nodes);
-
-    std::vector<BNode*> follow_nodes;
-    follow_nodes.push_back(new TurnTowardM);
-    follow_nodes.push_back(follow_sub);
-    SequenceNode* follow = new SequenceNode(follow_nodes);
-
-    //Attack
-    BranchingCondition *bcond = new BranchingCondition(new NextTo, new Attack, new MoveTowards);
-    BranchingCondition *attack_branch = new BranchingCondition(new ValidTarget, bcond, new FreakOut);
-    std::vector<BNode*> attack_nodes;
-    attack_nodes.push_back(new MHealthChange);
-    attack_nodes.push_back(new GetMTarget);
-    attack_nodes.push_back(attack_branch);
-    SequenceNode* attack = new SequenceNode(attack_nodes);
-
-
-    //Death
-    BNode* death = DeathNode();
-
-    std::vector<BNode*> root;
-    root.push_back(death);
-    root.push_back(attack);
-    root.push_back(follow);
-    PriorityNode* root_node = new PriorityNode(root);
-
-    BehaviorTree tree = BehaviorTree(root_node, game, 2);
-    return tree;
+    return BehaviorTree(programs().at(name), game, definitions().at(name).ai_id);
 }
 
-//
-/////////////////////////////////////////////////////////////////////////////////////
-//                               Root*
-//                                |
-//  -------------------------------------------------------------------
-//  |                              |
-//  v                              v
-// Death                        Wander
-//
-//
-//
-//
-//
-//
-//
-//
-//
-//
-//
-//
-//
-//
-//
-//
-//
-////////////////////////////////////////////////////////////////////////////////////////////
-
-BehaviorTree ai::NPC(Game* game)
+std::vector<BehaviorTree> ai::all_trees(Game* game)
 {
-    std::vector<BNode*> root;
-    BNode* death = DeathNode();
-    root.push_back(death);
-    root.push_back(new Wander);
-    PriorityNode* root_node = new PriorityNode(root);
-
-    BehaviorTree tree = BehaviorTree(root_node, game, 3);
-    return tree;
+    std::map<int, std::string> roots;
+    for(auto& entry : definitions())
+    {
+        if(entry.second.ai_id >= 0)
+        {
+            roots[entry.second.ai_id] = entry.first;
+        }
+    }
+
+    std::vector<BehaviorTree> trees;
+    for(auto& root : roots)
+    {
+        trees.push_back(tree(root.second, game));
+    }
+    return trees;
 }
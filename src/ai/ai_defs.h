@@ -24,21 +24,45 @@
 #define _AI_DEFS_H
 
 #include <vector>
+#include <string>
+#include <memory>
 
 #include "behavior_tree.h"
 #include "behavior_node.h"
 #include "behavior_actor.h"
+#include "behavior_load.h"
 #include "game.h"
 
+/**
+ * The behavior trees, which are described in behavior.ini.  The file is
+ * read and every tree compiled the first time any of them are asked for,
+ * and after that every BehaviorTree with the same AI id runs the same
+ * FlatTree.
+ */
 namespace ai
 {
+    /**
+     * The sections of behavior.ini.
+     */
+    const behavior_load::nodedefs_t& definitions();
+
+    /**
+     * Makes the nodes for a section of behavior.ini, before they're
+     * compiled.  The caller owns them.
+     */
+    BNode* build(const std::string& name);
+
+    /**
+     * A tree for the section of behavior.ini with the given name, which
+     * has to be the root of a tree.
+     */
+    BehaviorTree tree(const std::string& name, Game* game);
 
-    BNode* DeathNode();
-    BehaviorTree GENERIC_AGGRESSIVE(Game* game);
-    BehaviorTree GENERIC_PASSIVE(Game* game);
-    BehaviorTree FOLLOW(Game* game);
-    BehaviorTree NPC(Game* game);
-    //extern BehaviorTree GENERIC_PASSIVE;
+    /**
+     * A tree for every section of behavior.ini with an ai_id, in order of
+     * their ids.
+     */
+    std::vector<BehaviorTree> all_trees(Game* game);
 }
 
 #endif
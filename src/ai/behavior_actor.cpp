@@ -21,22 +21,64 @@
 
 BActor::BActor()
 {
+    running_node = -1;
+    last_time = 0;
+    random = 0;
 }
 
 BActor::BActor(Character* _chara)
 {
-    chara = _chara;
+    chara = _chara->get_handle();
+    running_node = -1;
+    last_time = 0;
+    random = 0;
 }
 
 Character* BActor::get_character()
 {
-    return chara;
+    return Character::lookup(chara);
 }
 
 bool BActor::should_tick(long delta_ms)
 {
-   if(chara->act(delta_ms))
+   if(get_character()->act(delta_ms))
    {
        return true;
    }
+   return false;
+}
+
+bool BActor::catch_up(long now, int slowdown)
+{
+    long delta_ms = now - last_time;
+    last_time = now;
+    return should_tick(delta_ms / slowdown);
+}
+
+void BActor::set_last_time(long now)
+{
+    last_time = now;
+}
+
+int& BActor::get_running_node()
+{
+    return running_node;
+}
+
+void BActor::check_interrupts()
+{
+    if(get_character()->take_interrupts() != 0)
+    {
+        running_node = -1;
+    }
+}
+
+void BActor::set_random(unsigned int seed)
+{
+    random = seed;
+}
+
+unsigned int* BActor::get_random()
+{
+    return &random;
 }
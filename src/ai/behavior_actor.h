@@ -21,9 +21,6 @@
 #define _BEHAVIOR_ACTOR_H
 
 #include "character.h"
-#include "behavior_node.h"
-
-class BNode;
 
 /**
  * The actor class for behavior trees.  Holds information about a character
@@ -33,15 +30,29 @@ class BActor
 {
     private:
         /**
-         * The character associated with this actor.
+         * The character associated with this actor.  Once the character
+         * is deleted it stops finding anything, and the tree drops the
+         * actor.
          */
-        Character* chara;
+        CharacterHandle chara;
+
+       /**
+        * The node of the tree's FlatTree that the actor was left RUNNING
+        * in, or -1 if it should start from the root next time.
+        */
+       int running_node;
 
        /**
-        * Someday, perhaps, when I thread things, this will do something.
-        * For the nonce, it is a placeholder.
+        * The time on the tree's clock that the character's timer was last
+        * brought up to.
         */
-       BNode* running_node;
+       long last_time;
+
+       /**
+        * The seed for the character's random numbers, so that what it
+        * decides doesn't depend on when other characters decide.
+        */
+       unsigned int random;
 
     public:
 
@@ -58,6 +69,7 @@ class BActor
 
        /**
         * Accessor for the actor.
+        * @return The character, or NULL if it has been deleted.
         */
        Character* get_character();
 
@@ -66,6 +78,40 @@ class BActor
         * to act.
         */
        bool should_tick(long delta_ms);
+
+       /**
+        * Brings the character's timer up to the tree's clock, with
+        * should_tick().
+        * @param now The time on the tree's clock.
+        * @param slowdown How many times slower than normal the character
+        * is being run.  Its timer only gets that fraction of the time
+        * that has gone by, so it gets one turn for every slowdown turns
+        * it would have had.
+        */
+       bool catch_up(long now, int slowdown);
+
+       /**
+        * Starts the actor off at a time on the tree's clock.
+        */
+       void set_last_time(long now);
+
+       /**
+        * Where to pick up from on the next tick.
+        * @see FlatTree::run
+        */
+       int& get_running_node();
+
+       /**
+        * Sends the actor back to the root of the tree if anything has
+        * interrupted its character since the last tick.  Otherwise a
+        * long action carries on without the tree checking everything
+        * above it again.
+        */
+       void check_interrupts();
+
+       void set_random(unsigned int seed);
+
+       unsigned int* get_random();
 };
 
 #endif
@@ -21,11 +21,44 @@
 
 //---------------------------COMPOSITE NODES-----------------------//
 
-std::vector<BNode*> BNode::get_children()
+BNode::~BNode()
+{
+    for(size_t i = 0; i < nodes.size(); i++)
+    {
+        delete nodes[i];
+    }
+}
+
+const std::vector<BNode*>& BNode::get_children()
 {
     return nodes;
 }
 
+void BNode::set_name(const std::string& _name)
+{
+    name = _name;
+}
+
+const std::string& BNode::get_name()
+{
+    return name;
+}
+
+NodeOp BNode::get_op()
+{
+    return OP_LEAF;
+}
+
+LeafFunction BNode::get_leaf()
+{
+    return NULL;
+}
+
+bool BNode::is_resumable()
+{
+    return false;
+}
+
 void BNode::add_child(BNode* node, int index)
 {
     assert(index < nodes.size());
@@ -56,6 +89,11 @@ SequenceNode* SequenceNode::clone()
     return new SequenceNode(*this);
 }
 
+NodeOp SequenceNode::get_op()
+{
+    return OP_SEQUENCE;
+}
+
 PriorityNode::PriorityNode(std::vector<BNode*> _nodes)
 {
     nodes = _nodes;
@@ -81,6 +119,11 @@ PriorityNode* PriorityNode::clone()
     return new PriorityNode(*this);
 }
 
+NodeOp PriorityNode::get_op()
+{
+    return OP_PRIORITY;
+}
+
 
 BranchingCondition::BranchingCondition(BNode* condition, BNode* success, BNode* failure)
 {
@@ -111,6 +154,11 @@ BranchingCondition* BranchingCondition::clone()
     return new BranchingCondition(*this);
 }
 
+NodeOp BranchingCondition::get_op()
+{
+    return OP_BRANCH;
+}
+
 //---------------------------DECORATOR NODES-------------------------//
 
 InverterNode::InverterNode(BNode* node)
@@ -136,21 +184,20 @@ InverterNode* InverterNode::clone()
     return new InverterNode(*this);
 }
 
-//----------------------------CONDITION NODES------------------------//
-
-int EnemyInRange::tick(BActor actor, Game* game)
+NodeOp InverterNode::get_op()
 {
-    return game->find_target(actor.get_character());
+    return OP_INVERTER;
 }
 
-EnemyInRange* EnemyInRange::clone()
+//----------------------------CONDITION NODES------------------------//
+
+int EnemyInRange::run(Character* chara, Game* game)
 {
-    return new EnemyInRange(*this);
+    return game->find_target(chara);
 }
 
-int GetMTarget::tick(BActor actor, Game* game)
+int GetMTarget::run(Character* chara, Game* game)
 {
-    Character* chara = actor.get_character();
     if(chara->get_master() != NULL)
     {
         chara->set_target(chara->get_master()->get_target());
@@ -159,25 +206,13 @@ int GetMTarget::tick(BActor actor, Game* game)
     return FAILURE;
 }
 
-GetMTarget* GetMTarget::clone()
-{
-    return new GetMTarget(*this);
-}
-
-int LowHealth::tick(BActor actor, Game* game)
+int LowHealth::run(Character* chara, Game* game)
 {
-    Character* chara = actor.get_character();
     return (float)chara->get_cur_hp() < (.2 * (float)chara->get_max_hp());
 }
 
-LowHealth* LowHealth::clone()
+int NextTo::run(Character* chara, Game* game)
 {
-    return new LowHealth(*this);
-}
-
-int NextTo::tick(BActor actor, Game* game)
-{
-    Character* chara = actor.get_character();
     if(chara->get_target() == NULL)
     {
         return FAILURE;
@@ -185,14 +220,8 @@ int NextTo::tick(BActor actor, Game* game)
     return game->next_to_char(chara, chara->get_target());
 }
 
-NextTo* NextTo::clone()
-{
-    return new NextTo(*this);
-}
-
-int NextToM::tick(BActor actor, Game* game)
+int NextToM::run(Character* chara, Game* game)
 {
-    Character* chara = actor.get_character();
     if(chara->get_master() == NULL)
     {
         return FAILURE;
@@ -200,14 +229,8 @@ int NextToM::tick(BActor actor, Game* game)
     return game->next_to_char(chara, chara->get_master());
 }
 
-NextToM* NextToM::clone()
+int HasHealth::run(Character* chara, Game* game)
 {
-    return new NextToM(*this);
-}
-
-int HasHealth::tick(BActor actor, Game* game)
-{
-    Character* chara = actor.get_character();
     if(chara->get_cur_hp() <= 0)
     {
         return FAILURE;
@@ -215,15 +238,9 @@ int HasHealth::tick(BActor actor, Game* game)
     return SUCCESS;
 }
 
-HasHealth* HasHealth::clone()
+int MHealthChange::run(Character* chara, Game* game)
 {
-    return new HasHealth(*this);
-}
-
-int MHealthChange::tick(BActor actor, Game* game)
-{
-    Character* chara = actor.get_character();
-    if(chara->master_health_changed())
+    if(chara->get_master() != NULL && chara->master_health_changed())
     {
         chara->update_master_health();
         return SUCCESS;
@@ -234,26 +251,13 @@ int MHealthChange::tick(BActor actor, Game* game)
     }
 }
 
-MHealthChange* MHealthChange::clone()
-{
-    return new MHealthChange(*this);
-}
-
-
-int ValidTarget::tick(BActor actor, Game* game)
+int ValidTarget::run(Character* chara, Game* game)
 {
-    Character* chara = actor.get_character();
     return game->valid_target(chara, chara->get_target());
 }
 
-ValidTarget* ValidTarget::clone()
-{
-    return new ValidTarget(*this);
-}
-
-int InWorld::tick(BActor actor, Game* game)
+int InWorld::run(Character* chara, Game* game)
 {
-    Character* chara = actor.get_character();
     if(game->character_in_range(chara))
     {
         return SUCCESS;
@@ -264,68 +268,37 @@ int InWorld::tick(BActor actor, Game* game)
     }
 }
 
-InWorld* InWorld::clone()
-{
-    return new InWorld(*this);
-}
-
 //-------------------------ACTION NODES------------------------------//
 
-int MoveTowards::tick(BActor actor, Game* game)
+int MoveTowards::run(Character* chara, Game* game)
 {
-    Character* chara = actor.get_character();
     if(chara->get_target() == NULL)
     {
         return FAILURE;
     }
-    IntPoint goal_coords = chara->get_target()->get_coords();
-    IntPoint goal_chunk = chara->get_target()->get_chunk();
-    return game->move_to_point(chara, goal_coords, goal_chunk);
+    return game->move_towards(chara, chara->get_target());
 }
 
-MoveTowards* MoveTowards::clone()
+int MoveTowardsM::run(Character* chara, Game* game)
 {
-    return new MoveTowards(*this);
-}
-
-
-int MoveTowardsM::tick(BActor actor, Game* game)
-{
-    Character* chara = actor.get_character();
     if(chara->get_master() == NULL)
     {
         return FAILURE;
     }
-    IntPoint goal_coords = chara->get_master()->get_coords();
-    IntPoint goal_chunk = chara->get_master()->get_chunk();
-    return game->move_to_point(chara, goal_coords, goal_chunk);
-}
-
-MoveTowardsM* MoveTowardsM::clone()
-{
-    return new MoveTowardsM(*this);
+    return game->move_towards(chara, chara->get_master());
 }
 
-int MoveAway::tick(BActor actor, Game* game)
+int MoveAway::run(Character* chara, Game* game)
 {
-    Character* chara = actor.get_character();
     if(chara->get_target() == NULL)
     {
         return FAILURE;
     }
-    IntPoint goal_coords = chara->get_target()->get_coords();
-    IntPoint goal_chunk = chara->get_target()->get_chunk();
-    return game->run_away(actor.get_character(), goal_coords, goal_chunk);
+    return game->move_away(chara, chara->get_target());
 }
 
-MoveAway* MoveAway::clone()
+int Attack::run(Character* chara, Game* game)
 {
-    return new MoveAway(*this);
-}
-
-int Attack::tick(BActor actor, Game* game)
-{
-    Character* chara = actor.get_character();
     if(chara->get_target() == NULL)
     {
         return FAILURE;
@@ -333,78 +306,42 @@ int Attack::tick(BActor actor, Game* game)
     return game->attack_char(chara, chara->get_target());
 }
 
-Attack* Attack::clone()
-{
-    return new Attack(*this);
-}
-
-int Wander::tick(BActor actor, Game* game)
+int Wander::run(Character* chara, Game* game)
 {
-    Character* chara = actor.get_character();
     game->wander(chara);
     return RUNNING;
 }
 
-Wander* Wander::clone()
-{
-    return new Wander(*this);
-}
-
-
-int FreakOut::tick(BActor actor, Game* game)
+int FreakOut::run(Character* chara, Game* game)
 {
-    Character* chara = actor.get_character();
     game->wander(chara);
     return RUNNING;
 }
 
-FreakOut* FreakOut::clone()
-{
-    return new FreakOut(*this);
-}
-
-int Die::tick(BActor actor, Game* game)
+int Die::run(Character* chara, Game* game)
 {
     return DEAD;
 }
 
-Die* Die::clone()
-{
-    return new Die(*this);
-}
-
-int TurnToward::tick(BActor actor, Game* game)
+int TurnToward::run(Character* chara, Game* game)
 {
-    Character* chara = actor.get_character();
     game->turn_character(chara, chara->get_target());
     return SUCCESS;
 }
 
-TurnToward* TurnToward::clone()
+int TurnTowardM::run(Character* chara, Game* game)
 {
-    return new TurnToward(*this);
-}
-
-int TurnTowardM::tick(BActor actor, Game* game)
-{
-    Character* chara = actor.get_character();
+    if(chara->get_master() == NULL)
+    {
+        return FAILURE;
+    }
     game->turn_character(chara, chara->get_master());
     return SUCCESS;
 }
 
-TurnTowardM* TurnTowardM::clone()
+int TurnAway::run(Character* chara, Game* game)
 {
-    return new TurnTowardM(*this);
-}
-
-int TurnAway::tick(BActor actor, Game* game)
-{
-    Character* chara = actor.get_character();
     game->turn_away(chara, chara->get_target());
     return SUCCESS;
 }
 
-TurnAway* TurnAway::clone()
-{
-    return new TurnAway(*this);
-}
@@ -21,6 +21,7 @@
 #define _BEHAVIOR_NODE_H
 
 #include <vector>
+#include <string>
 #include <assert.h>
 
 #include "game.h"
@@ -36,6 +37,25 @@ enum NODE_STATES
     DEAD
 };
 
+/**
+ * What a node does with its children, so that FlatTree can run a tree
+ * without calling into the nodes themselves.
+ */
+enum NodeOp
+{
+    OP_SEQUENCE,
+    OP_PRIORITY,
+    OP_BRANCH,
+    OP_INVERTER,
+    OP_LEAF
+};
+
+/**
+ * The work that a leaf node does for a character, returning one of
+ * NODE_STATES.
+ */
+typedef int (*LeafFunction)(Character* chara, Game* game);
+
 /**
  * Defines the different nodes for a behavior tree.
  */
@@ -46,14 +66,28 @@ class BNode
          * The children nodes of the object.
          */
         std::vector<BNode*> nodes;
+
+        /**
+         * What the node is called in behavior.ini, for the profiler.
+         * Empty for nodes that were built by hand.
+         */
+        std::string name;
     public:
 
+        /**
+         * Deletes the children too.
+         */
+        virtual ~BNode();
+
         void add_child(BNode* node, int index);
 
         /**
          * Public accessor for the children nodes.
          */
-        std::vector<BNode*> get_children();
+        const std::vector<BNode*>& get_children();
+
+        void set_name(const std::string& _name);
+        const std::string& get_name();
 
         /**
          * Ticks the node forward once.
@@ -65,6 +99,62 @@ class BNode
          * Because wth c++.
          */
         virtual BNode* clone()=0;
+
+        /**
+         * What the node does with its children.  Leaves by default.
+         */
+        virtual NodeOp get_op();
+
+        /**
+         * The function that does a leaf's work, or NULL if this isn't a
+         * leaf.
+         */
+        virtual LeafFunction get_leaf();
+
+        /**
+         * Whether a tree that this node left RUNNING can come straight
+         * back to it on the next tick.
+         */
+        virtual bool is_resumable();
+};
+
+/**
+ * The base for leaf nodes.  A leaf only has to define
+ * static int run(Character* chara, Game* game), and this fills in the
+ * rest from it.
+ */
+template<typename Leaf>
+class LeafNode : public BNode
+{
+    public:
+        /**
+         * Leaves that keep at something for a while, like walking up to a
+         * target, set this to true in their own class.  When one of them
+         * says it's RUNNING, the actor carries on with it next tick
+         * instead of going through the whole tree again, until something
+         * interrupts it.
+         */
+        static const bool RESUMABLE = false;
+
+        int tick(BActor actor, Game* game)
+        {
+            return Leaf::run(actor.get_character(), game);
+        }
+
+        BNode* clone()
+        {
+            return new Leaf(*static_cast<Leaf*>(this));
+        }
+
+        LeafFunction get_leaf()
+        {
+            return &Leaf::run;
+        }
+
+        bool is_resumable()
+        {
+            return Leaf::RESUMABLE;
+        }
 };
 
 //-------------------------COMPOSITE NODES------------------//
@@ -79,6 +169,7 @@ class SequenceNode : public BNode
         SequenceNode(std::vector<BNode*> _nodes);
         int tick(BActor actor, Game* game);
         SequenceNode* clone();
+        NodeOp get_op();
 };
 
 /**
@@ -91,6 +182,7 @@ class PriorityNode : public BNode
         PriorityNode(std::vector<BNode*> nodes);
         int tick(BActor actor, Game* game);
         PriorityNode* clone();
+        NodeOp get_op();
 };
 
 /**
@@ -112,6 +204,7 @@ class BranchingCondition : public BNode
         BranchingCondition(BNode* condition, BNode* success, BNode* failure);
         int tick(BActor actor, Game* game);
         BranchingCondition* clone();
+        NodeOp get_op();
 };
 
 //---------------------------DECORATOR NODES---------------------//
@@ -124,147 +217,131 @@ class InverterNode : public BNode
         InverterNode(BNode* node);
         int tick(BActor actor, Game* game);
         InverterNode* clone();
+        NodeOp get_op();
 };
 
 
 //-------------------------------ACTION NODES---------------------//
 
-class MoveTowards : public BNode
+class MoveTowards : public LeafNode<MoveTowards>
 {
     public:
-        int tick(BActor actor, Game* game);
-        MoveTowards* clone();
+        static const bool RESUMABLE = true;
+        static int run(Character* chara, Game* game);
 };
 
 
-class MoveTowardsM : public BNode
+class MoveTowardsM : public LeafNode<MoveTowardsM>
 {
     public:
-        int tick(BActor actor, Game* game);
-        MoveTowardsM* clone();
+        static const bool RESUMABLE = true;
+        static int run(Character* chara, Game* game);
 };
 
-class MoveAway : public BNode
+class MoveAway : public LeafNode<MoveAway>
 {
     public:
-        int tick(BActor actor, Game* game);
-        MoveAway* clone();
+        static int run(Character* chara, Game* game);
 };
 
-class Attack : public BNode
+class Attack : public LeafNode<Attack>
 {
     public:
-        int tick(BActor actor, Game* game);
-        Attack* clone();
+        static int run(Character* chara, Game* game);
 };
 
-class Wander : public BNode
+class Wander : public LeafNode<Wander>
 {
     public:
-        int tick(BActor actor, Game* game);
-        Wander* clone();
+        static int run(Character* chara, Game* game);
 };
 
-class FreakOut : public BNode
+class FreakOut : public LeafNode<FreakOut>
 {
     public:
-        int tick(BActor actor, Game* game);
-        FreakOut* clone();
+        static int run(Character* chara, Game* game);
 };
 
-class Die : public BNode
+class Die : public LeafNode<Die>
 {
     public:
-        int tick(BActor actor, Game* game);
-        Die* clone();
+        static int run(Character* chara, Game* game);
 };
 
-class TurnToward : public BNode
+class TurnToward : public LeafNode<TurnToward>
 {
     public:
-        int tick(BActor actor, Game* game);
-        TurnToward* clone();
+        static int run(Character* chara, Game* game);
 };
 
-class TurnTowardM : public BNode
+class TurnTowardM : public LeafNode<TurnTowardM>
 {
     public:
-        int tick(BActor actor, Game* game);
-        TurnTowardM* clone();
+        static int run(Character* chara, Game* game);
 };
 
-class TurnAway : public BNode
+class TurnAway : public LeafNode<TurnAway>
 {
     public:
-        int tick(BActor actor, Game* game);
-        TurnAway* clone();
+        static int run(Character* chara, Game* game);
 };
 
 
 
 //------------------------------CONDITION NODES---------------------//
 
-class LowHealth : public BNode
+class LowHealth : public LeafNode<LowHealth>
 {
     public:
-        int tick(BActor actor, Game* game);
-        LowHealth* clone();
+        static int run(Character* chara, Game* game);
 };
 
-class EnemyInRange : public BNode
+class EnemyInRange : public LeafNode<EnemyInRange>
 {
     public:
-        int tick(BActor actor, Game* game);
-        EnemyInRange* clone();
+        static int run(Character* chara, Game* game);
 };
 
-class GetMTarget : public BNode
+class GetMTarget : public LeafNode<GetMTarget>
 {
     public:
-        int tick(BActor actor, Game* game);
-        GetMTarget* clone();
+        static int run(Character* chara, Game* game);
 };
 
-class NextTo : public BNode
+class NextTo : public LeafNode<NextTo>
 {
     public:
-        int tick(BActor actor, Game* game);
-        NextTo* clone();
+        static int run(Character* chara, Game* game);
 };
 
-class NextToM : public BNode
+class NextToM : public LeafNode<NextToM>
 {
     public:
-        int tick(BActor actor, Game* game);
-        NextToM* clone();
+        static int run(Character* chara, Game* game);
 };
 
-class HasHealth : public BNode
+class HasHealth : public LeafNode<HasHealth>
 {
     public:
-        int tick(BActor actor, Game* game);
-        HasHealth* clone();
+        static int run(Character* chara, Game* game);
 };
 
-class MHealthChange : public BNode
+class MHealthChange : public LeafNode<MHealthChange>
 {
     public:
-        int tick(BActor actor, Game* game);
-        MHealthChange* clone();
+        static int run(Character* chara, Game* game);
 };
 
-class InWorld : public BNode
+class InWorld : public LeafNode<InWorld>
 {
     public:
-        int tick(BActor actors, Game* game);
-        InWorld* clone();
+        static int run(Character* chara, Game* game);
 };
 
-class ValidTarget : public BNode
+class ValidTarget : public LeafNode<ValidTarget>
 {
     public:
-        int tick(BActor actor, Game* game);
-        ValidTarget* clone();
+        static int run(Character* chara, Game* game);
 };
 
 #endif
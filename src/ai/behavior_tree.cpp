@@ -17,106 +17,147 @@
  *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include "behavior_tree.h"
 
 BehaviorTree::BehaviorTree(BNode* node, Game* _game, int _id)
 {
-    root = node;
+    program = std::make_shared<const FlatTree>(node);
+    delete node;
     game = _game;
     id = _id;
     actors = std::vector<BActor>();
+    next_seed = _id + 1;
 }
 
-BehaviorTree::BehaviorTree(const BehaviorTree& tree)
-{
-    root = copy_tree(tree.root);
-    game = tree.game;
-    actors = tree.actors;
-    id = tree.id;
-}
-
-BehaviorTree& BehaviorTree::operator=(const BehaviorTree& tree)
+BehaviorTree::BehaviorTree(std::shared_ptr<const FlatTree> _program, Game* _game, int _id)
 {
-    delete_all(root);
-    root = copy_tree(tree.root);
-    game = tree.game;
-    actors = tree.actors;
-    id = tree.id;
+    program = _program;
+    game = _game;
+    id = _id;
+    actors = std::vector<BActor>();
+    next_seed = _id + 1;
 }
 
-
-BNode* BehaviorTree::copy_tree(BNode* node)
+void BehaviorTree::add_actor(BActor actor)
 {
-
-    BNode* new_node = node->clone();
-    std::vector<BNode*> nodes = node->get_children();
-    for(int i=0;i<nodes.size();i++)
+    int index;
+    if(free_actors.empty())
+    {
+        index = actors.size();
+        actors.push_back(actor);
+    }
+    else
     {
-        new_node->add_child(copy_tree(nodes[i]), i);
+        index = free_actors.back();
+        free_actors.pop_back();
+        actors[index] = actor;
     }
-    return new_node;
+    long now = schedule.get_time();
+    actors[index].set_last_time(now);
+    actors[index].set_random(next_seed * 2654435761u);
+    next_seed++;
+    schedule.schedule(index, now + actor.get_character()->time_to_act());
 }
 
-BehaviorTree::~BehaviorTree()
+void BehaviorTree::run_actors(long delta_ms)
 {
-    delete_all(root);
+    std::vector<int> acting;
+    pop_due(delta_ms, acting);
+    NodeProfiler& profiler = NodeProfiler::instance();
+    std::vector<NodeStats> profile;
+    if(profiler.enabled())
+    {
+        profile.resize(program->size());
+    }
+    for(int i=0;i<acting.size();i++)
+    {
+        finish(acting[i], decide(acting[i], stack, profile.empty() ? NULL : &profile[0]));
+    }
+    if(!profile.empty())
+    {
+        profiler.add(id, *program, profile);
+    }
 }
 
-void BehaviorTree::delete_all(BNode* node)
+void BehaviorTree::pop_due(long delta_ms, std::vector<int>& acting)
 {
-    std::vector<BNode*> nodes = node->get_children();
-    if(nodes.size() != 0)
+    acting.clear();
+    due.clear();
+    schedule.advance(schedule.get_time() + delta_ms, due);
+    long now = schedule.get_time();
+    for(int i=0;i<due.size();i++)
     {
-        for(int i=0;i<nodes.size();i++)
+        int index = due[i];
+        BActor& actor = actors[index];
+        Character* chara = actor.get_character();
+        if(chara == NULL)
         {
-            delete_all(nodes[i]);
+            free_actors.push_back(index);
+        }
+        else if(actor.catch_up(now, slowdown(chara)))
+        {
+            acting.push_back(index);
+        }
+        else
+        {
+            schedule.schedule(index, now + std::max(1L, chara->time_to_act() * slowdown(chara)));
         }
     }
-    delete node;
 }
 
-
-void BehaviorTree::add_actor(BActor actor)
+int BehaviorTree::decide(int index, std::vector<FlatTree::Frame>& frames, NodeStats* stats)
 {
-    actors.push_back(actor);
+    BActor& actor = actors[index];
+    actor.check_interrupts();
+    return program->run(actor.get_character(), game, frames, actor.get_running_node(), stats);
 }
 
-void BehaviorTree::run_actors(long delta_ms)
+void BehaviorTree::finish(int index, int status)
 {
-    for(int i=0;i<actors.size();i++)
+    Character* chara = actors[index].get_character();
+    if(chara == NULL)
     {
-        BActor actor = actors[i];
-        if(actor.should_tick(delta_ms))
+        //Removed while it was deciding.
+        free_actors.push_back(index);
+    }
+    else if(status == DEAD)
+    {
+        if(!game->character_in_range(chara))
+        {
+            game->leave_world(chara);
+        }
+        else
         {
-            int status = root->tick(actor, game);
-            if(status == DEAD)
-            {
-                if(!game->character_in_range(actor.get_character()))
-                {
-                    game->remove_enemy(actor.get_character());
-                }
-                else
-                {
-                    game->kill(actor.get_character());
-                }
-                actors.erase(actors.begin() + i);
-            }
+            game->kill(chara);
         }
+        actors[index] = BActor();
+        free_actors.push_back(index);
+    }
+    else
+    {
+        //Characters only act once a frame, however fast they are.
+        long wait = chara->time_to_act() * slowdown(chara);
+        schedule.schedule(index, schedule.get_time() + std::max(1L, wait));
     }
 }
 
-void BehaviorTree::remove_actor(Character* chara)
+int BehaviorTree::slowdown(Character* chara)
 {
-    for(int i=0;i<actors.size();i++)
-    {
-        if(actors[i].get_character() == chara)
-        {
-            actors.erase(actors.begin() + i);
-        }
-    }
+    return game->ai_detail(chara) == AI_COARSE ? COARSE_AI_RATE : 1;
+}
+
+unsigned int* BehaviorTree::get_random(int index)
+{
+    return actors[index].get_random();
 }
 
 int BehaviorTree::get_id()
 {
     return id;
 }
+
+const FlatTree& BehaviorTree::get_program() const
+{
+    return *program;
+}
@@ -21,9 +21,12 @@
 #define _BEHAVIOR_TREE_H
 
 #include <vector>
+#include <memory>
 
 #include "behavior_node.h"
+#include "flat_tree.h"
 #include "behavior_actor.h"
+#include "timing_wheel.h"
 
 /**
  * Oh boy, let's get started on behavior trees.
@@ -35,9 +38,9 @@ class BehaviorTree
 {
     private:
         /**
-         * The root node of the tree.
+         * The tree, compiled.  Copies of a BehaviorTree share it.
          */
-        BNode* root;
+        std::shared_ptr<const FlatTree> program;
 
         /**
          * The game that this tree should use.
@@ -50,40 +53,57 @@ class BehaviorTree
         int id;
 
         /**
-         * The actors in the tree.
+         * The actors in the tree.  An actor's place in here is its id in
+         * the schedule, so the actors of deleted characters stay behind,
+         * finding no character, until the schedule gets to them.
          */
         std::vector<BActor> actors;
 
         /**
-         * Deletes the nodes in the tree.
+         * Places in actors that can be used again.
          */
-        void delete_all(BNode* node);
+        std::vector<int> free_actors;
 
-    public:
         /**
-         * The default constructor.
+         * When each actor is next due to act.  Every actor that's in the
+         * tree is on it exactly once.
          */
-        BehaviorTree(BNode* node, Game* _game, int _id);
+        TimingWheel schedule;
+
+        /**
+         * The actors that came due this frame.
+         */
+        std::vector<int> due;
 
         /**
-         * The copy constructor.
+         * Scratch space for running the program.
          */
-        BehaviorTree(const BehaviorTree& tree);
+        std::vector<FlatTree::Frame> stack;
 
         /**
-         * The assignment operator.
+         * The seed handed to the next actor added.  It starts from the id,
+         * so the same actors added in the same order always get the same
+         * random numbers.
          */
-        BehaviorTree& operator=(const BehaviorTree& tree);
+        unsigned int next_seed;
 
         /**
-         * Deep copies the tree.
+         * How many times slower than normal a character gets its turns,
+         * going by Game::ai_detail().
          */
-        BNode* copy_tree(BNode* node);
+        int slowdown(Character* chara);
+
+    public:
+        /**
+         * The default constructor.  Compiles the nodes and then deletes
+         * them.
+         */
+        BehaviorTree(BNode* node, Game* _game, int _id);
 
         /**
-         * The destructor.
+         * Runs a program that's already been compiled, without copying it.
          */
-        ~BehaviorTree();
+        BehaviorTree(std::shared_ptr<const FlatTree> _program, Game* _game, int _id);
 
         /**
          * Adds an actor to the tree.
@@ -91,19 +111,48 @@ class BehaviorTree
         void add_actor(BActor actor);
 
         /**
-         * Runs all of the actors in the tree.
+         * Runs the actors whose turn it is.  Only those get looked at, so
+         * it takes about as long as the number of actors acting, however
+         * many are waiting.
          */
         void run_actors(long delta_ms);
 
         /**
-         * Removes the actor with a particular character.
+         * Moves the clock forward and finds the actors whose turn it is.
+         * Actors that are due but whose characters aren't ready to act yet
+         * go straight back on the schedule.  Every actor in acting has to
+         * be handed to finish() before the next call.
+         * @param acting Filled with the places of the actors that act.
          */
-        void remove_actor(Character* chara);
+        void pop_due(long delta_ms, std::vector<int>& acting);
+
+        /**
+         * Runs the tree for the actor at a place given by pop_due().
+         * Actors in different places can be decided at the same time, as
+         * long as every thread has its own stack.
+         * @param stats Passed on to FlatTree::run(), for the profiler.
+         * @return The status that the tree finished with.
+         */
+        int decide(int index, std::vector<FlatTree::Frame>& frames, NodeStats* stats = NULL);
+
+        /**
+         * Takes the actor off of the tree if its status was DEAD, and puts
+         * it back on the schedule otherwise.  Characters that died because
+         * they left the buffer go into the game's population model.
+         */
+        void finish(int index, int status);
+
+        /**
+         * The random seed of the actor at a place given by pop_due().
+         */
+        unsigned int* get_random(int index);
 
         /**
          * Accessor for the id.
          */
         int get_id();
+
+        const FlatTree& get_program() const;
 };
 
 #endif
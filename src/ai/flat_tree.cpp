@@ -0,0 +1,223 @@
+/**
+ *  FLAT_TREE.CPP
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include "flat_tree.h"
+
+FlatTree::FlatTree(BNode* root)
+{
+    //Going through the nodes a level at a time and handing out slots as
+    //they're reached puts everybody's children next to each other.
+    std::vector<BNode*> order(1, root);
+    std::vector<int> parents(1, -1);
+    std::vector<int> levels(1, 1);
+    depth = 1;
+    for(size_t i = 0; i < order.size(); i++)
+    {
+        BNode* current = order[i];
+        const std::vector<BNode*>& children = current->get_children();
+        FlatNode node = {current->get_op(), parents[i], (int)order.size(), (int)children.size(),
+            current->get_leaf(), current->is_resumable()};
+        nodes.push_back(node);
+        names.push_back(current->get_name());
+        order.insert(order.end(), children.begin(), children.end());
+        parents.insert(parents.end(), children.size(), (int)i);
+        levels.insert(levels.end(), children.size(), levels[i] + 1);
+        if(node.op != OP_LEAF)
+        {
+            depth = std::max(depth, levels[i]);
+        }
+    }
+}
+
+int FlatTree::run(Character* chara, Game* game, std::vector<Frame>& stack) const
+{
+    int running = -1;
+    return run(chara, game, stack, running);
+}
+
+int FlatTree::run(Character* chara, Game* game, std::vector<Frame>& stack, int& running,
+        NodeStats* stats) const
+{
+    if(nodes[0].op == OP_LEAF)
+    {
+        running = -1;
+        long start = stats ? NodeProfiler::now() : 0;
+        int status = nodes[0].leaf(chara, game);
+        if(stats)
+        {
+            stats[0].add(status, NodeProfiler::now() - start);
+        }
+        return status;
+    }
+
+    //Only composites and decorators get frames.  Leaves are run as soon
+    //as their parent picks them, and the parent looks at what they
+    //returned on the next time around.
+    if(stack.size() < (size_t)depth)
+    {
+        stack.resize(depth);
+    }
+    Frame* frames = &stack[0];
+    int top = 0;
+    frames[0].node = 0;
+    frames[0].next = 0;
+    frames[0].start = stats ? NodeProfiler::now() : 0;
+
+    //Whatever the last node to finish returned.
+    int status = FAILURE;
+
+    if(running > 0)
+    {
+        //Put the frames back the way they were when the leaf said it was
+        //RUNNING, with each of its ancestors having just started on the
+        //child that leads down to it, and run the leaf again.
+        top = -1;
+        for(int n = nodes[running].parent; n >= 0; n = nodes[n].parent)
+        {
+            top++;
+        }
+        int child = running;
+        for(int level = top; level >= 0; level--)
+        {
+            int parent = nodes[child].parent;
+            frames[level].node = parent;
+            frames[level].next = child - nodes[parent].first_child + 1;
+            frames[level].start = frames[0].start;
+            child = parent;
+        }
+        status = nodes[running].leaf(chara, game);
+        if(stats)
+        {
+            stats[running].add(status, NodeProfiler::now() - frames[0].start);
+        }
+        if(status != RUNNING)
+        {
+            running = -1;
+        }
+    }
+
+    while(top >= 0)
+    {
+        Frame& frame = frames[top];
+        const FlatNode& node = nodes[frame.node];
+        int child = -1;
+        switch(node.op)
+        {
+            case OP_SEQUENCE:
+                if(frame.next > 0 && status != SUCCESS)
+                {
+                    break;
+                }
+                if(frame.next == node.child_count)
+                {
+                    status = SUCCESS;
+                    break;
+                }
+                child = node.first_child + frame.next++;
+                break;
+
+            case OP_PRIORITY:
+                if(frame.next > 0 && status != FAILURE)
+                {
+                    break;
+                }
+                if(frame.next == node.child_count)
+                {
+                    status = FAILURE;
+                    break;
+                }
+                child = node.first_child + frame.next++;
+                break;
+
+            case OP_BRANCH:
+                //The condition, then the success or failure branch.
+                if(frame.next == 0)
+                {
+                    child = node.first_child;
+                    frame.next = 1;
+                }
+                else if(frame.next == 1 && (status == SUCCESS || status == FAILURE))
+                {
+                    child = node.first_child + (status == SUCCESS ? 1 : 2);
+                    frame.next = 2;
+                }
+                break;
+
+            case OP_INVERTER:
+                if(frame.next == 0)
+                {
+                    child = node.first_child;
+                    frame.next = 1;
+                }
+                else if(status == SUCCESS || status == FAILURE)
+                {
+                    status = !status;
+                }
+                break;
+
+            case OP_LEAF:
+                break;
+        }
+
+        if(child == -1)
+        {
+            if(stats)
+            {
+                stats[frame.node].add(status, NodeProfiler::now() - frame.start);
+            }
+            top--;
+        }
+        else if(nodes[child].op == OP_LEAF)
+        {
+            //RUNNING goes straight up to the root from wherever it
+            //started, so the last leaf to return it is the one running.
+            long start = stats ? NodeProfiler::now() : 0;
+            status = nodes[child].leaf(chara, game);
+            if(stats)
+            {
+                stats[child].add(status, NodeProfiler::now() - start);
+            }
+            running = (status == RUNNING && nodes[child].resumable) ? child : -1;
+        }
+        else
+        {
+            top++;
+            frames[top].node = child;
+            frames[top].next = 0;
+            frames[top].start = stats ? NodeProfiler::now() : 0;
+        }
+    }
+    return status;
+}
+
+int FlatTree::size() const
+{
+    return nodes.size();
+}
+
+const FlatNode& FlatTree::get_node(int index) const
+{
+    return nodes[index];
+}
+
+const std::string& FlatTree::get_name(int index) const
+{
+    return names[index];
+}
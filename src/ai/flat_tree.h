@@ -0,0 +1,135 @@
+/**
+ *  FLAT_TREE.H
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _FLAT_TREE_H
+#define _FLAT_TREE_H
+
+#include <vector>
+#include <string>
+
+#include "behavior_node.h"
+#include "node_profiler.h"
+
+/**
+ * A node of a FlatTree.  Its children sit next to each other in the
+ * tree's array, starting at first_child.
+ */
+struct FlatNode
+{
+    NodeOp op;
+
+    /**
+     * -1 for the root.
+     */
+    int parent;
+    int first_child;
+    int child_count;
+
+    /**
+     * What a leaf does.  NULL for everything else.
+     */
+    LeafFunction leaf;
+
+    /**
+     * @see LeafNode::RESUMABLE
+     */
+    bool resumable;
+};
+
+/**
+ * A behavior tree squashed into one array, so running it means walking
+ * an array of small structs instead of calling through a pointer for every
+ * node.  The nodes are laid out a level at a time from the root (which is
+ * node 0), so every node's children are together.
+ *
+ * Nothing about a FlatTree changes once it's compiled; it's only a
+ * description of the behavior.  Anything that has to be remembered
+ * between ticks belongs to the actor, so one FlatTree can be shared by
+ * every actor using that kind of tree.
+ */
+class FlatTree
+{
+    public:
+        /**
+         * Where the interpreter is in one node: which node, and how many
+         * of its children it has started on.
+         */
+        struct Frame
+        {
+            int node;
+            int next;
+
+            /**
+             * When the node was started on, if it's being profiled.
+             */
+            long start;
+        };
+
+        /**
+         * Compiles a tree of nodes.  The nodes aren't needed afterwards.
+         */
+        FlatTree(BNode* root);
+
+        /**
+         * Runs the tree once for a character, the same way that ticking
+         * the root BNode would.
+         * @param stack Scratch space for the interpreter, which can be
+         * reused from one call to the next to save allocating.
+         * @return One of NODE_STATES.
+         */
+        int run(Character* chara, Game* game, std::vector<Frame>& stack) const;
+
+        /**
+         * Runs the tree once for a character, picking up where it left
+         * off if it was in the middle of a resumable leaf.
+         * @param running The leaf that the character was left RUNNING in,
+         * or -1 to start from the root.  Gets set to the leaf that's
+         * RUNNING now, if it's resumable, and -1 otherwise.
+         * @param stats If it isn't NULL, one NodeStats for every node,
+         * which get the calls, results and time of each node that runs
+         * added to them.
+         */
+        int run(Character* chara, Game* game, std::vector<Frame>& stack, int& running,
+                NodeStats* stats = NULL) const;
+
+        int size() const;
+        const FlatNode& get_node(int index) const;
+
+        /**
+         * The name that a node was given before it was compiled.
+         */
+        const std::string& get_name(int index) const;
+
+    private:
+        std::vector<FlatNode> nodes;
+
+        /**
+         * The names of the nodes.  They're kept out of FlatNode, since
+         * they're only wanted by the profiler.
+         */
+        std::vector<std::string> names;
+
+        /**
+         * The most frames the interpreter will ever need at once: how
+         * deep the tree goes, not counting the leaves.
+         */
+        int depth;
+};
+
+#endif
@@ -0,0 +1,218 @@
+/**
+ *  NODE_PROFILER.CPP
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+#include "node_profiler.h"
+#include "flat_tree.h"
+
+namespace
+{
+    const char* OP_NAMES[] = {"sequence", "priority", "branch", "inverter", "leaf"};
+    const char* RESULT_NAMES[] = {"failure", "success", "running", "dead"};
+
+    std::string json_string(const std::string& s)
+    {
+        std::string quoted = "\"";
+        for(char c : s)
+        {
+            if(c == '"' || c == '\\')
+            {
+                quoted += '\\';
+            }
+            quoted += c;
+        }
+        return quoted + "\"";
+    }
+}
+
+NodeStats::NodeStats()
+{
+    calls = 0;
+    std::fill(results, results + 4, 0);
+    nanos = 0;
+}
+
+void NodeStats::merge(const NodeStats& other)
+{
+    calls += other.calls;
+    for(int i=0;i<4;i++)
+    {
+        results[i] += other.results[i];
+    }
+    nanos += other.nanos;
+}
+
+NodeProfiler& NodeProfiler::instance()
+{
+    static NodeProfiler profiler_instance;
+    return profiler_instance;
+}
+
+NodeProfiler::NodeProfiler()
+{
+    on = false;
+}
+
+void NodeProfiler::set_enabled(bool _on)
+{
+    on = _on;
+}
+
+void NodeProfiler::add(int tree_id, const FlatTree& program, std::vector<NodeStats>& stats)
+{
+    TreeStats& tree = trees[tree_id];
+    if(tree.program != &program || tree.nodes.size() != (size_t)program.size())
+    {
+        tree.program = &program;
+        tree.names.clear();
+        tree.ops.clear();
+        tree.parents.clear();
+        for(int i=0;i<program.size();i++)
+        {
+            const FlatNode& node = program.get_node(i);
+            std::string name = program.get_name(i);
+            tree.names.push_back(name.empty() ? OP_NAMES[node.op] : name);
+            tree.ops.push_back(OP_NAMES[node.op]);
+            tree.parents.push_back(node.parent);
+        }
+        tree.nodes = std::vector<NodeStats>(program.size());
+    }
+
+    for(int i=0;i<tree.nodes.size() && i<stats.size();i++)
+    {
+        tree.nodes[i].merge(stats[i]);
+        stats[i] = NodeStats();
+    }
+}
+
+void NodeProfiler::reset()
+{
+    trees.clear();
+}
+
+std::vector<int> NodeProfiler::get_trees()
+{
+    std::vector<int> ids;
+    for(auto& tree : trees)
+    {
+        ids.push_back(tree.first);
+    }
+    return ids;
+}
+
+long NodeProfiler::self_nanos(const TreeStats& tree, int node)
+{
+    long total = tree.nodes[node].nanos;
+    for(int i=node + 1;i<tree.parents.size();i++)
+    {
+        if(tree.parents[i] == node)
+        {
+            total -= tree.nodes[i].nanos;
+        }
+    }
+    return std::max(0L, total);
+}
+
+std::string NodeProfiler::report(int tree_id)
+{
+    auto found = trees.find(tree_id);
+    if(found == trees.end())
+    {
+        return "Nothing recorded for tree " + std::to_string(tree_id) + ".";
+    }
+    TreeStats& tree = found->second;
+
+    std::cout << "tree " << tree_id << ": node, calls, failure/success/running/dead, total us, self us" << std::endl;
+    std::vector<std::pair<long, int>> by_self;
+
+    //The nodes are stored a level at a time, so go down from the root to
+    //print every node under its parent.
+    std::vector<std::pair<int, int>> pending(1, std::make_pair(0, 0));
+    while(!pending.empty())
+    {
+        int i = pending.back().first;
+        int depth = pending.back().second;
+        pending.pop_back();
+        for(int j=tree.parents.size() - 1;j>i;j--)
+        {
+            if(tree.parents[j] == i)
+            {
+                pending.push_back(std::make_pair(j, depth + 1));
+            }
+        }
+
+        const NodeStats& stats = tree.nodes[i];
+        long self = self_nanos(tree, i);
+        by_self.push_back(std::make_pair(self, i));
+        std::cout << std::string(depth * 2, ' ') << tree.names[i] << ", " << stats.calls << ", "
+            << stats.results[0] << "/" << stats.results[1] << "/" << stats.results[2] << "/"
+            << stats.results[3] << ", " << stats.nanos / 1000 << ", " << self / 1000 << std::endl;
+    }
+
+    std::sort(by_self.rbegin(), by_self.rend());
+    std::stringstream summary;
+    summary << "Tree " << tree_id << ", slowest:";
+    for(int i=0;i<3 && i<by_self.size();i++)
+    {
+        summary << " " << tree.names[by_self[i].second] << " " << by_self[i].first / 1000 << "us";
+    }
+    return summary.str();
+}
+
+bool NodeProfiler::dump_json(std::string file_name)
+{
+    std::ofstream out(file_name.c_str());
+    if(!out.good())
+    {
+        return false;
+    }
+
+    out << std::fixed << std::setprecision(3);
+    out << "{\"trees\": [";
+    bool first_tree = true;
+    for(auto& entry : trees)
+    {
+        TreeStats& tree = entry.second;
+        out << (first_tree ? "" : ",") << "\n  {\"id\": " << entry.first << ", \"nodes\": [";
+        first_tree = false;
+        for(int i=0;i<tree.nodes.size();i++)
+        {
+            const NodeStats& stats = tree.nodes[i];
+            out << (i == 0 ? "" : ",") << "\n    {\"index\": " << i
+                << ", \"name\": " << json_string(tree.names[i])
+                << ", \"op\": \"" << tree.ops[i] << "\""
+                << ", \"parent\": " << tree.parents[i]
+                << ", \"calls\": " << stats.calls;
+            for(int r=0;r<4;r++)
+            {
+                out << ", \"" << RESULT_NAMES[r] << "\": " << stats.results[r];
+            }
+            out << ", \"total_us\": " << stats.nanos / 1000.0
+                << ", \"self_us\": " << self_nanos(tree, i) / 1000.0 << "}";
+        }
+        out << "\n  ]}";
+    }
+    out << "\n]}" << std::endl;
+    return true;
+}
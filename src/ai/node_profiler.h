@@ -0,0 +1,149 @@
+/**
+ *  NODE_PROFILER.H
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _NODE_PROFILER_H
+#define _NODE_PROFILER_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+
+class FlatTree;
+
+/**
+ * What one node of a behavior tree has been up to: how many times it
+ * ran, what it returned, and how long it took, including its children.
+ */
+struct NodeStats
+{
+    long calls;
+
+    /**
+     * How many times it returned each of NODE_STATES.
+     */
+    long results[4];
+    long nanos;
+
+    NodeStats();
+
+    void add(int status, long elapsed)
+    {
+        calls++;
+        if(status >= 0 && status < 4)
+        {
+            results[status]++;
+        }
+        nanos += elapsed;
+    }
+
+    void merge(const NodeStats& other);
+};
+
+/**
+ * A singleton which adds up NodeStats for every node of every behavior
+ * tree, by the tree's AI id.
+ *
+ * It's off until it's turned on from the debug console.  While it's off,
+ * FlatTree::run() gets no stats to fill in, so all it costs is checking
+ * a NULL pointer at each node.  While it's on, the threads deciding AI
+ * turns each fill in their own NodeStats, which get handed to add() once
+ * the turns are done, so nothing here has to be locked.
+ */
+class NodeProfiler
+{
+    public:
+        static NodeProfiler& instance();
+
+        /**
+         * Nanoseconds since some point.  The frame timers only go down to
+         * microseconds, and most leaves take less than one.
+         */
+        static long now()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        bool enabled() const
+        {
+            return on;
+        }
+
+        void set_enabled(bool _on);
+
+        /**
+         * Adds a tree's stats to the totals for its id, and zeros them.
+         * If the id was being used by a different program, its totals
+         * start over.
+         * @param stats One for each node of the program.
+         */
+        void add(int tree_id, const FlatTree& program, std::vector<NodeStats>& stats);
+
+        /**
+         * Throws away everything that has been recorded.
+         */
+        void reset();
+
+        /**
+         * The ids of the trees that have stats, in order.
+         */
+        std::vector<int> get_trees();
+
+        /**
+         * Prints a table of every node of a tree to stdout.
+         * @return A line about the nodes that took the longest by
+         * themselves, short enough for the debug console.
+         */
+        std::string report(int tree_id);
+
+        /**
+         * Writes everything that has been recorded to a JSON file.
+         * @return True if the file could be written.
+         */
+        bool dump_json(std::string file_name);
+
+    private:
+        /**
+         * The totals for one tree, with enough of its program to make
+         * sense of them.
+         */
+        struct TreeStats
+        {
+            const FlatTree* program;
+            std::vector<std::string> names;
+            std::vector<std::string> ops;
+            std::vector<int> parents;
+            std::vector<NodeStats> nodes;
+        };
+
+        std::map<int, TreeStats> trees;
+        bool on;
+
+        /**
+         * The time that a node took, not counting its children.
+         */
+        long self_nanos(const TreeStats& tree, int node);
+
+        NodeProfiler();
+        NodeProfiler(NodeProfiler const&);
+        NodeProfiler& operator=(NodeProfiler const&);
+};
+
+#endif
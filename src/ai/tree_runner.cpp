@@ -0,0 +1,116 @@
+/**
+ *  TREE_RUNNER.CPP
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tree_runner.h"
+
+TreeRunner::TreeRunner(int workers) : pool(workers)
+{
+    this->workers = std::vector<Worker>(pool.get_workers());
+    profiling = false;
+}
+
+void TreeRunner::run(std::vector<BehaviorTree>& trees, Game* game, long delta_ms)
+{
+    turns.clear();
+    for(int i=0;i<trees.size();i++)
+    {
+        trees[i].pop_due(delta_ms, acting);
+        for(int j=0;j<acting.size();j++)
+        {
+            Turn turn = {i, acting[j], 0, 0, 0, 0};
+            turns.push_back(turn);
+        }
+    }
+
+    profiling = NodeProfiler::instance().enabled();
+    for(int i=0;i<workers.size();i++)
+    {
+        workers[i].context.commands.clear();
+        workers[i].context.changed = false;
+        if(profiling)
+        {
+            workers[i].profile.resize(trees.size());
+            for(int j=0;j<trees.size();j++)
+            {
+                workers[i].profile[j].resize(trees[j].get_program().size());
+            }
+        }
+    }
+    pool.run(turns.size(), [this, &trees](int index, int worker)
+    {
+        decide(trees, turns[index], worker);
+    });
+
+    bool changed = false;
+    for(int i=0;i<workers.size();i++)
+    {
+        changed = changed || workers[i].context.changed;
+    }
+    if(changed)
+    {
+        game->bump_generation();
+    }
+
+    for(int i=0;i<turns.size();i++)
+    {
+        const std::vector<AICommand>& commands = workers[turns[i].worker].context.commands;
+        for(int j=turns[i].first;j<turns[i].first + turns[i].count;j++)
+        {
+            game->apply_command(commands[j]);
+        }
+    }
+    for(int i=0;i<turns.size();i++)
+    {
+        trees[turns[i].tree].finish(turns[i].actor, turns[i].status);
+    }
+
+    if(profiling)
+    {
+        for(int i=0;i<workers.size();i++)
+        {
+            for(int j=0;j<trees.size();j++)
+            {
+                NodeProfiler::instance().add(trees[j].get_id(), trees[j].get_program(),
+                        workers[i].profile[j]);
+            }
+        }
+    }
+}
+
+int TreeRunner::get_workers() const
+{
+    return pool.get_workers();
+}
+
+void TreeRunner::decide(std::vector<BehaviorTree>& trees, Turn& turn, int worker)
+{
+    Worker& mine = workers[worker];
+    BehaviorTree& tree = trees[turn.tree];
+    mine.context.random = tree.get_random(turn.actor);
+    turn.worker = worker;
+    turn.first = mine.context.commands.size();
+
+    Game::set_deciding(&mine.context);
+    NodeStats* stats = profiling ? &mine.profile[turn.tree][0] : NULL;
+    turn.status = tree.decide(turn.actor, mine.stack, stats);
+    Game::set_deciding(NULL);
+
+    turn.count = mine.context.commands.size() - turn.first;
+    mine.context.random = NULL;
+}
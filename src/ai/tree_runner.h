@@ -0,0 +1,117 @@
+/**
+ *  TREE_RUNNER.H
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _TREE_RUNNER_H
+#define _TREE_RUNNER_H
+
+#include <vector>
+
+#include "behavior_tree.h"
+#include "work_pool.h"
+#include "node_profiler.h"
+#include "game.h"
+
+/**
+ * Runs the actors of every behavior tree for a frame, with the thinking
+ * split up between threads.
+ *
+ * A frame goes in two halves.  While the actors decide, the world doesn't
+ * change: every actor whose turn it is runs its tree at the same time as
+ * the others, on a WorkPool, and anything it does to the world (moving,
+ * attacking) is written down as an AICommand instead of being done.  Then
+ * the commands are carried out on one thread, a tree at a time and in the
+ * order the actors came due in each tree, so when two actors go for the
+ * same tile the one that came first gets it, whichever one finished
+ * deciding first.  Actors that died go last, once everything has been
+ * carried out.
+ *
+ * Nothing an actor decides depends on the order that the others were
+ * decided in, so a frame comes out the same with any number of workers.
+ *
+ * While the NodeProfiler is on, each worker keeps its own stats for every
+ * tree, and they're handed over once the commands have been carried out.
+ */
+class TreeRunner
+{
+    public:
+        /**
+         * @param workers How many threads to decide on.  0 means one for
+         * every core.
+         */
+        TreeRunner(int workers = 0);
+
+        /**
+         * Moves every tree's clock forward, and runs the actors whose turn
+         * it is.
+         */
+        void run(std::vector<BehaviorTree>& trees, Game* game, long delta_ms);
+
+        int get_workers() const;
+
+    private:
+        /**
+         * An actor acting this frame, and what came of it.
+         */
+        struct Turn
+        {
+            int tree;
+            int actor;
+            int status;
+
+            /**
+             * Where its commands are: which worker's context, and the
+             * first one and how many.
+             */
+            int worker;
+            int first;
+            int count;
+        };
+
+        /**
+         * What a worker keeps between frames.
+         */
+        struct Worker
+        {
+            DecideContext context;
+            std::vector<FlatTree::Frame> stack;
+
+            /**
+             * Stats for each node of each tree, by the tree's place in
+             * the list.  Empty while the profiler is off.
+             */
+            std::vector<std::vector<NodeStats>> profile;
+        };
+
+        WorkPool pool;
+        std::vector<Worker> workers;
+        std::vector<Turn> turns;
+        std::vector<int> acting;
+
+        /**
+         * Whether the profiler was on at the start of this frame.
+         */
+        bool profiling;
+
+        /**
+         * Runs the tree for one turn, on a worker.
+         */
+        void decide(std::vector<BehaviorTree>& trees, Turn& turn, int worker);
+};
+
+#endif
@@ -19,57 +19,71 @@
  *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include "character.h"
 
+void* Character::operator new(size_t size)
+{
+    return ObjectPool::get("characters", size).allocate();
+}
+
+void Character::operator delete(void* memory)
+{
+    ObjectPool::release(memory);
+}
+
 Character::Character() {
     corpse = NULL;
+    interrupts = 0;
+    handle = CharacterStore::instance().add(this);
 }
 
 Character::Character(int _x, int _y, int _depth)
 {
+    handle = CharacterStore::instance().add(this);
     stats.resize(3);
-    x = _x;
-    y = _y;
-    chunk = IntPoint(0, 0);
-    depth = _depth;
-    target = NULL;
+    set_x(_x);
+    set_y(_y);
+    set_chunk(IntPoint(0, 0));
+    set_depth(_depth);
     equipment = vector<Item*>(7);
     conscious = true;
     level_up = 0;
-    master = NULL;
     master_health = 0;
+    interrupts = 0;
 }
 
 Character::Character(std::vector<int> _stats, int _x, int _y, Tile _sprite, MiscType _corpse, int _chunk_x, int _chunk_y, int _depth, int _morality, int _speed, int _ai_id, std::string _name, WeaponType wep) {
 
-    timer = 0;
+    handle = CharacterStore::instance().add(this);
+    CharacterStore& store = CharacterStore::instance();
+    int place = row();
     stats = _stats;
-    current_stats = stats;
+    reset_current_stats();
     stats[EXPERIENCE] = exp_to_level();
-    x = _x;
-    y = _y;
-    moral = _morality;
-    corpse = new Misc(IntPoint(y, x), _corpse);
+    store.x[place] = _x;
+    store.y[place] = _y;
+    store.moral[place] = _morality;
+    corpse = new Misc(IntPoint(_y, _x), _corpse);
     //somewhat temporary
     sprite = _sprite;
-    chunk = IntPoint(_chunk_y, _chunk_x);
-    depth = _depth;
-    speed = _speed;
+    store.chunk_row[place] = _chunk_y;
+    store.chunk_col[place] = _chunk_x;
+    store.depth[place] = _depth;
+    store.speed[place] = _speed;
     ai_id = _ai_id;
-    target = NULL;
     equipment = vector<Item*>(7);
     conscious = true;
     name = _name;
-    master = NULL;
     master_health = 0;
+    interrupts = 0;
 
     //These won't do anything for anyone except the enemy, for now.  But,
     //they're here if we need them.
     level_up = 0;
-    direction = 0;
     sight = 20;
     view = 20;
-    natural_weapon = Weapon(IntPoint(y, x), wep);
+    natural_weapon = Weapon(IntPoint(_y, _x), wep);
 }
 
 Character::~Character()
@@ -83,16 +97,18 @@ Character::~Character()
         delete inventory[i];
     }
     delete corpse;
+
+    //Anything still holding the handle finds nothing from now on.
+    set_master(NULL);
+    CharacterStore::instance().remove(handle);
 }
 
 Character::Character(const Character& chara)
 {
-    timer = chara.timer;
+    handle = CharacterStore::instance().add(this);
+    CharacterStore::instance().copy_row(chara.row(), row());
     stats = chara.stats;
     current_stats = chara.current_stats;
-    x = chara.x;
-    y = chara.y;
-    moral = chara.moral;
 
     if(chara.corpse != NULL)
     {
@@ -118,17 +134,14 @@ Character::Character(const Character& chara)
 
     //somewhat temporary
     sprite = chara.sprite;
-    chunk = chara.chunk;
-    depth = chara.depth;
-    speed = chara.speed;
     ai_id = chara.ai_id;
     target = chara.target;
     conscious = chara.conscious;
     master = chara.master;
     master_health = chara.master_health;
+    interrupts = chara.interrupts;
     //These won't do anything for anyone except the enemy, for now.  But,
     //they're here if we need them.
-    direction = chara.direction;
     sight = chara.sight;
     view = chara.view;
     level_up = chara.level_up;
@@ -137,12 +150,9 @@ Character::Character(const Character& chara)
 
 Character& Character::operator=(const Character& chara)
 {
-    timer = chara.timer;
+    CharacterStore::instance().copy_row(chara.row(), row());
     stats = chara.stats;
     current_stats = chara.current_stats;
-    x = chara.x;
-    y = chara.y;
-    moral = chara.moral;
 
     delete corpse;
     if(chara.corpse != NULL)
@@ -186,17 +196,14 @@ Character& Character::operator=(const Character& chara)
 
     //somewhat temporary
     sprite = chara.sprite;
-    chunk = chara.chunk;
-    depth = chara.depth;
-    speed = chara.speed;
     ai_id = chara.ai_id;
     target = chara.target;
     conscious = chara.conscious;
     master = chara.master;
     master_health = chara.master_health;
+    interrupts = chara.interrupts;
     //These won't do anything for anyone except the enemy, for now.  But,
     //they're here if we need them.
-    direction = chara.direction;
     sight = chara.sight;
     view = chara.view;
     level_up = chara.level_up;
@@ -205,10 +212,12 @@ Character& Character::operator=(const Character& chara)
 
 bool Character::act(long ms)
 {
-    timer += ms;
-    if(timer >= speed)
+    CharacterStore& store = CharacterStore::instance();
+    int place = row();
+    store.timer[place] += ms;
+    if(store.timer[place] >= store.speed[place])
     {
-        timer -= speed;
+        store.timer[place] -= store.speed[place];
         gain_endurance(1);
         if(!is_conscious())
         {
@@ -222,8 +231,17 @@ bool Character::act(long ms)
     return false;
 }
 
+long Character::time_to_act() const
+{
+    const CharacterStore& store = CharacterStore::instance();
+    int place = row();
+    long timer = store.timer[place];
+    int speed = store.speed[place];
+    return timer >= speed ? 0 : speed - timer;
+}
+
 bool Character::is_alive() const {
-    if (current_stats[HEALTH] <= 0){
+    if (CharacterStore::instance().hp[row()] <= 0){
         return false;
     } else {
         return true;
@@ -245,7 +263,22 @@ void Character::take_damage(Weapon* weapon, int part_hit, int strength){
 
 
     //deal the damage
-    current_stats[HEALTH] -= damage;
+    current_stat(HEALTH) -= damage;
+    interrupt(INTERRUPT_DAMAGED);
+    for(int i=0;i<followers.size();)
+    {
+        Character* follower = lookup(followers[i]);
+        if(follower == NULL)
+        {
+            followers[i] = followers.back();
+            followers.pop_back();
+        }
+        else
+        {
+            follower->interrupt(INTERRUPT_MASTER_HURT);
+            i++;
+        }
+    }
 
     stringstream ss;
     ss<<"You were hit in the "<<BODY_PARTS[part_hit]<<" and have taken "<<damage<<" points of damage.";
@@ -400,57 +433,64 @@ void Character::remove_all()
 
 
 void Character::set_x(int _x) {
-    x = _x;
+    CharacterStore::instance().x[row()] = _x;
 }
 
 void Character::set_y(int _y) {
-    y = _y;
+    CharacterStore::instance().y[row()] = _y;
 }
 
 void Character::set_depth(int d) {
-    depth = d;
+    CharacterStore::instance().depth[row()] = d;
 }
 
 int Character::get_x() {
-    return x;
+    return CharacterStore::instance().x[row()];
 }
 
 int Character::get_y() {
-    return y;
+    return CharacterStore::instance().y[row()];
 }
 
 IntPoint Character::get_coords(){
-    return IntPoint(y, x);
+    CharacterStore& store = CharacterStore::instance();
+    int place = row();
+    return IntPoint(store.y[place], store.x[place]);
 }
 
 int Character::get_chunk_x()
 {
-    return chunk.col;
+    return CharacterStore::instance().chunk_col[row()];
 }
 
 int Character::get_chunk_y()
 {
-    return chunk.row;
+    return CharacterStore::instance().chunk_row[row()];
 }
 
 IntPoint Character::get_chunk()
 {
-    return chunk;
+    CharacterStore& store = CharacterStore::instance();
+    int place = row();
+    return IntPoint(store.chunk_row[place], store.chunk_col[place]);
 }
 
 void Character::set_chunk(IntPoint _chunk)
 {
-    chunk = _chunk;
+    CharacterStore& store = CharacterStore::instance();
+    int place = row();
+    store.chunk_row[place] = _chunk.row;
+    store.chunk_col[place] = _chunk.col;
 }
 
 void Character::set_chunk_x(int _chunk_x)
 {
-    chunk.col = _chunk_x;
+    CharacterStore::instance().chunk_col[row()] = _chunk_x;
 }
 
 void Character::set_chunk_y(int _chunk_y)
 {
-    chunk.row = _chunk_y;
+    CharacterStore::instance().chunk_row[row()] = _chunk_y;
 }
 
 
@@ -463,17 +503,17 @@ Item* Character::get_corpse(){
 }
 
 int Character::get_depth() {
-    return depth;
+    return CharacterStore::instance().depth[row()];
 }
 
 void Character::set_target(Character* _target)
 {
-    target = _target;
+    target = _target != NULL ? _target->handle : CharacterHandle();
 }
 
 Character* Character::get_target()
 {
-    return target;
+    return lookup(target);
 }
 
 int Character::get_max_hp()
@@ -483,12 +523,12 @@ int Character::get_max_hp()
 
 int Character::get_cur_hp()
 {
-    return current_stats[HEALTH];
+    return CharacterStore::instance().hp[row()];
 }
 
 int Character::get_moral()
 {
-    return moral;
+    return CharacterStore::instance().moral[row()];
 }
 
 int Character::get_armor_hit(int body_part, int type)
@@ -528,12 +568,12 @@ void Character::consume_item(Item* item)
         }
         else
         {
-            current_stats[stat] += amount;
+            current_stat(stat) += amount;
             if(((Consumable*)item)->get_type() == consumables::RESTORE)
             {
-                if(current_stats[stat] > stats[stat])
+                if(current_stat(stat) > stats[stat])
                 {
-                    current_stats[stat] = stats[stat];
+                    current_stat(stat) = stats[stat];
                 }
             }
         }
@@ -553,12 +593,27 @@ void Character::set_stat(int stat, int amount)
 
 int Character::get_current_stat(int stat)
 {
-    return current_stats[stat];
+    return current_stat(stat);
 }
 
 void Character::set_current_stat(int stat, int amount)
 {
-    current_stats[stat] = amount;
+    current_stat(stat) = amount;
+}
+
+int& Character::current_stat(int stat)
+{
+    if(stat == HEALTH)
+    {
+        return CharacterStore::instance().hp[row()];
+    }
+    return current_stats[stat];
+}
+
+void Character::reset_current_stats()
+{
+    current_stats = stats;
+    CharacterStore::instance().hp[row()] = stats[HEALTH];
 }
 
 void Character::regain_consciousness()
@@ -603,7 +658,7 @@ void Character::gain_endurance(int factor)
 bool Character::in_sight_range(IntPoint _coords, IntPoint _chunk)
 {
     IntPoint point = utility::get_abs(_chunk, _coords);
-    IntPoint center = utility::get_abs(chunk, get_coords());
+    IntPoint center = utility::get_abs(get_chunk(), get_coords());
 
     //get the distance.  sign matters
     IntPoint distance = point - center;
@@ -615,7 +670,7 @@ bool Character::in_sight_range(IntPoint _coords, IntPoint _chunk)
 bool Character::in_sight(IntPoint _coords, IntPoint _chunk)
 {
     IntPoint point = utility::get_abs(_chunk, _coords);
-    IntPoint center = utility::get_abs(chunk, get_coords());
+    IntPoint center = utility::get_abs(get_chunk(), get_coords());
 
     //get the distance.  sign matters
     IntPoint distance = point - center;
@@ -646,6 +701,7 @@ bool Character::in_sight(IntPoint _coords, IntPoint _chunk)
 
 void Character::turn(IntPoint difference)
 {
+    int& direction = CharacterStore::instance().direction[row()];
     int new_perc = coords_to_perc(difference);
     int turn = new_perc - direction;
     int new_direction = direction + turn;
@@ -663,6 +719,7 @@ void Character::turn(IntPoint difference)
 
 void Character::turn(int turn_amount)
 {
+    int& direction = CharacterStore::instance().direction[row()];
     direction += turn_amount;
     if(direction > 100)
     {
@@ -677,22 +734,24 @@ void Character::turn(int turn_amount)
 std::vector<IntPoint> Character::sight_tiles()
 {
     IntPoint coords = get_coords();
-    std::vector<IntPoint> arc =  bresenham_arc(coords, sight, get_fov());
+    const sight_cone::Cone& cone = get_sight_cone();
     std::vector<IntPoint> points;
-    for(int i =0;i<arc.size();i++)
+    points.reserve(cone.size());
+    for(int i=0;i<cone.size();i++)
     {
-        std::vector<IntPoint> line_points;
-        line_points = bresenham_line(coords, arc[i]);
-        for(int j=0;j<line_points.size();j++)
-        {
-            points.push_back(line_points[j]);
-        }
+        points.push_back(IntPoint(coords.row + cone[i].row, coords.col + cone[i].col));
     }
     return points;
 }
 
+const sight_cone::Cone& Character::get_sight_cone()
+{
+    return sight_cone::get(sight, CharacterStore::instance().direction[row()], view);
+}
+
 IntPoint Character::get_fov()
 {
+    int direction = CharacterStore::instance().direction[row()];
     int upper = direction + (.5 * view);
     int lower = direction - (.5 * view);
     return IntPoint(upper, lower);
@@ -739,7 +798,7 @@ int Character::get_new_levels()
 void Character::level_stat(int stat)
 {
     stats[stat] += 1;
-    current_stats[stat] += 1;
+    current_stat(stat) += 1;
     level_up -= 1;
 }
 
@@ -769,31 +828,64 @@ std::string Character::get_name()
 
 Character* Character::get_master()
 {
-    return master;
+    return lookup(master);
 }
 
 void Character::set_master(Character* new_m)
 {
-    master = new_m;
+    Character* old = get_master();
+    if(old != NULL)
+    {
+        std::vector<CharacterHandle>& others = old->followers;
+        others.erase(std::remove(others.begin(), others.end(), handle), others.end());
+    }
+    master = new_m != NULL ? new_m->handle : CharacterHandle();
+    if(new_m != NULL)
+    {
+        new_m->followers.push_back(handle);
+    }
     update_master_health();
 }
 
 int Character::master_hp()
 {
-    return master->get_cur_hp();
+    return get_master()->get_cur_hp();
 }
 
 void Character::update_master_health()
 {
-    if(master != NULL)
+    Character* current = get_master();
+    if(current != NULL)
     {
-        master_health = master->get_cur_hp();
+        master_health = current->get_cur_hp();
     }
 }
 
 bool Character::master_health_changed()
 {
-    return master_health != master->get_cur_hp();
+    return master_health != get_master()->get_cur_hp();
+}
+
+void Character::interrupt(int reason)
+{
+    interrupts |= reason;
+}
+
+int Character::take_interrupts()
+{
+    if(!target.is_null() && lookup(target) == NULL)
+    {
+        target = CharacterHandle();
+        interrupts |= INTERRUPT_TARGET_GONE;
+    }
+    int reasons = interrupts;
+    interrupts = 0;
+    return reasons;
+}
+
+CharacterHandle Character::get_handle() const
+{
+    return handle;
 }
 
 Weapon* Character::get_weapon()
@@ -36,6 +36,25 @@
 #include "utility.h"
 #include "bresenham.h"
 #include "message.h"
+#include "sight_cone.h"
+#include "character_store.h"
+#include "object_pool.h"
+
+/**
+ * Things that can happen to a character between its turns that should
+ * make its behavior tree think again from the root, instead of carrying
+ * on with whatever it was doing.
+ */
+enum INTERRUPTS
+{
+    INTERRUPT_DAMAGED = 1,
+    INTERRUPT_TARGET_GONE = 2,
+    INTERRUPT_MASTER_HURT = 4,
+    INTERRUPT_BUFFER_MOVED = 8,
+    //A move the character decided on turned out to be taken by someone
+    //else by the time it was carried out.
+    INTERRUPT_BLOCKED = 16
+};
 
 /**
  * A class which is used to construct all characters in game.
@@ -47,15 +66,6 @@
 class Character
 {
     protected:
-        /**
-         * A protected spectrum ranging from 0-5.
-         * Morality acts as the basis for whether or not characters
-         * will attack each other, i.e. characters with 0 will attack
-         * characters with 5.
-         * \todo Make this an enum.
-         */
-        int moral;
-
         /**
          * A vector representation of the stats of a character.
          * All of the stats of a character (health, armor, strength, etc.
@@ -67,20 +77,12 @@ class Character
          * A vector representing the current stats of a character.
          * Whenever one of the player's stats temporarily changes,
          * as in a lowering or raising of health, or lowering or raising
-         * of another stat, it will be held in this vector.
+         * of another stat, it will be held in this vector.  Health is the
+         * exception: it's in the CharacterStore with the position.
+         * @see current_stat
          */
         std::vector<int> current_stats;
 
-        /**
-         * The character's coordinate in the x direction.
-         */
-        int x;
-
-        /**
-         * The character's coordinates in the y direction.
-         */
-        int y;
-
         /**
          * A vector representing the character's current inventory.
          */
@@ -119,23 +121,13 @@ class Character
          */
         Item* corpse;
 
-        /**
-         * The depth the character is in the chunk.
-         */
-        int depth;
-
-        /**
-         * An IntPoint object of the character's coordinates in the chunk_map.
-         */
-        IntPoint chunk;
-
         /**
          * What the character is currently focused on.
          * For the main character, this will primarily be to display information about
          * the enemy or NPC that they are focused on.  For non-players characters (both
          * enemies and NPCs, this will act as a continuous representation of their focus.
          */
-        Character* target;
+        CharacterHandle target;
 
         /**
          * The "master" of the character, which corresponds to a character who is in control
@@ -143,7 +135,7 @@ class Character
          * relationship is two ways, and it would also allow for controlling of the different
          * characters.
          */
-        Character* master;
+        CharacterHandle master;
 
         /**
          * The last known health of the "master."
@@ -151,33 +143,53 @@ class Character
         int master_health;
 
         /**
-         * Whether or not the character is conscious.
+         * The characters whose master this is, so that they can be told
+         * when it gets hurt.  Ones that have been deleted get dropped the
+         * next time they're looked at.
          */
-        bool conscious;
+        std::vector<CharacterHandle> followers;
 
         /**
-         * The current timer of the character.
+         * This character's handle, which it gets when it's made and keeps
+         * until it's deleted.  Copies get their own.  The position, chunk,
+         * depth, timer, speed, health, morality and direction are kept in
+         * its row of the CharacterStore instead of here.
          */
-        long timer;
+        CharacterHandle handle;
 
         /**
-         * How quickly the character moves.
-         * Represents the threshold for how many milliseconds must pass before
-         * the character can act.
-         * @see timer
+         * The character's row in the CharacterStore.
          */
-        int speed;
+        int row() const
+        {
+            return CharacterStore::instance().row(handle);
+        }
 
         /**
-         * Member variable to hold how far the enemy can see.
+         * A current stat, wherever it's kept.
          */
-        int sight;
+        int& current_stat(int stat);
 
         /**
-         * Member variable to hold where the enemy is looking.
-         * This is 0-100, where 0 (and 100) are directly right.
+         * Sets every current stat back to its maximum.
          */
-        int direction;
+        void reset_current_stats();
+
+        /**
+         * The INTERRUPTS that have happened since the character's behavior
+         * tree last looked.
+         */
+        int interrupts;
+
+        /**
+         * Whether or not the character is conscious.
+         */
+        bool conscious;
+
+        /**
+         * Member variable to hold how far the enemy can see.
+         */
+        int sight;
 
         /**
          * Member variable to hold the enemies field of view.
@@ -216,6 +228,14 @@ class Character
         void gain_level();
 
     public:
+        /**
+         * Characters, and enemies, come out of an ObjectPool, so that
+         * spawning and killing them doesn't go to the system allocator
+         * once the pool is big enough.
+         */
+        static void* operator new(size_t size);
+        static void operator delete(void* memory);
+
         /**
          * The default constructor.
          */
@@ -271,6 +291,12 @@ class Character
          */
         bool act(long ms);
 
+        /**
+         * How many more milliseconds have to go by before act() returns
+         * true.
+         */
+        long time_to_act() const;
+
         /**
          * A check to see whether or not the character is alive.
          * @returns True if the character's current health is > 0, otherwise false.
@@ -329,11 +355,19 @@ class Character
         int get_sight();
 
         /**
-         * Gets all the coordinates that the enemy can currently see.
+         * Gets all the coordinates that the enemy could see if nothing was
+         * in the way.  Each one shows up once.
          * @return A list of coords the enemy can see.
          */
         std::vector<IntPoint> sight_tiles();
 
+        /**
+         * Gets the precomputed table of cells (relative to the character)
+         * that the character could see, for its current sight, direction
+         * and view.  Use sight_cone::trace() to walk it with walls in the way.
+         */
+        const sight_cone::Cone& get_sight_cone();
+
         /**
          * Add an item to the character's inventory.
          * @param new_item The item to place in the character's inventory.
@@ -462,7 +496,7 @@ class Character
 
         /**
          * Public accessor for the target.
-         * @return Member variable target.
+         * @return Member variable target, or NULL if it has been deleted.
          * @see target
          */
         Character* get_target();
@@ -477,16 +511,18 @@ class Character
 
         /**
          * Public accessor for the current health.
-         * Current health corresponds to current_stats[HEALTH].
-         * @return Member variable current_stats[HEALTH].
-         * @see current_stats
+         * Current health is kept in the CharacterStore.
+         * @return The character's current health.
+         * @see current_stat
          */
         int get_cur_hp();
 
         /**
-         * Public accessor for the moral member variable.
-         * @return Member variable moral.
-         * @see moral
+         * Morality ranges from 0-5, and acts as the basis for whether or
+         * not characters will attack each other, i.e. characters with 0
+         * will attack characters with 5.
+         * \todo Make this an enum.
+         * @return The character's morality.
          */
         int get_moral();
 
@@ -711,7 +747,7 @@ class Character
 
 
         /**
-         * Accessor for the "master."
+         * Accessor for the "master," or NULL if it has been deleted.
          */
         Character* get_master();
 
@@ -736,6 +772,30 @@ class Character
          */
         bool master_health_changed();
 
+        /**
+         * Tells the character's behavior tree that something has happened.
+         * @param reason One of INTERRUPTS.
+         */
+        void interrupt(int reason);
+
+        /**
+         * Gets the INTERRUPTS that have happened since the last call, and
+         * clears them.  A target that has been deleted since counts as
+         * INTERRUPT_TARGET_GONE.
+         */
+        int take_interrupts();
+
+        CharacterHandle get_handle() const;
+
+        /**
+         * Finds a character by its handle.
+         * @return The character, or NULL if it has been deleted.
+         */
+        static Character* lookup(CharacterHandle _handle)
+        {
+            return CharacterStore::instance().lookup(_handle);
+        }
+
         /**
          * Kills the character.
          */
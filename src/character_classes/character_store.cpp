@@ -0,0 +1,86 @@
+/**
+ *  CHARACTER_STORE.CPP
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "character_store.h"
+
+CharacterStore::CharacterStore()
+{
+}
+
+CharacterStore& CharacterStore::instance()
+{
+    //Never deleted, so that characters destroyed at exit still have it.
+    static CharacterStore* store = new CharacterStore;
+    return *store;
+}
+
+CharacterHandle CharacterStore::add(Character* chara)
+{
+    CharacterHandle handle = slots.insert(chara);
+    x.push_back(0);
+    y.push_back(0);
+    chunk_row.push_back(0);
+    chunk_col.push_back(0);
+    depth.push_back(0);
+    timer.push_back(0);
+    speed.push_back(0);
+    hp.push_back(0);
+    moral.push_back(0);
+    direction.push_back(0);
+    owner.push_back(NULL);
+    return handle;
+}
+
+void CharacterStore::remove(CharacterHandle handle)
+{
+    int place = slots.place(handle);
+    if(place < 0)
+    {
+        return;
+    }
+    slots.erase(handle);
+    int last = x.size() - 1;
+    copy_row(last, place);
+    owner[place] = owner[last];
+    x.pop_back();
+    y.pop_back();
+    chunk_row.pop_back();
+    chunk_col.pop_back();
+    depth.pop_back();
+    timer.pop_back();
+    speed.pop_back();
+    hp.pop_back();
+    moral.pop_back();
+    direction.pop_back();
+    owner.pop_back();
+}
+
+void CharacterStore::copy_row(int from, int to)
+{
+    x[to] = x[from];
+    y[to] = y[from];
+    chunk_row[to] = chunk_row[from];
+    chunk_col[to] = chunk_col[from];
+    depth[to] = depth[from];
+    timer[to] = timer[from];
+    speed[to] = speed[from];
+    hp[to] = hp[from];
+    moral[to] = moral[from];
+    direction[to] = direction[from];
+}
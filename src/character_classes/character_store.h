@@ -0,0 +1,129 @@
+/**
+ *  CHARACTER_STORE.H
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CHARACTER_STORE_H
+#define CHARACTER_STORE_H
+
+#include <vector>
+#include "slot_map.h"
+
+class Character;
+class Game;
+
+/**
+ * Refers to a character without pointing at it, so that it can be
+ * deleted without anyone who refers to it having to be told.
+ * @see Character::lookup
+ */
+typedef SlotHandle CharacterHandle;
+
+/**
+ * Every character that exists, with the fields that get looked at for
+ * every character every turn kept in their own packed arrays instead of
+ * in the characters.  Row i of every array belongs to the same character,
+ * so a loop over all of the characters' positions only reads positions.
+ * Removing a character moves the last row into its place, the same way
+ * the SlotMap that hands out the handles does.
+ *
+ * It's only changed by making and deleting characters, which doesn't
+ * happen while AI turns are being decided, so reading it from those
+ * threads is safe.
+ */
+class CharacterStore
+{
+    public:
+        static CharacterStore& instance();
+
+        /**
+         * Gives a character a row, with everything in it zeroed.
+         */
+        CharacterHandle add(Character* chara);
+
+        void remove(CharacterHandle handle);
+
+        /**
+         * Copies one row over another, for copying characters.  The owner
+         * isn't copied, since a copy isn't in anyone's list yet.
+         */
+        void copy_row(int from, int to);
+
+        Character* lookup(CharacterHandle handle) const
+        {
+            Character* const* found = slots.get(handle);
+            return found != NULL ? *found : NULL;
+        }
+
+        /**
+         * The row of a character, or -1 if it's been deleted.  It changes
+         * when other characters are deleted.
+         */
+        int row(CharacterHandle handle) const
+        {
+            return slots.place(handle);
+        }
+
+        CharacterHandle handle_at(int row) const
+        {
+            return slots.handle_at(row);
+        }
+
+        int size() const
+        {
+            return slots.size();
+        }
+
+        /**
+         * The character in each row.
+         */
+        std::vector<Character*>& get_characters()
+        {
+            return slots.get_values();
+        }
+
+        std::vector<int> x;
+        std::vector<int> y;
+        std::vector<int> chunk_row;
+        std::vector<int> chunk_col;
+        std::vector<int> depth;
+        std::vector<long> timer;
+        std::vector<int> speed;
+
+        /**
+         * Current health.  The other current stats are looked at much less
+         * often, and stay in the character.
+         */
+        std::vector<int> hp;
+        std::vector<int> moral;
+        std::vector<int> direction;
+
+        /**
+         * The game whose character list each character is in, or NULL.
+         * @see Game::list_character
+         */
+        std::vector<const Game*> owner;
+
+    private:
+        CharacterStore();
+        CharacterStore(const CharacterStore&);
+        CharacterStore& operator=(const CharacterStore&);
+
+        SlotMap<Character*> slots;
+};
+
+#endif
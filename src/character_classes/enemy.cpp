@@ -28,21 +28,23 @@ Enemy::Enemy()
 
 Enemy::Enemy(int _x, int _y, int _depth, EnemyType enemy) : Character(_x, _y, _depth)
 {
-    timer = 0;
+    CharacterStore& store = CharacterStore::instance();
+    int place = row();
+    store.timer[place] = 0;
     //determines if the character is good or evit, on a scale of 1-5 (5 is evil, 3 is passive)
-    moral = enemy.moral;
+    store.moral[place] = enemy.moral;
     stats = enemy.stats;
-    current_stats = stats;
+    reset_current_stats();
     id = enemy.id;
     ai_id = enemy.ai_id;
     name = enemy.name;
     sight = enemy.sight;
     view = enemy.view;
-    direction = 0;
-    speed = enemy.speed;
+    store.direction[place] = 0;
+    store.speed[place] = enemy.speed;
     sprite = enemy.sprite;
-    corpse = new Misc(IntPoint(x, y), enemy.corpse);
-    natural_weapon = Weapon(IntPoint(y, x), enemy.natural_weapon);
+    corpse = new Misc(IntPoint(_x, _y), enemy.corpse);
+    natural_weapon = Weapon(IntPoint(_y, _x), enemy.natural_weapon);
 
     //generate the enemy's list of equipment and weapons
     vector<Equipment*> equip_list = generate_equipment(enemy.eq);
@@ -84,7 +86,7 @@ std::vector<Equipment*> Enemy::generate_equipment(std::vector<EquipType> equipme
     {
         if(rand() % (5 + equipment_list[i].rarity) == 0)
         {
-           new_equipment.push_back(new Equipment(IntPoint(y, x), equipment_list[i]));
+           new_equipment.push_back(new Equipment(get_coords(), equipment_list[i]));
         }
     }
     return new_equipment;
@@ -96,7 +98,7 @@ Weapon* Enemy::generate_weapon(std::vector<WeaponType> weapon_list)
     {
         if(rand() % (5 + weapon_list[i].rarity) == 0)
         {
-            return new Weapon(IntPoint(y, x), weapon_list[i]);
+            return new Weapon(get_coords(), weapon_list[i]);
         }
     }
     return NULL;
@@ -0,0 +1,272 @@
+/**
+ *  BEHAVIOR_LOAD.CPP
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <boost/filesystem.hpp>
+#include <stdexcept>
+#include <set>
+
+#include "behavior_load.h"
+#include "string.h"
+#include "ini.h"
+#include "conf_util.h"
+
+
+namespace fs=boost::filesystem;
+
+namespace behavior_load {
+
+    namespace {
+        typedef BNode* (*LeafFactory)();
+
+        template<typename Leaf>
+        BNode* make_leaf()
+        {
+            return new Leaf;
+        }
+
+        /**
+         * Every leaf that behavior.ini can use, by the name of its class.
+         */
+        const std::map<std::string, LeafFactory>& leaves()
+        {
+            static const std::map<std::string, LeafFactory> leafdefs = {
+                {"MoveTowards", make_leaf<MoveTowards>},
+                {"MoveTowardsM", make_leaf<MoveTowardsM>},
+                {"MoveAway", make_leaf<MoveAway>},
+                {"Attack", make_leaf<Attack>},
+                {"Wander", make_leaf<Wander>},
+                {"FreakOut", make_leaf<FreakOut>},
+                {"Die", make_leaf<Die>},
+                {"TurnToward", make_leaf<TurnToward>},
+                {"TurnTowardM", make_leaf<TurnTowardM>},
+                {"TurnAway", make_leaf<TurnAway>},
+                {"LowHealth", make_leaf<LowHealth>},
+                {"EnemyInRange", make_leaf<EnemyInRange>},
+                {"GetMTarget", make_leaf<GetMTarget>},
+                {"NextTo", make_leaf<NextTo>},
+                {"NextToM", make_leaf<NextToM>},
+                {"HasHealth", make_leaf<HasHealth>},
+                {"MHealthChange", make_leaf<MHealthChange>},
+                {"InWorld", make_leaf<InWorld>},
+                {"ValidTarget", make_leaf<ValidTarget>},
+            };
+            return leafdefs;
+        }
+
+        std::string trim(const std::string& s)
+        {
+            size_t start = s.find_first_not_of(" \t");
+            if(start == std::string::npos)
+            {
+                return "";
+            }
+            size_t end = s.find_last_not_of(" \t");
+            return s.substr(start, end - start + 1);
+        }
+
+        /**
+         * Looks for a way back to name from the sections under it.  The
+         * same section turning up twice in different branches is fine.
+         * @param state 0 for sections not looked at yet, 1 for sections
+         * that are under the one being looked at, and 2 for ones that are
+         * finished.
+         */
+        bool has_cycle(const nodedefs_t& nodedefs, const std::string& name,
+                std::map<std::string, int>& state)
+        {
+            auto found = nodedefs.find(name);
+            if(found == nodedefs.end() || state[name] == 2)
+            {
+                return false;
+            }
+            if(state[name] == 1)
+            {
+                return true;
+            }
+            state[name] = 1;
+            for(const std::string& child : found->second.children)
+            {
+                if(has_cycle(nodedefs, child, state))
+                {
+                    return true;
+                }
+            }
+            state[name] = 2;
+            return false;
+        }
+    }
+
+    NodeDef::NodeDef()
+    {
+        ai_id = -1;
+    }
+
+    static int handle_ini_entry(void* nodedefs, const char* section, const char* name, const char* value) {
+        #define MATCH(s, n) strcmp(s, n)==0
+
+        NodeDef& def = (*(nodedefs_t*) nodedefs)[section];
+
+        if(MATCH(name, "type")) {
+            if(!def.type.empty()) {
+                std::cout<<"ERROR: ["<<section<<"] has more than one type."<<std::endl;
+                return 0;
+            }
+            def.type = value;
+        } else if(MATCH(name, "children")) {
+            //Lines that carry on a list come through as more values for
+            //the same key, so they just get added to the end.
+            std::stringstream list(value);
+            std::string child;
+            while(std::getline(list, child, ',')) {
+                child = trim(child);
+                if(!child.empty()) {
+                    def.children.push_back(child);
+                }
+            }
+        } else if(MATCH(name, "ai_id")) {
+            try {
+                def.ai_id = stoi(value);
+            } catch (const std::exception& e) {
+                std::cout<<"ERROR: ["<<section<<"] has an ai_id of "<<value<<", which isn't a number."<<std::endl;
+                return 0;
+            }
+        } else {
+            std::cout<<"Could not load configuration: name="<<name<<"; value="<<value<<"."<<std::endl;
+            return 0;
+        }
+
+        return 1;
+    }
+
+    std::vector<std::string> validate(const nodedefs_t& nodedefs) {
+        std::vector<std::string> errors;
+        std::map<int, std::string> roots;
+
+        for(auto& entry : nodedefs) {
+            const std::string& name = entry.first;
+            const NodeDef& def = entry.second;
+            std::string where = "[" + name + "] ";
+
+            if(leaves().count(name) > 0) {
+                errors.push_back(where + "has the same name as a leaf.");
+            }
+
+            if(def.type == "inverter") {
+                if(def.children.size() != 1) {
+                    errors.push_back(where + "is an inverter, so it needs exactly one child.");
+                }
+            } else if(def.type == "branch") {
+                if(def.children.size() != 3) {
+                    errors.push_back(where + "is a branch, so it needs exactly three children.");
+                }
+            } else if(def.type == "priority" || def.type == "sequence") {
+                if(def.children.empty()) {
+                    errors.push_back(where + "has no children.");
+                }
+            } else if(def.type.empty()) {
+                errors.push_back(where + "has no type.");
+            } else {
+                errors.push_back(where + "has an unknown type, " + def.type + ".");
+            }
+
+            for(const std::string& child : def.children) {
+                if(nodedefs.count(child) == 0 && leaves().count(child) == 0) {
+                    errors.push_back(where + "has a child called " + child +
+                            ", which isn't a section or a leaf.");
+                }
+            }
+
+            if(def.ai_id >= 0) {
+                if(roots.count(def.ai_id) > 0) {
+                    errors.push_back(where + "has the same ai_id as [" +
+                            roots[def.ai_id] + "].");
+                } else {
+                    roots[def.ai_id] = name;
+                }
+            }
+        }
+
+        std::map<std::string, int> state;
+        for(auto& entry : nodedefs) {
+            if(state[entry.first] == 0 && has_cycle(nodedefs, entry.first, state)) {
+                errors.push_back("[" + entry.first + "] ends up containing itself.");
+                break;
+            }
+        }
+
+        return errors;
+    }
+
+    nodedefs_t load_conf() {
+        nodedefs_t nodedefs;
+
+        if (conf_util::conf_exists(BEHAVIORINI)) {
+            fs::path behaviorconf(BEHAVIORINI);
+
+            int result = ini_parse(behaviorconf.string().c_str(), handle_ini_entry, &nodedefs);
+            if (result < 0) {
+                printf("Can't load behavior.ini\n");
+                exit(EXIT_FAILURE);
+            } else if (result > 0) {
+                std::cout<<"ERROR: Problem on line "<<result<<" of behavior.ini. Exiting."<<std::endl;
+                exit(EXIT_FAILURE);
+            }
+        } else {
+            exit(EXIT_FAILURE);
+        }
+
+        std::vector<std::string> errors = validate(nodedefs);
+        if(!errors.empty()) {
+            for(const std::string& error : errors) {
+                std::cout<<"ERROR: behavior.ini: "<<error<<std::endl;
+            }
+            exit(EXIT_FAILURE);
+        }
+
+        return nodedefs;
+    }
+
+    BNode* build(const nodedefs_t& nodedefs, const std::string& name) {
+        BNode* node;
+        auto leaf = leaves().find(name);
+        if(leaf != leaves().end()) {
+            node = leaf->second();
+        } else {
+            const NodeDef& def = nodedefs.at(name);
+            std::vector<BNode*> children;
+            for(const std::string& child : def.children) {
+                children.push_back(build(nodedefs, child));
+            }
+
+            if(def.type == "inverter") {
+                node = new InverterNode(children[0]);
+            } else if(def.type == "branch") {
+                node = new BranchingCondition(children[0], children[1], children[2]);
+            } else if(def.type == "sequence") {
+                node = new SequenceNode(children);
+            } else {
+                node = new PriorityNode(children);
+            }
+        }
+        node->set_name(name);
+        return node;
+    }
+
+}
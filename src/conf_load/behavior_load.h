@@ -0,0 +1,92 @@
+/**
+ *  BEHAVIOR_LOAD.H
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BEHAVIOR_LOAD_H
+#define BEHAVIOR_LOAD_H
+
+#include <string>
+#include <vector>
+#include <map>
+
+#include "behavior_node.h"
+
+namespace behavior_load {
+
+    /**
+     * One section of behavior.ini, as it was written.
+     */
+    struct NodeDef
+    {
+        NodeDef();
+
+        /**
+         * priority, sequence, branch or inverter.
+         */
+        std::string type;
+
+        /**
+         * The names of other sections and leaves, in order.
+         */
+        std::vector<std::string> children;
+
+        /**
+         * The AI id of the tree that this is the root of, or -1 if it's
+         * only used inside other trees.
+         */
+        int ai_id;
+    };
+
+    typedef std::map<std::string, NodeDef> nodedefs_t;
+
+    /**
+     * A callback function for the behavior.ini file parser.
+     * @param nodedefs A pointer to the nodedefs_t being filled in
+     * @param section The name of the [section] in the .ini that is being parsed
+     * @param name The key that is currently being parsed
+     * @param value The value of the key that is being parsed
+     * @return 1 for success, 0 for failure.
+     */
+    static int handle_ini_entry(void* nodedefs, const char* section,
+                                const char* name, const char* value);
+
+    /**
+     * Everything wrong with a set of definitions: types that don't exist,
+     * the wrong number of children, children that aren't sections or
+     * leaves, sections that contain themselves, and AI ids used twice.
+     * @return One message per problem, or nothing if they're fine.
+     */
+    std::vector<std::string> validate(const nodedefs_t& nodedefs);
+
+    /**
+     * Load the behavior.ini file using the inih library, and check it
+     * with validate().  Any problems are printed and the game exits.
+     * @return the sections of the file by name.
+     */
+    nodedefs_t load_conf();
+
+    /**
+     * Makes the nodes for a section or leaf.  Sections used in more than
+     * one place get built once for each place.
+     * @param nodedefs Definitions that validate() found nothing wrong with.
+     */
+    BNode* build(const nodedefs_t& nodedefs, const std::string& name);
+
+}
+
+#endif
@@ -60,12 +60,8 @@ namespace tile_load {
             (*tilemap)[section].color=color_code;
         } else if (MATCH(name, "can_be_moved_through")) {
             (*tilemap)[section].can_be_moved_through=stoi(value);
-        } else if (MATCH(name, "visible")) {
-            (*tilemap)[section].visible=stoi(value);
         } else if (MATCH(name, "opaque")) {
             (*tilemap)[section].opaque=stoi(value);
-        } else if (MATCH(name, "seen")) {
-            (*tilemap)[section].seen=stoi(value);
         } else if (MATCH(name, "can_build_overtop")) {
             (*tilemap)[section].can_build_overtop=stoi(value);
         } else {
@@ -82,9 +78,7 @@ namespace tile_load {
         cout<<"Tile ID: "<<theTile.tile_id<<endl;
         cout<<"Color: "<<theTile.color<<endl;
         cout<<"Corporeal: "<<theTile.can_be_moved_through<<endl;
-        cout<<"Visible: "<<theTile.visible<<endl;
         cout<<"Opaque: "<<theTile.opaque<<endl;
-        cout<<"Seen: "<<theTile.seen<<endl;
         cout<<"Can build overtop: "<<theTile.can_build_overtop<<endl;
     }
 
@@ -26,6 +26,10 @@ std::vector<Animation>& Game::get_animations()
 
 void Game::tick_animations(long delta_ms)
 {
+    if(anim_queue.size() > 0)
+    {
+        bump_generation();
+    }
     for(int i=0;i<anim_queue.size();i++)
     {
         anim_queue[i].step(delta_ms);
@@ -40,4 +44,5 @@ void Game::tick_animations(long delta_ms)
 void Game::create_explosion(int x, int y, int chunk_x, int chunk_y)
 {
     anim_queue.push_back(construct_explosion(x, y, chunk_x, chunk_y, 5, YELLOW));
+    bump_generation();
 }
@@ -20,16 +20,42 @@
 #include "game.h"
 
 /*
- * PRE: Takes an x and a y coordinate (chunk).
+ * PRE: Takes a row and a column (absolute chunk coordinates).
  * POST: Returns whether or not the chunk is currently in the buffer.
  */
- //umm...this operates on two different coordinate systems, fyi.  It will
- //almost never work -MJY 2/2/15
 bool Game::chunk_in_buffer(int row, int col) {
-    IntPoint center = chunk_map.get_center();
-    int offset = (chunk_map.get_diameter() - 1)/2;
-    IntPoint buffer_chunk = IntPoint(center.row - row + offset, center.col - col + offset);
-    return !chunk_map.out_of_bounds(buffer_chunk);
+    IntPoint center = main_char.get_chunk();
+    return abs(row - center.row) <= buffer_radius && abs(col - center.col) <= buffer_radius;
+}
+
+int Game::required_buffer_radius() {
+    //The canvas reaches half of the zoomed view out from the main
+    //character, who could be anywhere in the center chunk.
+    int half_height = (view_height * zoom + 1) / 2;
+    int half_width = (view_width * zoom + 1) / 2;
+    int radius_rows = (half_height + CHUNK_HEIGHT - 1) / CHUNK_HEIGHT;
+    int radius_cols = (half_width + CHUNK_WIDTH - 1) / CHUNK_WIDTH;
+    return std::max(1, std::max(radius_rows, radius_cols));
+}
+
+void Game::resize_buffer() {
+    //The buffer only ever grows.  Chunks aren't saved yet, so shrinking it
+    //would throw away the chunks around the edges, and zooming back out
+    //would make brand new ones.
+    buffer_radius = std::max(buffer_radius, required_buffer_radius());
+    int diameter = buffer_radius * 2 + 1;
+    if(chunk_map.get_diameter() == diameter)
+    {
+        return;
+    }
+
+    chunk_map.resize(diameter, world_map.get_map());
+    buffer = TilePointerMatrix(CHUNK_HEIGHT * diameter, vector<Tile*>(CHUNK_WIDTH * diameter));
+    buffer_opaque.resize(CHUNK_HEIGHT * diameter, CHUNK_WIDTH * diameter);
+    buffer_passable.resize(CHUNK_HEIGHT * diameter, CHUNK_WIDTH * diameter);
+    character_index = std::vector<std::vector<CharacterHandle> >(CHUNK_HEIGHT * diameter, std::vector<CharacterHandle>(CHUNK_WIDTH * diameter));
+    clear_character_index();
+    update_buffer(main_char.get_chunk());
 }
 
 
@@ -39,6 +65,16 @@ bool Game::coords_in_buffer(int row, int col)
     return is_in;
 }
 
+int Game::buffer_plane_index(int row, int col)
+{
+    if(!coords_in_buffer(row, col))
+    {
+        return -1;
+    }
+    int index = (row / CHUNK_HEIGHT) * (buffer_radius * 2 + 1) + col / CHUNK_WIDTH;
+    return index < buffer_explored.size() ? index : -1;
+}
+
 bool Game::point_in_buffer(IntPoint chunk, IntPoint coords)
 {
     IntPoint buffer_coords = get_buffer_coords(chunk, coords);
@@ -47,17 +83,42 @@ bool Game::point_in_buffer(IntPoint chunk, IntPoint coords)
 
 
 IntPoint Game::get_buffer_coords(IntPoint chunk, IntPoint coords) {
-    IntPoint tl_buffer = utility::get_abs(IntPoint(main_char.get_chunk().row-1, main_char.get_chunk().col-1), IntPoint(0, 0));
+    IntPoint tl_buffer = utility::get_abs(IntPoint(main_char.get_chunk().row - buffer_radius,
+                main_char.get_chunk().col - buffer_radius), IntPoint(0, 0));
     IntPoint abs = utility::get_abs(chunk, coords);
     return IntPoint(abs.row - tl_buffer.row, abs.col - tl_buffer.col);
 }
 
+void Game::set_buffer_tile(int row, int col, Tile* tile)
+{
+    buffer[row][col] = tile;
+    buffer_opaque.assign(row, col, tile->opaque);
+    if(buffer_passable.test(row, col) != tile->can_be_moved_through)
+    {
+        buffer_passable.assign(row, col, tile->can_be_moved_through);
+        passable_version++;
+    }
+}
+
 void Game::add_tile_to_buffer(IntPoint chunk, IntPoint coords, Tile* tile)
 {
     IntPoint buffer_coords = get_buffer_coords(chunk, coords);
     if(coords_in_buffer(buffer_coords.row, buffer_coords.col))
     {
-        buffer[buffer_coords.row][buffer_coords.col] = tile;
+        bool was_opaque = buffer_opaque.test(buffer_coords.row, buffer_coords.col);
+        set_buffer_tile(buffer_coords.row, buffer_coords.col, tile);
+
+        //The field of view only has to be worked out again if light
+        //goes through this spot differently now, and it's close enough
+        //to the main character to matter.
+        IntPoint origin = get_buffer_coords(fov_chunk, fov_coords);
+        int row = buffer_coords.row - origin.row;
+        int col = buffer_coords.col - origin.col;
+        if(player_fov.in_range(row, col) && was_opaque != tile->opaque)
+        {
+            invalidate_visibility();
+        }
+        bump_generation();
     }
 }
 
@@ -72,14 +133,22 @@ void Game::update_buffer(IntPoint central_chunk) {
     int x, y;
     Chunk* current_chunk;
     Tile* buffer_tile;
+    int depth = main_char.get_depth();
+    int diameter = buffer_radius * 2 + 1;
+    buffer_explored.assign(diameter * diameter, NULL);
+    buffer_visible.assign(diameter * diameter, NULL);
 
-    for(int row=central_chunk.row - 1;row<=central_chunk.row+1;row++) {
+    for(int row=central_chunk.row - buffer_radius;row<=central_chunk.row + buffer_radius;row++) {
 
-        for(int col=central_chunk.col-1;col<=central_chunk.col+1;col++) {
-            x = col - (central_chunk.col - 1);
-            y = row - (central_chunk.row - 1);
+        for(int col=central_chunk.col - buffer_radius;col<=central_chunk.col + buffer_radius;col++) {
+            x = col - (central_chunk.col - buffer_radius);
+            y = row - (central_chunk.row - buffer_radius);
             //cout<<"Central chunk: "<<central_chunk.row<<" "<<central_chunk.col<<endl;
             current_chunk = chunk_map.get_chunk_abs(row, col);
+            if(depth < current_chunk->get_depth()) {
+                buffer_explored[y * diameter + x] = current_chunk->get_explored(depth);
+                buffer_visible[y * diameter + x] = current_chunk->get_visible(depth);
+            }
 
             for (int a=0; a<CHUNK_HEIGHT; a++) {
                 for (int b=0; b<CHUNK_WIDTH; b++) {
@@ -89,7 +158,8 @@ void Game::update_buffer(IntPoint central_chunk) {
                      *  the buffer.  A and B represent the Y and X of
                      *  individual tiles.  So, for each chunk, the X and Y are
                      *  written to the buffer.  The chunks that we're iterating
-                     *  through are essentially a 3x3 array.  Each chunk needs
+                     *  through are essentially a 3x3 array (or bigger, if
+                     *  the buffer_radius is more than 1).  Each chunk needs
                      *  to start being written at the appropriate location
                      *  (e.g. the second chunk needs to start where the first
                      *  one left off...), which is where the x and y variables
@@ -111,14 +181,27 @@ void Game::update_buffer(IntPoint central_chunk) {
                     } else {
                         buffer_tile = &buffer_tile_placeholder;
                     }
-                    buffer[buffer_row][buffer_col] = buffer_tile;
+                    set_buffer_tile(buffer_row, buffer_col, buffer_tile);
                 }
             }
         }
     }
     show_chunk_objects();
     update_character_index();
+    populate_buffer();
+    flow_fields.clear();
+    path_plans.clear();
+    path_tickets.clear();
+    //Anyone in the middle of a long action has to check that they're
+    //still in the world.
+    for(int i=0;i<character_list.size();i++)
+    {
+        character_list[i]->interrupt(INTERRUPT_BUFFER_MOVED);
+    }
+    summarize_chunks();
+    invalidate_visibility();
     refresh();
+    bump_generation();
 }
 
 /**
@@ -135,8 +218,8 @@ void Game::show_chunk_objects() {
     std::vector<Building>* buildings;
     Chunk* chunk;
     IntPoint chunk_coords;
-    for(int i=main_char.get_chunk().row-1;i<=main_char.get_chunk().row+1;i++) {
-        for(int j=main_char.get_chunk().col-1;j<=main_char.get_chunk().col+1;j++) {
+    for(int i=main_char.get_chunk().row - buffer_radius;i<=main_char.get_chunk().row + buffer_radius;i++) {
+        for(int j=main_char.get_chunk().col - buffer_radius;j<=main_char.get_chunk().col + buffer_radius;j++) {
 
            chunk = chunk_map.get_chunk_abs(IntPoint(i, j));
             IntPoint chunk_coords = IntPoint(i, j);
@@ -21,9 +21,9 @@
 
 void Game::point_assertions(int row, int col) {
     assert(row >= 0);
-    assert(row < SCREEN_HEIGHT);
+    assert(row < view_height);
     assert(col >= 0);
-    assert(col < SCREEN_WIDTH);
+    assert(col < view_width);
 }
 
 void Game::set_tile(int row, int col, Tile* tile) {
@@ -51,8 +51,8 @@ bool Game::out_of_bounds(IntPoint point) {
 }
 
 bool Game::out_of_bounds(int row, int col) {
-    return (col < 0 || col >= GAME_WIDTH ||
-            row < 0 || row >= GAME_HEIGHT);
+    return (col < 0 || col >= view_width ||
+            row < 0 || row >= view_height);
 }
 
 const std::vector<std::vector<Tile*> >& Game::get_canvas() {
@@ -62,14 +62,20 @@ const std::vector<std::vector<Tile*> >& Game::get_canvas() {
 
 std::vector<Character*> Game::get_vis_characters() {
     std::vector<Character*> temp = std::vector<Character*>();
-    for(int i=0;i<character_list.size();i++) {
-        IntPoint chunk = IntPoint(character_list[i]->get_chunk_y(), character_list[i]->get_chunk_x());
-        IntPoint coords = IntPoint(character_list[i]->get_y(), character_list[i]->get_x());
-        IntPoint main_char_coords = IntPoint(main_char.get_y(), main_char.get_x());
-        IntPoint radius  = IntPoint(GAME_HEIGHT/2, GAME_WIDTH/2);
-        if(utility::in_range(chunk, coords, main_char.get_chunk(), main_char_coords, radius) &&
-                character_list[i]->get_depth() == main_char.get_depth()) {
-            temp.push_back(character_list[i]);
+    CharacterStore& store = CharacterStore::instance();
+    std::vector<Character*>& characters = store.get_characters();
+    IntPoint main_char_chunk = main_char.get_chunk();
+    IntPoint main_char_coords = IntPoint(main_char.get_y(), main_char.get_x());
+    int main_char_depth = main_char.get_depth();
+    IntPoint radius  = IntPoint((view_height * zoom)/2, (view_width * zoom)/2);
+    for(int i=0;i<store.size();i++) {
+        if(store.owner[i] != this || store.depth[i] != main_char_depth) {
+            continue;
+        }
+        IntPoint chunk = IntPoint(store.chunk_row[i], store.chunk_col[i]);
+        IntPoint coords = IntPoint(store.y[i], store.x[i]);
+        if(utility::in_range(chunk, coords, main_char_chunk, main_char_coords, radius)) {
+            temp.push_back(characters[i]);
         }
     }
     return temp;
@@ -78,14 +84,54 @@ std::vector<Character*> Game::get_vis_characters() {
 
 bool Game::is_vis(IntPoint coords)
 {
-    bool y = coords.row < GAME_HEIGHT && coords.row >= 0;
-    bool x = coords.col < GAME_WIDTH && coords.col >=0;
+    bool y = coords.row < view_height && coords.row >= 0;
+    bool x = coords.col < view_width && coords.col >=0;
     return x && y;
 }
 
+/**
+ * Divides, rounding towards negative infinity, so that the tiles just above
+ * and to the left of the canvas don't end up in the first row or column.
+ */
+static int floor_div(int a, int b)
+{
+    return (a >= 0) ? a / b : -((-a + b - 1) / b);
+}
+
 IntPoint Game::get_canvas_coords(IntPoint chunk, IntPoint coords){
     IntPoint tl_abs = utility::get_abs(main_char.get_chunk(),
-               IntPoint(main_char.get_y() - CHUNK_HEIGHT/2, main_char.get_x() - CHUNK_WIDTH/2));
+               IntPoint(main_char.get_y() - (view_height * zoom)/2, main_char.get_x() - (view_width * zoom)/2));
     IntPoint abs = utility::get_abs(chunk, coords);
-    return IntPoint(abs.row - tl_abs.row, abs.col - tl_abs.col);
+    return IntPoint(floor_div(abs.row - tl_abs.row, zoom), floor_div(abs.col - tl_abs.col, zoom));
+}
+
+void Game::set_view(int height, int width, int _zoom)
+{
+    assert(height > 0 && width > 0 && _zoom > 0);
+    view_height = height;
+    view_width = width;
+    zoom = _zoom;
+
+    //Before the game starts, init() takes care of making the canvas and
+    //buffer the right size.
+    if(initialized)
+    {
+        canvas = TilePointerMatrix(view_height, vector<Tile*>(view_width));
+        if(required_buffer_radius() > buffer_radius)
+        {
+            resize_buffer();
+        }
+        refresh();
+    }
+    bump_generation();
+}
+
+IntPoint Game::get_view_size()
+{
+    return IntPoint(view_height, view_width);
+}
+
+int Game::get_zoom()
+{
+    return zoom;
 }
@@ -17,8 +17,12 @@
  *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <climits>
+
 #include "game.h"
 
+thread_local DecideContext* Game::deciding = NULL;
+
 /**
  * This controller is to access character data and control characters.
  * It provides the interface between the character data structures in
@@ -29,11 +33,20 @@
 void Game::update_character_index()
 {
     clear_character_index();
-    for(int i=0;i<character_list.size();i++)
+    //Reads the positions straight out of the store rather than asking
+    //each character, since this goes through every character there is.
+    CharacterStore& store = CharacterStore::instance();
+    for(int i=0;i<store.size();i++)
     {
-        if(point_in_buffer(character_list[i]->get_chunk(), character_list[i]->get_coords()))
+        if(store.owner[i] != this)
+        {
+            continue;
+        }
+        IntPoint buffer_coords = get_buffer_coords(IntPoint(store.chunk_row[i], store.chunk_col[i]),
+                IntPoint(store.y[i], store.x[i]));
+        if(coords_in_buffer(buffer_coords.row, buffer_coords.col))
         {
-            character_to_index(character_list[i]);
+            character_index[buffer_coords.row][buffer_coords.col] = store.handle_at(i);
         }
     }
     character_to_index(&main_char);
@@ -46,7 +59,7 @@ void Game::clear_character_index()
     {
         for(int j=0;j<character_index[i].size();j++)
         {
-            character_index[i][j] = NULL;
+            character_index[i][j] = CharacterHandle();
         }
     }
 }
@@ -55,7 +68,10 @@ void Game::clear_character_index()
 void Game::character_to_index(Character* chara)
 {
     IntPoint buffer_coords = get_buffer_coords(chara->get_chunk(), chara->get_coords());
-    character_index[buffer_coords.row][buffer_coords.col] = chara;
+    if(coords_in_buffer(buffer_coords.row, buffer_coords.col))
+    {
+        character_index[buffer_coords.row][buffer_coords.col] = chara->get_handle();
+    }
 }
 
 
@@ -64,7 +80,7 @@ void Game::remove_index_char(Character* chara)
     IntPoint buffer_coords = get_buffer_coords(chara->get_chunk(), chara->get_coords());
     if(coords_in_buffer(buffer_coords.row, buffer_coords.col))
     {
-        character_index[buffer_coords.row][buffer_coords.col] = NULL;
+        character_index[buffer_coords.row][buffer_coords.col] = CharacterHandle();
     }
 }
 
@@ -73,19 +89,34 @@ std::vector<Character*>& Game::get_characters() {
 }
 
 
-void Game::remove_targets(Character* enem)
+void Game::list_character(Character* chara)
 {
-    for(int i=0;i<character_list.size();i++)
+    unsigned int index = chara->get_handle().index;
+    if(index >= character_places.size())
     {
-        if(character_list[i]->get_target() == enem)
-        {
-            character_list[i]->set_target(NULL);
-        }
+        character_places.resize(index + 1, -1);
     }
-    if(main_char.get_target() == enem)
+    character_places[index] = character_list.size();
+    character_list.push_back(chara);
+    CharacterStore& store = CharacterStore::instance();
+    store.owner[store.row(chara->get_handle())] = this;
+}
+
+void Game::unlist_character(Character* chara)
+{
+    unsigned int index = chara->get_handle().index;
+    if(index >= character_places.size() || character_places[index] < 0)
     {
-        main_char.set_target(NULL);
+        return;
     }
+    int place = character_places[index];
+    Character* last = character_list.back();
+    character_list[place] = last;
+    character_places[last->get_handle().index] = place;
+    character_list.pop_back();
+    character_places[index] = -1;
+    CharacterStore& store = CharacterStore::instance();
+    store.owner[store.row(chara->get_handle())] = NULL;
 }
 
 
@@ -93,14 +124,15 @@ bool Game::find_target(Character* chara){
     //establish the necessary variables
     //the character is 'passive'
     Character* best = NULL;
-    std::vector<Character*> characters = characters_in_range(chara);
+    std::vector<Character*>& seen = deciding != NULL ? deciding->characters_seen : characters_seen;
+    characters_in_range(chara, seen);
     if(chara->get_moral() == 3)
     {
-        best = passive_target(chara, characters);
+        best = passive_target(chara, seen);
     }
     else
     {
-        best = normal_target(chara, characters);
+        best = normal_target(chara, seen);
     }
 
     if(best != NULL)
@@ -114,7 +146,7 @@ bool Game::find_target(Character* chara){
     }
 }
 
-Character* Game::normal_target(Character* chara, std::vector<Character*> characters)
+Character* Game::normal_target(Character* chara, const std::vector<Character*>& characters)
 {
     Character* best = NULL;
     Character* new_character = NULL;
@@ -144,7 +176,7 @@ Character* Game::normal_target(Character* chara, std::vector<Character*> charact
     return best;
 }
 
-Character* Game::passive_target(Character* chara, std::vector<Character*> characters)
+Character* Game::passive_target(Character* chara, const std::vector<Character*>& characters)
 {
     Character* best = NULL;
     Character* new_character = NULL;
@@ -172,31 +204,100 @@ Character* Game::passive_target(Character* chara, std::vector<Character*> charac
 }
 
 
-std::vector<Character*> Game::characters_in_range(Character* chara)
+namespace
 {
-    std::vector<IntPoint> sight_tiles = chara->sight_tiles();
-    std::vector<Character*> temp;
-    Character* new_character;
-    for(int i=0;i<sight_tiles.size();i++)
+    /**
+     * Picks up every character standing on a cell of a sight cone.
+     */
+    struct CollectCharacters
     {
-        IntPoint index_coords = get_buffer_coords(chara->get_chunk(), sight_tiles[i]);
-        if(coords_in_buffer(index_coords.row, index_coords.col))
+        const std::vector<std::vector<CharacterHandle> >* index;
+        int row;
+        int col;
+        std::vector<Character*>* found;
+
+        void operator()(int row_rel, int col_rel)
         {
-            new_character = character_index[index_coords.row][index_coords.col];
+            int r = row + row_rel;
+            int c = col + col_rel;
+            if(r < 0 || c < 0 || r >= index->size() || c >= (*index)[r].size())
+            {
+                return;
+            }
+            Character* chara = Character::lookup((*index)[r][c]);
+            if(chara != NULL)
+            {
+                found->push_back(chara);
+            }
         }
-        if(new_character != NULL)
+    };
+
+    struct CollectTiles
+    {
+        IntPoint coords;
+        std::vector<IntPoint>* tiles;
+
+        void operator()(int row_rel, int col_rel)
         {
-            temp.push_back(new_character);
+            tiles->push_back(IntPoint(coords.row + row_rel, coords.col + col_rel));
         }
+    };
+}
+
+void Game::characters_in_range(Character* chara, std::vector<Character*>& found)
+{
+    found.clear();
+    IntPoint origin = get_buffer_coords(chara->get_chunk(), chara->get_coords());
+    BufferOpacity opacity = {&buffer_opaque, origin.row, origin.col};
+    CollectCharacters collect = {&character_index, origin.row, origin.col, &found};
+    std::vector<unsigned char>& scratch = deciding != NULL ? deciding->sight_scratch : sight_scratch;
+    sight_cone::trace(chara->get_sight_cone(), opacity, scratch, collect);
+}
+
+void Game::visible_sight_tiles(Character* chara, std::vector<IntPoint>& tiles)
+{
+    tiles.clear();
+    IntPoint origin = get_buffer_coords(chara->get_chunk(), chara->get_coords());
+    BufferOpacity opacity = {&buffer_opaque, origin.row, origin.col};
+    CollectTiles collect = {chara->get_coords(), &tiles};
+    sight_cone::trace(chara->get_sight_cone(), opacity, sight_scratch, collect);
+}
+
+int Game::ai_detail(Character* chara)
+{
+    IntPoint here = utility::get_abs(chara->get_chunk(), chara->get_coords());
+    IntPoint player = utility::get_abs(main_char.get_chunk(), main_char.get_coords());
+    int distance = std::max(std::abs(here.row - player.row), std::abs(here.col - player.col));
+    if(distance <= FULL_AI_RANGE && chara->get_depth() == main_char.get_depth())
+    {
+        return AI_FULL;
     }
-    return temp;
+    return AI_COARSE;
 }
 
 int Game::move_to_point(Character* chara, IntPoint coords, IntPoint chunk)
 {
+    if(ai_detail(chara) == AI_COARSE)
+    {
+        return move_coarse(chara, coords, chunk);
+    }
+    std::lock_guard<std::recursive_mutex> lock(plan_mutex);
     IntPoint goal = get_buffer_coords(chunk, coords);
     IntPoint current = get_buffer_coords(chara->get_chunk(), chara->get_coords());
-    IntPoint movement = pathfinding::get_next_step(goal, buffer, current, chara->get_sight());
+    IntPoint step_goal = goal;
+    int radius = chara->get_sight();
+    if(std::abs(goal.row - current.row) > radius || std::abs(goal.col - current.col) > radius)
+    {
+        const RouteStop* stop = next_route_stop(chara, coords, chunk);
+        if(stop != NULL)
+        {
+            //The stops can be a chunk apart, so the search has to reach
+            //at least that far.
+            step_goal = get_buffer_coords(stop->chunk, stop->coords);
+            radius += std::max(std::abs(step_goal.row - current.row), std::abs(step_goal.col - current.col));
+        }
+    }
+    IntPoint movement = next_planned_step(chara, current, step_goal, radius);
     if((movement + current) == goal)
     {
         return 1; //success
@@ -212,6 +313,22 @@ int Game::move_to_point(Character* chara, IntPoint coords, IntPoint chunk)
 }
 
 
+int Game::move_coarse(Character* chara, IntPoint coords, IntPoint chunk)
+{
+    IntPoint goal = get_buffer_coords(chunk, coords);
+    IntPoint current = get_buffer_coords(chara->get_chunk(), chara->get_coords());
+    IntPoint movement = pathfinding::dumb_path(goal, buffer_passable, current);
+    if((movement + current) == goal)
+    {
+        return 1;
+    }
+    else if(move_char(movement.col, movement.row, chara))
+    {
+        return 2;
+    }
+    return 0;
+}
+
 int Game::run_away(Character* chara, IntPoint coords, IntPoint chunk)
 {
     IntPoint current_coords = utility::get_abs(chara->get_chunk(), chara->get_coords());
@@ -220,17 +337,256 @@ int Game::run_away(Character* chara, IntPoint coords, IntPoint chunk)
     return move_char(movement.col, movement.row, chara);
 }
 
+const RouteStop* Game::next_route_stop(Character* chara, IntPoint coords, IntPoint chunk)
+{
+    std::map<Character*, CachedRoute>::iterator it = routes.find(chara);
+    if(it == routes.end() || !(it->second.goal_chunk == chunk))
+    {
+        RouteStop start = {chara->get_chunk(), chara->get_coords(), chara->get_depth()};
+        RouteStop goal = {chunk, coords, chara->get_depth()};
+        CachedRoute route;
+        route.goal_chunk = chunk;
+        route.next = 0;
+        if(route_planner.plan(chunk_map, start, goal, false))
+        {
+            route.stops = route_planner.get_route();
+        }
+        it = routes.insert(std::make_pair(chara, route)).first;
+        it->second = route;
+    }
+
+    //Skip the stops that the character has already made it to.
+    CachedRoute& route = it->second;
+    IntPoint here = utility::get_abs(chara->get_chunk(), chara->get_coords());
+    while(route.next < route.stops.size())
+    {
+        IntPoint stop = utility::get_abs(route.stops[route.next].chunk, route.stops[route.next].coords);
+        if(std::abs(stop.row - here.row) > 1 || std::abs(stop.col - here.col) > 1)
+        {
+            break;
+        }
+        route.next++;
+    }
+
+    if(route.next >= route.stops.size() ||
+            !point_in_buffer(route.stops[route.next].chunk, route.stops[route.next].coords))
+    {
+        return NULL;
+    }
+    return &route.stops[route.next];
+}
+
+FlowField* Game::flow_field_to(Character* target)
+{
+    if(target->get_depth() != main_char.get_depth() ||
+            !point_in_buffer(target->get_chunk(), target->get_coords()))
+    {
+        return NULL;
+    }
+
+    IntPoint coords = get_buffer_coords(target->get_chunk(), target->get_coords());
+    std::pair<Character*, int> key = std::make_pair(target, target->get_depth());
+    std::map<std::pair<Character*, int>, CachedFlowField>::iterator it = flow_fields.find(key);
+    if(it == flow_fields.end())
+    {
+        it = flow_fields.insert(std::make_pair(key, CachedFlowField())).first;
+    }
+    else if(it->second.field.get_target() == coords && it->second.version == passable_version)
+    {
+        return &it->second.field;
+    }
+
+    it->second.field.build(buffer_passable, coords, FLOW_FIELD_RADIUS);
+    it->second.version = passable_version;
+    return &it->second.field;
+}
+
+int Game::move_towards(Character* chara, Character* target)
+{
+    //Nobody is close enough to see a distant character take the long
+    //way around, so it isn't worth a map.
+    if(ai_detail(chara) == AI_COARSE)
+    {
+        return move_coarse(chara, target->get_coords(), target->get_chunk());
+    }
+    std::lock_guard<std::recursive_mutex> lock(plan_mutex);
+    FlowField* field = flow_field_to(target);
+    IntPoint current = get_buffer_coords(chara->get_chunk(), chara->get_coords());
+    if(field == NULL || chara->get_depth() != target->get_depth() ||
+            field->distance(current) == FlowField::UNREACHABLE)
+    {
+        return move_to_point(chara, target->get_coords(), target->get_chunk());
+    }
+
+    IntPoint movement = field->step_towards(current);
+    if((movement + current) == field->get_target())
+    {
+        return 1;
+    }
+    else if(move_char(movement.col, movement.row, chara))
+    {
+        return 2;
+    }
+    return 0;
+}
+
+int Game::move_away(Character* chara, Character* target)
+{
+    if(ai_detail(chara) == AI_COARSE)
+    {
+        return run_away(chara, target->get_coords(), target->get_chunk());
+    }
+    std::lock_guard<std::recursive_mutex> lock(plan_mutex);
+    FlowField* field = flow_field_to(target);
+    IntPoint current = get_buffer_coords(chara->get_chunk(), chara->get_coords());
+    if(field == NULL || chara->get_depth() != target->get_depth() ||
+            field->distance(current) == FlowField::UNREACHABLE)
+    {
+        return run_away(chara, target->get_coords(), target->get_chunk());
+    }
+
+    field->build_flee(buffer_passable);
+    IntPoint movement = field->step_away(current);
+    return move_char(movement.col, movement.row, chara);
+}
+
+IntPoint Game::next_planned_step(Character* chara, IntPoint current, IntPoint goal, int radius)
+{
+    std::map<Character*, PathPlan>::iterator it = path_plans.find(chara);
+    if(it == path_plans.end())
+    {
+        PathPlan fresh;
+        fresh.goal = goal;
+        fresh.failed = false;
+        fresh.version = passable_version;
+        fresh.ticket = 0;
+        it = path_plans.insert(std::make_pair(chara, fresh)).first;
+    }
+    PathPlan& plan = it->second;
+
+    //Drop the step that has just been taken, and the whole plan if the
+    //character got pushed off of it or something is in the way now.
+    if(!plan.path.empty() && plan.path.back() == current)
+    {
+        plan.path.pop_back();
+    }
+    if(!plan.path.empty())
+    {
+        IntPoint next = plan.path.back();
+        int distance = std::max(std::abs(next.row - current.row), std::abs(next.col - current.col));
+        if(distance != 1 || !buffer_passable.test(next.row, next.col))
+        {
+            plan.path.clear();
+            plan.failed = false;
+        }
+    }
+
+    bool stale = !(plan.goal == goal) ||
+        (plan.path.empty() && (!plan.failed || plan.version != passable_version));
+    if(plan.ticket == 0 && stale && !(current == goal))
+    {
+        //Every move costs the same, so jump point search finds just as
+        //good a path as A* while expanding fewer tiles.
+        plan.ticket = path_queue.submit(current, goal, chara->get_depth(), radius, PATH_JUMP_POINT);
+        plan.pending_goal = goal;
+        path_tickets[plan.ticket] = chara;
+    }
+
+    if(!plan.path.empty())
+    {
+        return plan.path.back() - current;
+    }
+    return pathfinding::dumb_path(goal, buffer_passable, current);
+}
+
+void Game::forget_plan(Character* chara)
+{
+    std::map<Character*, PathPlan>::iterator it = path_plans.find(chara);
+    if(it != path_plans.end())
+    {
+        path_tickets.erase(it->second.ticket);
+        path_plans.erase(it);
+    }
+}
+
+void Game::collect_paths()
+{
+    std::vector<PathResult> results;
+    if(!path_queue.collect(results))
+    {
+        return;
+    }
+
+    for(size_t i = 0; i < results.size(); i++)
+    {
+        //Anything without a ticket was for a character that's gone, or
+        //for a buffer that has moved since.
+        std::map<unsigned long, Character*>::iterator owner = path_tickets.find(results[i].ticket);
+        if(owner == path_tickets.end())
+        {
+            continue;
+        }
+        PathPlan& plan = path_plans[owner->second];
+        path_tickets.erase(owner);
+        plan.ticket = 0;
+        plan.goal = plan.pending_goal;
+        plan.path.swap(results[i].path);
+        plan.failed = !results[i].found;
+        plan.version = results[i].version;
+    }
+}
+
+void Game::dispatch_paths()
+{
+    path_queue.dispatch(buffer_passable, main_char.get_depth(), passable_version);
+}
+
+int Game::ai_rand()
+{
+    if(deciding == NULL || deciding->random == NULL)
+    {
+        return rand();
+    }
+    unsigned int& seed = *deciding->random;
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 16) & 0x7fff;
+}
+
+void Game::set_deciding(DecideContext* context)
+{
+    deciding = context;
+}
+
+void Game::apply_command(const AICommand& command)
+{
+    if(command.kind == AICommand::MOVE)
+    {
+        if(!move_char(command.step.col, command.step.row, command.chara))
+        {
+            command.chara->interrupt(INTERRUPT_BLOCKED);
+        }
+    }
+    else
+    {
+        attack_char(command.chara, command.target);
+    }
+}
+
 void Game::wander(Character* chara)
 {
-    int will_move = rand() % 5;
-    int x_change = rand() % 3 - 1;
-    int y_change = rand() % 3 - 1;
+    int will_move = ai_rand() % 5;
+    int x_change = ai_rand() % 3 - 1;
+    int y_change = ai_rand() % 3 - 1;
     IntPoint new_coords = IntPoint(chara->get_y() + y_change, chara->get_x() + x_change);
 
-    int turn_amount = rand() % 20 - 10;
+    int turn_amount = ai_rand() % 20 - 10;
     if(will_move == 0)
     {
         chara->turn(turn_amount);
+        if(chara == main_char.get_target())
+        {
+            bump_generation();
+        }
     }
 
     if(point_in_buffer(chara->get_chunk(), new_coords) && will_move == 0)
@@ -268,16 +624,20 @@ void Game::kill(Character* chara)
 
 void Game::remove_enemy(Character* chara)
 {
-    remove_targets(chara);
-    for(int i=0;i<character_list.size();i++)
+    //Anyone targeting or following it finds nothing once it's deleted,
+    //so only the things keyed by the pointer have to go.
+    routes.erase(chara);
+    forget_plan(chara);
+    std::map<std::pair<Character*, int>, CachedFlowField>::iterator it =
+        flow_fields.lower_bound(std::make_pair(chara, INT_MIN));
+    while(it != flow_fields.end() && it->first.first == chara)
     {
-        if(character_list[i] == chara)
-        {
-            character_list.erase(character_list.begin() + i);
-        }
+        flow_fields.erase(it++);
     }
+    unlist_character(chara);
     remove_index_char(chara);
     delete chara;
+    bump_generation();
 }
 
 
@@ -302,6 +662,7 @@ void Game::change_depth(int direction, Character* chara) {
                 chara->set_depth(chara->get_depth() - 1);
                 chara->set_x(current_chunk->get_down_stairs(chara->get_depth())[0].col);
                 chara->set_y(current_chunk->get_down_stairs(chara->get_depth())[0].row);
+                bump_generation();
             }
         }
     } else {
@@ -310,6 +671,7 @@ void Game::change_depth(int direction, Character* chara) {
                 chara->set_depth(chara->get_depth() + 1);
                 chara->set_x(current_chunk->get_up_stairs(chara->get_depth())[0].col);
                 chara->set_y(current_chunk->get_up_stairs(chara->get_depth())[0].row);
+                bump_generation();
             }
         } else {
             cout<<"DEPTH OF THIS CHUNK: "<<current_chunk->get_depth()<<endl;
@@ -337,9 +699,14 @@ bool Game::move_char(int col_change, int row_change, Character* chara) {
     Character* enem = character_at_loc(new_chunk, next_coords);
 
     IntPoint buffer_coords = get_buffer_coords(new_chunk, IntPoint(next_row, next_col));
-    bool can_move = coords_in_buffer(buffer_coords.row, buffer_coords.col) && buffer[buffer_coords.row][buffer_coords.col]->can_be_moved_through;
+    bool can_move = buffer_passable.test(buffer_coords.row, buffer_coords.col);
 
-    if(can_move && (enem == NULL)) {
+    if(can_move && (enem == NULL) && deciding != NULL) {
+        AICommand command = {AICommand::MOVE, chara, IntPoint(row_change, col_change), NULL};
+        deciding->commands.push_back(command);
+        return true;
+    }
+    else if(can_move && (enem == NULL)) {
         remove_index_char(chara);
         col = next_col;
         row = next_row;
@@ -350,6 +717,7 @@ bool Game::move_char(int col_change, int row_change, Character* chara) {
         }
         chara->reduce_endurance(1);
         character_to_index(chara);
+        bump_generation();
         return true;
     }
     else if(can_move && (enem != NULL) && chara == &main_char)
@@ -363,9 +731,16 @@ bool Game::move_char(int col_change, int row_change, Character* chara) {
 
 bool Game::attack_char(Character* chara, Character* target)
 {
+    if(deciding != NULL)
+    {
+        AICommand command = {AICommand::ATTACK, chara, IntPoint(0, 0), target};
+        deciding->commands.push_back(command);
+        return true;
+    }
     chara->attack(target);
     chara->set_target(target);
     chara->reduce_endurance(2);
+    bump_generation();
     if(!target->is_alive())
     {
         chara->gain_experience(target->get_stat(LEVEL));
@@ -381,6 +756,10 @@ void Game::turn_character(Character* chara, Character* target)
         IntPoint chara_coords = utility::get_abs(chara->get_chunk(), chara->get_coords());
         IntPoint target_coords = utility::get_abs(target->get_chunk(), target->get_coords());
         chara->turn(target_coords - chara_coords);
+        if(chara == main_char.get_target())
+        {
+            bump_generation();
+        }
     }
 }
 
@@ -389,6 +768,10 @@ void Game::turn_away(Character* chara, Character* target)
     if(target != NULL)
     {
         chara->turn(chara->get_coords() - target->get_coords());
+        if(chara == main_char.get_target())
+        {
+            bump_generation();
+        }
     }
 }
 
@@ -411,17 +794,16 @@ void Game::get_item(Character* chara)
         chara->add_item(temp_item);
         current_chunk->remove_item(temp_item, chara->get_depth());
         IntPoint b_coords = get_buffer_coords(chunk, coords);
-        bool was_seen = buffer[b_coords.row][b_coords.col]->visible;
         Item* item = item_at_coords(IntPoint(chara->get_y(), chara->get_x()), chara->get_chunk(), chara->get_depth());
         if(item != NULL)
         {
-            buffer[b_coords.row][b_coords.col] = item->get_sprite();
+            set_buffer_tile(b_coords.row, b_coords.col, item->get_sprite());
         }
         else
         {
-            buffer[b_coords.row][b_coords.col] = current_chunk->get_tile(chara->get_depth(), coords.row, coords.col);
+            set_buffer_tile(b_coords.row, b_coords.col, current_chunk->get_tile(chara->get_depth(), coords.row, coords.col));
         }
-        buffer[b_coords.row][b_coords.col]->visible = was_seen;
+        bump_generation();
     }
 }
 
@@ -467,5 +849,5 @@ void Game::harvest_plant(Plant *plant, Character* chara)
 Character* Game::character_at_loc(IntPoint _chunk, IntPoint _coords) {
     IntPoint coords = get_buffer_coords(_chunk, _coords);
     assert(coords_in_buffer(coords.row, coords.col));
-    return character_index[coords.row][coords.col];
+    return Character::lookup(character_index[coords.row][coords.col]);
 }
@@ -47,3 +47,58 @@ Plant* Game::get_plant(IntPoint chunk, IntPoint coords, int depth)
     return t_chunk->get_plant(coords, depth);
 }
 
+
+void Game::summarize_chunks()
+{
+    int radius = chunk_map.get_diameter() / 2;
+    IntPoint center = main_char.get_chunk();
+    for(int row = center.row - radius; row <= center.row + radius; row++)
+    {
+        for(int col = center.col - radius; col <= center.col + radius; col++)
+        {
+            if(row < 0 || col < 0 || row >= WORLD_HEIGHT || col >= WORLD_WIDTH)
+            {
+                continue;
+            }
+            Chunk* chunk = chunk_map.get_chunk_abs(row, col);
+            std::vector<ChunkSummary>* summaries = &chunk_summaries[row * WORLD_WIDTH + col];
+            summaries->resize(chunk->get_depth());
+            for(int depth = 0; depth < chunk->get_depth(); depth++)
+            {
+                (*summaries)[depth] = chunk->get_summary(depth);
+            }
+        }
+    }
+}
+
+const ChunkSummary* Game::get_chunk_summary(IntPoint world_chunk, int depth)
+{
+    std::unordered_map<int, std::vector<ChunkSummary> >::iterator it;
+    it = chunk_summaries.find(world_chunk.row * WORLD_WIDTH + world_chunk.col);
+    if(world_chunk.row < 0 || world_chunk.col < 0 ||
+            world_chunk.row >= WORLD_HEIGHT || world_chunk.col >= WORLD_WIDTH ||
+            it == chunk_summaries.end() || depth < 0 || depth >= it->second.size())
+    {
+        return NULL;
+    }
+    return &it->second[depth];
+}
+
+const Bitplane* Game::get_explored(IntPoint world_chunk, int depth)
+{
+    if(!chunk_in_buffer(world_chunk.row, world_chunk.col))
+    {
+        return NULL;
+    }
+    Chunk* chunk = chunk_map.get_chunk_abs(world_chunk);
+    if(depth < 0 || depth >= chunk->get_depth())
+    {
+        return NULL;
+    }
+    return chunk->get_explored(depth);
+}
+
+const std::vector<std::vector<MapTile> >& Game::get_world_map()
+{
+    return world_map.get_map();
+}
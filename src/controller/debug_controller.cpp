@@ -23,8 +23,9 @@ void Game::spawn_enemy(int chunk_x, int chunk_y, int x, int y, int depth, int ty
         Enemy* temp = new Enemy(x, y, depth, ENEMY_LIST[type]);
         temp->set_chunk(IntPoint(chunk_y, chunk_x));
         character_queue.push_back(temp);
-        character_list.push_back(temp);
+        list_character(temp);
         character_to_index(temp);
+        bump_generation();
 }
 
 void Game::teleport(int chunk_x, int chunk_y, int x, int y)
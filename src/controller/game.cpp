@@ -21,6 +21,7 @@
 #include <stdlib.h>
 
 #include "game.h"
+#include "profiler.h"
 
 using namespace std;
 
@@ -68,6 +69,18 @@ taken from the buffer with the character at the center.
 Game::Game() {
     initialized = false;
     paused = false;
+    generation = 0;
+    view_height = GAME_HEIGHT;
+    view_width = GAME_WIDTH;
+    zoom = 1;
+    buffer_radius = 1;
+    passable_version = 0;
+    fov_radius = 15;
+    fov_depth = 0;
+    fov_valid = false;
+    visibility_generation = 0;
+    canvas_top = 0;
+    canvas_left = 0;
 }
 
 Game::~Game()
@@ -81,11 +94,17 @@ Game::~Game()
 
 void Game::init(const WorldMap& _world_map, IntPoint selected_chunk) {
     world_map = _world_map;
-
-    //Give me a buffer size of 150x300 (tiles, which are 8x16 pixels)
-    //The buffer is what the screen draws from.
-    buffer = TilePointerMatrix(CHUNK_HEIGHT * 3, vector<Tile*>(CHUNK_WIDTH * 3));
-    character_index = std::vector<std::vector<Character*> >(CHUNK_HEIGHT * 3, std::vector<Character*>(CHUNK_WIDTH * 3));
+    chunk_summaries.clear();
+
+    //The buffer is what the screen draws from.  It holds enough chunks
+    //around the main character to cover the view (3x3 chunks, or
+    //150x300 tiles, unless the view is very big or zoomed out).
+    buffer_radius = required_buffer_radius();
+    int diameter = buffer_radius * 2 + 1;
+    buffer = TilePointerMatrix(CHUNK_HEIGHT * diameter, vector<Tile*>(CHUNK_WIDTH * diameter));
+    buffer_opaque.resize(CHUNK_HEIGHT * diameter, CHUNK_WIDTH * diameter);
+    buffer_passable.resize(CHUNK_HEIGHT * diameter, CHUNK_WIDTH * diameter);
+    character_index = std::vector<std::vector<CharacterHandle> >(CHUNK_HEIGHT * diameter, std::vector<CharacterHandle>(CHUNK_WIDTH * diameter));
     clear_character_index();
 
     //Each chunk holds an overworld and several
@@ -102,24 +121,23 @@ void Game::init(const WorldMap& _world_map, IntPoint selected_chunk) {
     wolf->set_master(&main_char);
     wolf->set_chunk(main_char.get_chunk());
 
-    character_list.push_back(wolf);
+    list_character(wolf);
     character_queue.push_back(wolf);
     character_to_index(wolf);
 
     IntPoint buffer_coords = get_buffer_coords(main_char.get_chunk(), main_char.get_coords());
-    character_index[buffer_coords.row][buffer_coords.col] = &main_char;
+    character_index[buffer_coords.row][buffer_coords.col] = main_char.get_handle();
 
     // Out of bounds tiles look like a generic BLOCK_WALL.
     buffer_tile_placeholder=Tileset::get("BLOCK_WALL");
 
 
     //What gets drawn to the screen
-    canvas = TilePointerMatrix(GAME_HEIGHT, vector<Tile*>(GAME_WIDTH));
+    canvas = TilePointerMatrix(view_height, vector<Tile*>(view_width));
 
-    //Eventually, this should be based on screen size.
-    chunk_map = ChunkMatrix(3, selected_chunk, world_map.get_map(), name);
+    chunk_map = ChunkMatrix(diameter, selected_chunk, world_map.get_map(), name);
     update_buffer(main_char.get_chunk());
-    recalculate_visibility_lines(15);
+    set_visibility_radius(15);
     refresh();
 
     visibility_on = true;
@@ -158,9 +176,29 @@ void Game::unpause() {
     paused = false;
 }
 
+void Game::bump_generation() {
+    if(deciding != NULL)
+    {
+        deciding->changed = true;
+        return;
+    }
+    generation++;
+}
+
+unsigned long Game::get_generation() {
+    return generation;
+}
+
 void Game::act(long delta_ms) {
     tick_animations(delta_ms);
+    int endurance = main_char.get_current_stat(ENDURANCE);
     main_char.act(delta_ms);
+    population.step(delta_ms, main_char.get_chunk(), buffer_radius);
+
+    //The endurance is shown in the interface.
+    if(main_char.get_current_stat(ENDURANCE) != endurance) {
+        bump_generation();
+    }
 }
 
 /*
@@ -169,121 +207,122 @@ void Game::act(long delta_ms) {
  * This is to refresh the screen whenever the character moves.
  */
 void Game::refresh() {
-    for(int i = 0; i < GAME_HEIGHT; i++) {
-        for (int j = 0; j < GAME_WIDTH; j++) {
-            //aight, this needs some comments becuase ain't nobody can
-            //read this
-
-            //if you suddenly start getting weird visual errors when you
-            //try to make the buffer hold more than 3 chunks at a time,
-            //this is why.  Right now, it assumes that you're always in
-            //the middle chunk of 3 (+ 1 chunk_height)
-
-            //Explanation for the following:
-            //Here is the buffer:
-            //123
-            //456
-            //789
-            //You are always in chunk 5, because it updates when you move.
-            //Therefore, you are always + 1 chunk_size (height or width)
-            //relative to the top  of the buffer.
-            //To get the screens coordinates, you add 1 chunk_size to
-            //your coords, then subtract half of the screen that you want
-            //to display, and then add the index.
-            int buffer_tile_row = (CHUNK_HEIGHT + main_char.get_y()) -
-                (GAME_HEIGHT/2) + i;
-            int buffer_tile_col = (CHUNK_WIDTH + main_char.get_x()) -
-                (GAME_WIDTH/2) + j;
-            set_tile(i, j, buffer[buffer_tile_row][buffer_tile_col]);
+    //The buffer is (buffer_radius * 2 + 1) chunks across, and the main
+    //character is always in the middle chunk, because it updates when you
+    //move.  Here is a buffer with a radius of 1:
+    //123
+    //456
+    //789
+    //You are always in chunk 5, so you are buffer_radius chunks plus your
+    //own coordinates from the top left of the buffer.  The canvas covers
+    //(view * zoom) tiles with you in the center, and each character in it
+    //is taken from the middle of its zoom x zoom block of tiles.  Anything
+    //that falls outside of the buffer is drawn as the placeholder.
+    IntPoint center = get_buffer_coords(main_char.get_chunk(), main_char.get_coords());
+    int top = center.row - (view_height * zoom) / 2 + zoom / 2;
+    int left = center.col - (view_width * zoom) / 2 + zoom / 2;
+    canvas_top = top;
+    canvas_left = left;
+    for(int i = 0; i < view_height; i++) {
+        for (int j = 0; j < view_width; j++) {
+            int buffer_tile_row = top + i * zoom;
+            int buffer_tile_col = left + j * zoom;
+            if(coords_in_buffer(buffer_tile_row, buffer_tile_col)) {
+                set_tile(i, j, buffer[buffer_tile_row][buffer_tile_col]);
+            } else {
+                set_tile(i, j, &buffer_tile_placeholder);
+            }
         }
     }
-    draw_visibility_lines();
+    update_visibility();
 }
 
 
 
 //--------------------VISIBILITY STUFF-----------------------//
 
-/**
- * PRE: Will be given :int size:, the radius of the FOV circle
- * POST: Will set bresenham_lines, a vector of IntPoint vectors containing
- * points for raytraced lines.
- */
-void Game::recalculate_visibility_lines(int size) {
-    IntPoint true_center = IntPoint(0, 0);
-    std::vector<IntPoint> circle_points = bresenham_circle(true_center, size);
-    std::vector<IntPoint> smaller_circle = bresenham_circle(true_center, size - 1);
-
-    for(int i = 0; i < smaller_circle.size(); i++) {
-        circle_points.push_back(smaller_circle[i]);
-    }
-
-    std::vector<IntPoint> line_points;
-
-    for(size_t i = 0; i < circle_points.size(); i++) {
-        line_points = bresenham_line(true_center, circle_points[i]);
-        bresenham_lines.push_back(line_points);
+void Game::set_visibility_radius(int radius) {
+    if(radius != fov_radius) {
+        fov_radius = radius;
+        invalidate_visibility();
     }
 }
 
+void Game::invalidate_visibility() {
+    fov_valid = false;
+}
 
-
+unsigned long Game::get_visibility_generation() {
+    return visibility_generation;
+}
 
 /*
- * PRE: bresenham_lines should already be set by recalculate_visibility_lines().
- * POST: Draws a field-of-vision around the player - sets tiles' visibility
- * to true if they have been seen by the player.
+ * POST: Works out the field-of-vision around the player if it could have
+ * changed, lights it up on the layers in the buffer, and marks it as
+ * explored.
  */
-void Game::draw_visibility_lines() {
-    IntPoint m_char = IntPoint(GAME_HEIGHT/2, GAME_WIDTH/2);
-    Tile* current_chunk_tile;
-    IntPoint current_point;
-    int row, col;
-
-    for(size_t i = 0; i < bresenham_lines.size(); i++) {
-        for(size_t j = 1; j < bresenham_lines[i].size(); j++) {
-            current_point = bresenham_lines[i][j];
-            row = current_point.row + m_char.row;
-            col = current_point.col + m_char.col;
-
-            if(!out_of_bounds(IntPoint(row, col))) {
-                current_chunk_tile = get_tile(row, col);
-                current_chunk_tile->visible = true;
-                current_chunk_tile->seen = true;
-                if(current_chunk_tile->opaque) {
-                    break;
-                }
-            }
-        }
+void Game::update_visibility() {
+    IntPoint chunk = main_char.get_chunk();
+    IntPoint coords = main_char.get_coords();
+    int depth = main_char.get_depth();
+    if(fov_valid && chunk == fov_chunk && coords == fov_coords && depth == fov_depth) {
+        return;
     }
-}
 
-void Game::undo_visibility() {
-    IntPoint m_char = IntPoint(GAME_HEIGHT/2, GAME_WIDTH/2);
-    Tile* current_chunk_tile;
-    IntPoint current_point;
-    int row, col;
-
-    for(size_t i = 0; i < bresenham_lines.size(); i++) {
-        for(size_t j = 1; j < bresenham_lines[i].size(); j++) {
-            current_point = bresenham_lines[i][j];
-            row = current_point.row + m_char.row;
-            col = current_point.col + m_char.col;
-
-            if(!out_of_bounds(IntPoint(row, col))) {
-                current_chunk_tile = get_tile(row, col);
-                current_chunk_tile->visible = false;
-                current_chunk_tile->seen = true;
-                /* *current_chunk_tile = ROOM_WALL;
-                 *current_chunk_tile->visible = true;
-                 *current_chunk_tile->can_be_moved_through = true;
-                 */
-                if(current_chunk_tile->opaque) {
-                    break;
-                }
+    ScopedTimer timer("visibility");
+    //This works on the buffer rather than the canvas, so that it doesn't
+    //matter how big the view is or how far it's zoomed out.
+    IntPoint origin = get_buffer_coords(chunk, coords);
+    BufferOpacity opacity = {&buffer_opaque, origin.row, origin.col};
+    shadowcast::compute(fov_radius, opacity, next_fov);
+
+    //Clearing a whole layer is only a few dozen words, so it's simpler to
+    //start every layer in the buffer over from dark than to work out which
+    //tiles went out of view.  Layers outside of the buffer can keep stale
+    //bits, since update_buffer() always brings them back in through here.
+    for(size_t i = 0; i < buffer_visible.size(); i++) {
+        if(buffer_visible[i] != NULL) {
+            buffer_visible[i]->clear();
+        }
+    }
+    for(int i = -fov_radius; i <= fov_radius; i++) {
+        for(int j = -fov_radius; j <= fov_radius; j++) {
+            int row = origin.row + i;
+            int col = origin.col + j;
+            int plane = buffer_plane_index(row, col);
+            if(plane >= 0 && buffer_visible[plane] != NULL && next_fov.test(i, j)) {
+                buffer_visible[plane]->set(row % CHUNK_HEIGHT, col % CHUNK_WIDTH);
+                buffer_explored[plane]->set(row % CHUNK_HEIGHT, col % CHUNK_WIDTH);
             }
         }
     }
+
+    //If the old field of view was on another layer, none of it counts.
+    bool compare = fov_valid && depth == fov_depth;
+    IntPoint old_origin = get_buffer_coords(fov_chunk, fov_coords);
+    bool changed = !compare || !(origin == old_origin) || next_fov != player_fov;
+    std::swap(player_fov, next_fov);
+    fov_chunk = chunk;
+    fov_coords = coords;
+    fov_depth = depth;
+    fov_valid = true;
+    if(changed) {
+        visibility_generation++;
+    }
 }
 
+bool Game::in_fov(IntPoint canvas_coords) {
+    int row = canvas_top + canvas_coords.row * zoom;
+    int col = canvas_left + canvas_coords.col * zoom;
+    int plane = buffer_plane_index(row, col);
+    return plane >= 0 && buffer_visible[plane] != NULL &&
+        buffer_visible[plane]->test(row % CHUNK_HEIGHT, col % CHUNK_WIDTH);
+}
 
+bool Game::is_explored(IntPoint canvas_coords) {
+    int row = canvas_top + canvas_coords.row * zoom;
+    int col = canvas_left + canvas_coords.col * zoom;
+    int plane = buffer_plane_index(row, col);
+    return plane >= 0 && buffer_explored[plane] != NULL &&
+        buffer_explored[plane]->test(row % CHUNK_HEIGHT, col % CHUNK_WIDTH);
+}
@@ -22,7 +22,9 @@
 
 #include <vector>
 #include <unordered_map>
+#include <map>
 #include <string>
+#include <mutex>
 
 #include "chunk_matrix.h"
 #include "constants.h"
@@ -39,6 +41,12 @@
 #include "pathfinding.h"
 #include "message.h"
 #include "tileset.h"
+#include "shadowcast.h"
+#include "bit_grid.h"
+#include "flow_field.h"
+#include "route_planner.h"
+#include "path_queue.h"
+#include "population_model.h"
 
 //Forward declarations
 struct Tile;
@@ -50,12 +58,93 @@ class Spawner;
 class Den;
 class Plant;
 
+/**
+ * Something that an AI character decided to do to the world, held back
+ * until every character has decided.
+ * @see Game::set_deciding
+ */
+struct AICommand
+{
+    enum Kind
+    {
+        MOVE,
+        ATTACK
+    };
+
+    Kind kind;
+    Character* chara;
+
+    /**
+     * How far to move, for MOVE.
+     */
+    IntPoint step;
+
+    /**
+     * Who to hit, for ATTACK.
+     */
+    Character* target;
+};
+
+/**
+ * Everything a thread needs of its own to decide characters' turns: where
+ * their commands go, the scratch space for looking around, and the random
+ * numbers of the character it's deciding for.
+ */
+struct DecideContext
+{
+    std::vector<AICommand> commands;
+    std::vector<unsigned char> sight_scratch;
+    std::vector<Character*> characters_seen;
+
+    /**
+     * The seed that wander() takes its random numbers from.
+     */
+    unsigned int* random;
+
+    /**
+     * Set if anything decided would change what gets drawn.
+     */
+    bool changed;
+
+    DecideContext()
+    {
+        random = NULL;
+        changed = false;
+    }
+};
+
+/**
+ * How closely the AI looks after a character.
+ * @see Game::ai_detail
+ */
+enum AI_DETAIL
+{
+    AI_FULL,
+    AI_COARSE
+};
+
+class Game;
+namespace benchmark
+{
+    std::string route(Game* game);
+    std::string behavior(Game* game);
+    std::string decide(Game* game);
+    std::string crowd(Game* game);
+}
+
 class Game
 {
     typedef std::vector<std::vector<Tile> > TileMatrix;
     typedef std::vector<std::vector<Tile*> > TilePointerMatrix;
     typedef std::vector<std::vector<MapTile> > MapTileMatrix;
 
+    //Needs the world map to load chunks of its own.
+    friend std::string benchmark::route(Game* game);
+    //Puts its actors straight into the buffer, and takes them out again.
+    friend std::string benchmark::behavior(Game* game);
+    friend std::string benchmark::decide(Game* game);
+    friend std::string benchmark::crowd(Game* game);
+
     private:
 
 
@@ -88,9 +177,53 @@ class Game
         WorldMap world_map;
 
         /**
-         * The list of points which correspond to visible tiles.
+         * The tiles that the main character can see, relative to where they
+         * were standing when it was worked out (fov_chunk, fov_coords and
+         * fov_depth).  It's used to tell whether anything changed; the
+         * chunk layers' visible and explored planes are what gets drawn.
+         */
+        VisibleSet player_fov;
+
+        /**
+         * Where the next field of view gets worked out, so it can be
+         * compared against the last one.
+         */
+        VisibleSet next_fov;
+
+        /**
+         * How far the main character can see.
+         */
+        int fov_radius;
+
+        IntPoint fov_chunk;
+        IntPoint fov_coords;
+        int fov_depth;
+
+        /**
+         * False when player_fov can't be trusted any more, because a tile
+         * that blocks light (or stops blocking it) changed nearby, or the
+         * buffer was rebuilt.
          */
-        std::vector<std::vector<IntPoint> > bresenham_lines;
+        bool fov_valid;
+
+        /**
+         * Goes up by one every time player_fov changes.
+         */
+        unsigned long visibility_generation;
+
+        /**
+         * Makes the next update_visibility() work out the field of view
+         * again, even if the main character hasn't moved.
+         */
+        void invalidate_visibility();
+
+        /**
+         * Goes up by one every time something changes that could change
+         * what gets drawn (tiles in the buffer, characters moving,
+         * animations, etc.).  If it hasn't changed since the last frame,
+         * then there's no reason to refresh or redraw.
+         */
+        unsigned long generation;
 
 //--------------------------------------BUFFER DATA/PRIVATE METHODS----------------------------------------//
 //src/controller/buffer_controller.cpp
@@ -107,6 +240,49 @@ class Game
          */
         TilePointerMatrix buffer;
 
+        /**
+         * One bit for every tile of the buffer: whether it blocks light,
+         * and whether it can be moved through.  They're kept in step with
+         * the buffer by set_buffer_tile(), so anything that only needs to
+         * know about walls can look at 64 tiles at a time without going
+         * through the Tile pointers.
+         */
+        BitGrid buffer_opaque;
+        BitGrid buffer_passable;
+
+        /**
+         * Points a spot in the buffer at a tile, and updates the opacity
+         * and passability bits to match.  Every write to the buffer should
+         * go through here.
+         */
+        void set_buffer_tile(int row, int col, Tile* tile);
+
+        /**
+         * Goes up every time a tile of the buffer changes whether it can
+         * be moved through, so that maps built from buffer_passable can
+         * tell when they're out of date.
+         */
+        unsigned long passable_version;
+
+        /**
+         * How many chunks the buffer reaches out from the main character's
+         * chunk in every direction.  1 means a 3x3 buffer of chunks.  It
+         * grows when the view needs more room than that.
+         */
+        int buffer_radius;
+
+        /**
+         * Works out how many chunks the buffer has to reach out from the
+         * main character's chunk for the whole view to fit inside of it.
+         */
+        int required_buffer_radius();
+
+        /**
+         * Grows the chunk map, buffer and character index so that the view
+         * fits, and then refills the buffer.
+         */
+        void resize_buffer();
+
         /**
          * Converts coordinates in the form of (chunk, coords) to coordinates relative to
          * the top left of the buffer.
@@ -124,18 +300,193 @@ class Game
          */
         bool coords_in_buffer(int row, int col);
 
+        /**
+         * The explored and visible planes of the layer that each chunk of
+         * the buffer shows, a row of chunks at a time, or NULL where the
+         * chunk doesn't go down that far.  Filled in by update_buffer().
+         */
+        std::vector<Bitplane*> buffer_explored;
+        std::vector<Bitplane*> buffer_visible;
+
+        /**
+         * Which entry of buffer_explored and buffer_visible covers the
+         * given buffer coordinates, or -1 if they're outside of the buffer.
+         */
+        int buffer_plane_index(int row, int col);
+
+        /**
+         * Tells the shadowcaster and sight cones which tiles of the buffer
+         * block light, relative to (row, col) in the buffer.  Anything
+         * outside of the buffer counts as a wall.
+         */
+        struct BufferOpacity
+        {
+            const BitGrid* opaque;
+            int row;
+            int col;
+
+            bool operator()(int row_rel, int col_rel) const
+            {
+                int r = row + row_rel;
+                int c = col + col_rel;
+                return !opaque->in_bounds(r, c) || opaque->test(r, c);
+            }
+        };
+
 
 //------------------------------CHARACTER DATA/PRIVATE METHODS------------------//
 //src/controller/character_controller.cpp
         /**
-         * The list of characters in the game.
+         * The list of characters in the game, in no particular order.
          */
         std::vector<Character*> character_list;
 
         /**
-         * A two dimensional matrix to hold characters.
+         * Where each character is in character_list, by the index of its
+         * handle, so that it can be taken out without looking for it.
+         */
+        std::vector<int> character_places;
+
+        /**
+         * A two dimensional matrix to hold characters.  Characters that
+         * have been deleted aren't found, even if their square wasn't
+         * cleared.
+         */
+        std::vector<std::vector<CharacterHandle> > character_index;
+
+        /**
+         * Adds a character to the end of character_list.
+         */
+        void list_character(Character* chara);
+
+        /**
+         * Takes a character out of character_list by moving the last one
+         * into its place.
+         */
+        void unlist_character(Character* chara);
+
+        /**
+         * Scratch space for walking sight cones and collecting the
+         * characters found in them, kept around so that target searches
+         * don't allocate.
+         */
+        std::vector<unsigned char> sight_scratch;
+        std::vector<Character*> characters_seen;
+
+        /**
+         * Finds the paths for move_to_point() on worker threads.
+         */
+        PathQueue path_queue;
+
+        /**
+         * The path a character is following, and the one it's waiting on.
+         * Paths are in buffer coordinates, so they're all thrown out when
+         * the buffer moves.
+         */
+        struct PathPlan
+        {
+            IntPoint goal;
+            std::vector<IntPoint> path;
+
+            /**
+             * Set if there was no way to the goal, so that it isn't asked
+             * for again until the terrain changes.
+             */
+            bool failed;
+            unsigned long version;
+
+            /**
+             * The ticket of the request that's out, or 0 if there isn't
+             * one, and the goal it was for.
+             */
+            unsigned long ticket;
+            IntPoint pending_goal;
+        };
+
+        std::map<Character*, PathPlan> path_plans;
+        std::map<unsigned long, Character*> path_tickets;
+
+        /**
+         * The next step along a character's plan.  Asks for a new plan if
+         * the goal has moved or the character has wandered off of the
+         * old one, and keeps following the old one (or if there isn't one,
+         * heads straight for the goal) until the new one comes in.
+         */
+        IntPoint next_planned_step(Character* chara, IntPoint current, IntPoint goal, int radius);
+
+        /**
+         * Forgets a character's plan, and any path it's waiting on.
          */
-        std::vector<std::vector<Character*> > character_index;
+        void forget_plan(Character* chara);
+
+        /**
+         * A map toward a target, and the passable_version it was built
+         * from.
+         */
+        struct CachedFlowField
+        {
+            FlowField field;
+            unsigned long version;
+        };
+
+        /**
+         * One map for every character that somebody is chasing or running
+         * from, keyed by the character and its depth.  They're in buffer
+         * coordinates, so they're all thrown out when the buffer moves.
+         */
+        std::map<std::pair<Character*, int>, CachedFlowField> flow_fields;
+
+        /**
+         * The map toward a character, built or rebuilt if the character
+         * moved or the terrain changed since it was last used.  NULL if
+         * the character isn't in the buffer.
+         */
+        FlowField* flow_field_to(Character* target);
+
+        /**
+         * Plans routes for characters heading somewhere they can't see.
+         */
+        RoutePlanner route_planner;
+
+        /**
+         * A route that a character is following, and the chunk that its
+         * goal was in when it was planned.
+         */
+        struct CachedRoute
+        {
+            IntPoint goal_chunk;
+            std::vector<RouteStop> stops;
+            size_t next;
+        };
+
+        std::map<Character*, CachedRoute> routes;
+
+        /**
+         * Guards the plans, maps and routes above, and the route planner,
+         * while characters are deciding on more than one thread.
+         */
+        std::recursive_mutex plan_mutex;
+
+        /**
+         * Where the calling thread's commands go while it's deciding
+         * turns, or NULL if the world is changed straight away.
+         */
+        static thread_local DecideContext* deciding;
+
+        /**
+         * A random number from 0 to 32767, from the seed of the character
+         * being decided for if there is one, so that it doesn't depend on
+         * which thread got there first.
+         */
+        int ai_rand();
+
+        /**
+         * The next stop on the way to a point too far away for the
+         * character to see.  The route is planned again if the point has
+         * moved to another chunk.
+         * @return The stop, or NULL if there's no route.
+         */
+        const RouteStop* next_route_stop(Character* chara, IntPoint coords, IntPoint chunk);
 
 
 //-------------------------------CANVAS DATA/Private Methods--------------//
@@ -147,6 +498,26 @@ class Game
          */
         TilePointerMatrix canvas;
 
+        /**
+         * The size of the canvas, in characters on the screen.
+         */
+        int view_height;
+        int view_width;
+
+        /**
+         * How many tiles (in each direction) get squashed into one character
+         * on the canvas.  1 is normal, 2 shows a 2x2 block of tiles as a
+         * single character, etc.
+         */
+        int zoom;
+
+        /**
+         * The buffer coordinates that the top left character of the canvas
+         * was taken from, set by refresh().
+         */
+        int canvas_top;
+        int canvas_left;
+
 
         /**
          * Assertions to ensure that the current point is in the screen.
@@ -189,6 +560,21 @@ class Game
          */
         Item* item_at_coords(IntPoint, IntPoint, int);
 
+        /**
+         * The summaries of every chunk that has been in the buffer, so the
+         * maps can still show chunks that have since been unloaded.  Keyed
+         * by world_row * WORLD_WIDTH + world_col, with one summary for
+         * each layer of the chunk.
+         */
+        std::unordered_map<int, std::vector<ChunkSummary> > chunk_summaries;
+
+        /**
+         * Copies the summaries of the chunks in the buffer into
+         * chunk_summaries.  Only the blocks that changed since last time
+         * get summarized again.
+         */
+        void summarize_chunks();
+
 //-------------------------------SPAWNER DATA----------------------------//
 //src/controller/spawn_controller.cpp
 
@@ -198,6 +584,19 @@ class Game
          */
         std::vector<Character*> character_queue;
 
+        /**
+         * The characters that have wandered out of the buffer, kept by
+         * chunk until it's loaded again.
+         */
+        PopulationModel population;
+
+        /**
+         * Turns everyone in the population model that's in a chunk of the
+         * buffer, on the main character's layer, back into enemies.
+         * Anybody that there's no room for stays in the model.
+         */
+        void populate_buffer();
+
 
 //------------------------------ANIMATION DATA---------------------------//
 //src/controller/animation_controller.cpp
@@ -273,6 +672,18 @@ class Game
          */
         void toggle_pause();
 
+        /**
+         * Marks the world as changed, so that the next frame will be
+         * refreshed and redrawn.
+         */
+        void bump_generation();
+
+        /**
+         * Returns the world's generation counter.
+         * @see generation
+         */
+        unsigned long get_generation();
+
         /**
          * Determines whether the visibility should be on or off.
          * For debuggin purposes.
@@ -281,27 +692,42 @@ class Game
 
         /**
          * Updates the visible portions of the game (dumps parts of the
-         * buffer into the canvas), and redraws visibility lines.
+         * buffer into the canvas), and updates the field of view.
          * Gets called when the main character moves.
          */
         void refresh();
 
         /**
-         * Sets tiles that are a part of the "bresenham_lines" to visible.
+         * Works out what the main character can see with shadowcasting, if
+         * they've moved or something that blocks light has changed since
+         * the last time.  The visible planes of the layers in the buffer
+         * are redrawn, and everything visible is marked as explored.
+         */
+        void update_visibility();
+
+        /**
+         * Returns whether the main character can see the tile at the given
+         * canvas coordinates.
          */
-        void draw_visibility_lines();
+        bool in_fov(IntPoint canvas_coords);
 
         /**
-         * Sets the tiles that are in the bresenham_lines to non-visible
-         * (visible = false).
+         * Returns whether the main character has ever seen the tile at the
+         * given canvas coordinates.
          */
-        void undo_visibility();
+        bool is_explored(IntPoint canvas_coords);
 
         /**
-         * Rewrites the points that should be made visible, based on
-         * the location of the character.
+         * Returns a counter that goes up whenever what the main character
+         * can see changes, so the renderer can tell if it needs to draw.
          */
-        void recalculate_visibility_lines(int radius);
+        unsigned long get_visibility_generation();
+
+        /**
+         * Changes how far the main character can see.  Takes effect the
+         * next time the visibility is drawn.
+         */
+        void set_visibility_radius(int radius);
 
 //-----------------------------------BUFFER PUBLIC METHODS----------------//
 //src/controller/buffer_controller.cpp
@@ -383,12 +809,6 @@ class Game
          */
         void remove_index_char(Character* chara);
 
-        /**
-         * Iterates through every character in the game.  If the character
-         * is targetting enem, then the target becomes NULL.
-         */
-        void remove_targets(Character* enem);
-
         /**
          * Returns a reference to the 1D vector containing all characters.
          */
@@ -406,35 +826,104 @@ class Game
          * character to find the target for and a list of possible
          * characters.
          */
-        Character* normal_target(Character* chara, std::vector<Character*> characters);
+        Character* normal_target(Character* chara, const std::vector<Character*>& characters);
 
         /**
          * Gets the best target for a passive character.  Takes in the
          * character to find the target for and a list of possible
          * characters.
          */
-        Character* passive_target(Character* chara, std::vector<Character*> characters);
+        Character* passive_target(Character* chara, const std::vector<Character*>& characters);
 
         /**
-         * Returns a list of all of the characters in range of the
-         * character passed into the function.
+         * Fills found with all of the characters that the character passed
+         * into the function can see, not counting itself.  Walls block
+         * its sight.  found is cleared first.
          */
-        std::vector<Character*> characters_in_range(Character* chara);
+        void characters_in_range(Character* chara, std::vector<Character*>& found);
+
+        /**
+         * Fills tiles with the coordinates (relative to the character's
+         * chunk) of every tile that the character can see, with walls
+         * blocking its sight.  tiles is cleared first.
+         */
+        void visible_sight_tiles(Character* chara, std::vector<IntPoint>& tiles);
 
 
         /**
-         * Uses pathfinding to get to the point.  Note: this could be
-         * a nightmare, as characters will currently only attempt to move
-         * to points they can see, but the pathfinding may take them on
-         * a very bizarre path involving the entire buffer.
+         * How closely the AI should look after a character.
+         * @return AI_FULL for characters within FULL_AI_RANGE of the main
+         * character, on its layer, and AI_COARSE for everyone else.
+         */
+        int ai_detail(Character* chara);
+
+        /**
+         * Uses pathfinding to get to the point.  Points that are further
+         * away than the character can see are reached by following a route
+         * through the portals of the chunks in between.
          */
         int move_to_point(Character* chara, IntPoint coords, IntPoint chunk);
 
+        /**
+         * Takes a step straight toward a point, going around anything
+         * in the way only if there's an open tile right next to it.  It's
+         * what characters far from the main character do instead of
+         * finding a path.
+         * @return The same as move_to_point().
+         */
+        int move_coarse(Character* chara, IntPoint coords, IntPoint chunk);
+
         /**
          * Causes the enemy to try to run away from its current target.
          */
         int run_away(Character* chara, IntPoint coords, IntPoint chunk);
 
+        /**
+         * Moves a character a step toward another, using the map shared by
+         * everybody going after the same character.  Falls back to
+         * move_to_point() if the map doesn't reach.
+         * @return The same as move_to_point().
+         */
+        int move_towards(Character* chara, Character* target);
+
+        /**
+         * Moves a character a step away from another, using the running
+         * away version of the shared map.  Falls back to run_away() if the
+         * map doesn't reach.
+         */
+        int move_away(Character* chara, Character* target);
+
+        /**
+         * Hands the paths that the workers have finished to the characters
+         * that asked for them.  Called once a frame, before the AI runs.
+         */
+        void collect_paths();
+
+        /**
+         * Sends off the paths asked for since the last batch.  Called once
+         * a frame, after the AI runs, so that the workers can search while
+         * the frame is drawn.
+         */
+        void dispatch_paths();
+
+        /**
+         * Sends the calling thread into or out of deciding.  While a
+         * thread is deciding, the world is read-only to it: move_char()
+         * and attack_char() only check that they would work, and leave a
+         * command in the context for apply_command() to carry out later,
+         * and anything that would have marked the world as changed sets
+         * the context's flag instead.
+         * @param context The thread's context, or NULL to stop deciding.
+         */
+        static void set_deciding(DecideContext* context);
+
+        /**
+         * Carries out a command that was decided on.  A move into a tile
+         * that somebody else has taken since is dropped, and the
+         * character is interrupted with INTERRUPT_BLOCKED.
+         */
+        void apply_command(const AICommand& command);
+
         /**
          * Causes a character to wander listlessly.
          */
@@ -562,6 +1051,25 @@ class Game
          */
         const std::vector<std::vector<Tile*> >& get_canvas();
 
+        /**
+         * Changes the size of the canvas and how zoomed out it is.  The
+         * buffer grows if the new view doesn't fit inside of it.
+         * @param height The number of rows in the canvas.
+         * @param width The number of columns in the canvas.
+         * @param _zoom The number of tiles in each direction per character.
+         */
+        void set_view(int height, int width, int _zoom);
+
+        /**
+         * Returns the size of the canvas as (rows, columns).
+         */
+        IntPoint get_view_size();
+
+        /**
+         * Returns the number of tiles per character in each direction.
+         */
+        int get_zoom();
+
 //-----------------------------CHUNK_MAP PUBLIC METHODS------------------//
 //src/controller/chunkmap_controller.cpp
 
@@ -580,6 +1088,25 @@ class Game
          */
         Plant* get_plant(IntPoint chunk, IntPoint coords, int depth);
 
+        /**
+         * Returns the summary of a layer of the chunk at the given world
+         * coordinates, or NULL if that chunk hasn't been loaded yet.
+         */
+        const ChunkSummary* get_chunk_summary(IntPoint world_chunk, int depth);
+
+        /**
+         * Returns which tiles of a layer of the chunk at the given world
+         * coordinates have been seen, or NULL if the chunk isn't in the
+         * buffer.  Chunks outside of the buffer aren't kept, so neither is
+         * what was seen of them.
+         */
+        const Bitplane* get_explored(IntPoint world_chunk, int depth);
+
+        /**
+         * Returns the world map that the game was started on.
+         */
+        const MapTileMatrix& get_world_map();
+
 //-------------------------------ANIMATION PUBLIC METHODS----------------//
 //src/controller/animation_controller.cpp
 
@@ -625,6 +1152,20 @@ class Game
          */
         void add_character(Character* character, IntPoint chunk);
 
+        /**
+         * Takes a character that has left the buffer out of the game, and
+         * puts it in the population model of the chunk it was in.
+         * Characters that aren't one of the kinds of enemies are just
+         * removed.  DOES NOT
+         * DELETE THE POINTER.
+         */
+        void leave_world(Character* chara);
+
+        /**
+         * The characters in chunks that aren't loaded.
+         */
+        const PopulationModel& get_population();
+
 //-------------------------------DEBUG PUBLIC METHODS--------------------//
 //src/controller/debug_controller.cpp
         /**
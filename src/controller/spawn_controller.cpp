@@ -19,13 +19,28 @@
 
 #include "game.h"
 
+namespace
+{
+    const int NUM_ENEMY_TYPES = 4;
+
+    /**
+     * Every EnemyType, since ENEMY_LIST doesn't have all of them.
+     */
+    const EnemyType* enemy_types()
+    {
+        static EnemyType types[NUM_ENEMY_TYPES] = {enemies::kobold, enemies::rabbit,
+            enemies::wolf_companion, enemies::human};
+        return types;
+    }
+}
+
 void Game::run_spawners() {
     std::vector<Spawner>* spawners;
     Chunk* chunk;
     IntPoint chunk_coords;
     int accum = 0;
-    for(int i=main_char.get_chunk().row-1;i<=main_char.get_chunk().row+1;i++) {
-        for(int j=main_char.get_chunk().col-1;j<=main_char.get_chunk().col+1;j++) {
+    for(int i=main_char.get_chunk().row - buffer_radius;i<=main_char.get_chunk().row + buffer_radius;i++) {
+        for(int j=main_char.get_chunk().col - buffer_radius;j<=main_char.get_chunk().col + buffer_radius;j++) {
             chunk = chunk_map.get_chunk_abs(IntPoint(i, j));
 
             if(chunk->get_depth()>main_char.get_depth() && chunk->get_type().does_spawn) {
@@ -55,7 +70,77 @@ std::vector<Character*> Game::flush_characters()
 void Game::add_character(Character* character, IntPoint chunk)
 {
     character->set_chunk(chunk);
-    character_list.push_back(character);
+    list_character(character);
     character_queue.push_back(character);
     character_to_index(character);
+    bump_generation();
+}
+
+void Game::leave_world(Character* chara)
+{
+    //Characters don't know their EnemyType, but every type has its own
+    //name.
+    IntPoint chunk = chara->get_chunk();
+    bool on_world = chunk.row >= 0 && chunk.col >= 0 && chunk.row < WORLD_HEIGHT && chunk.col < WORLD_WIDTH;
+    for(int i=0;i<NUM_ENEMY_TYPES && on_world;i++)
+    {
+        if(enemy_types()[i].name == chara->get_name())
+        {
+            population.add(chunk, chara->get_depth(), i);
+            break;
+        }
+    }
+    remove_enemy(chara);
+}
+
+const PopulationModel& Game::get_population()
+{
+    return population;
+}
+
+void Game::populate_buffer()
+{
+    int depth = main_char.get_depth();
+    std::vector<int> types;
+    std::vector<int> no_room;
+    for(int i=main_char.get_chunk().row - buffer_radius;i<=main_char.get_chunk().row + buffer_radius;i++)
+    {
+        for(int j=main_char.get_chunk().col - buffer_radius;j<=main_char.get_chunk().col + buffer_radius;j++)
+        {
+            if(i < 0 || j < 0 || i >= WORLD_HEIGHT || j >= WORLD_WIDTH)
+            {
+                continue;
+            }
+            IntPoint chunk = IntPoint(i, j);
+            population.take(chunk, depth, types);
+            no_room.clear();
+            for(int t=0;t<types.size();t++)
+            {
+                const EnemyType& type = enemy_types()[types[t]];
+
+                //A few tries at an open spot, and if there isn't one the
+                //character waits for the next time the chunk is loaded.
+                bool placed = false;
+                for(int tries=0;tries<20 && !placed;tries++)
+                {
+                    IntPoint coords = IntPoint(rand() % CHUNK_HEIGHT, rand() % CHUNK_WIDTH);
+                    IntPoint buffer_coords = get_buffer_coords(chunk, coords);
+                    if(buffer_passable.test(buffer_coords.row, buffer_coords.col) &&
+                            character_at_loc(chunk, coords) == NULL)
+                    {
+                        add_character(new Enemy(coords.col, coords.row, depth, type), chunk);
+                        placed = true;
+                    }
+                }
+                if(!placed)
+                {
+                    no_room.push_back(types[t]);
+                }
+            }
+            for(int t=0;t<no_room.size();t++)
+            {
+                population.add(chunk, depth, no_room[t]);
+            }
+        }
+    }
 }
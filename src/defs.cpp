@@ -42,47 +42,47 @@ int get_part_hit(int chance)
 /****************************
  *   TERRAIN DEFS
  ***************************/
-//{int char_count, int tile_id, int color, bool can_be_moved_through, bool visible, bool opaque, bool seen, bool can_build_overtop}
+//{int char_count, int tile_id, int color, bool can_be_moved_through, bool opaque, bool can_build_overtop}
 namespace tiledef {
-    Tile  EMPTY           =  {0,    0,   0,             1,  0,  0,  0,  0};
-    Tile  OVERWORLD_DIRT  =  {250,  1,   BROWN,         1,  0,  0,  0,  1};
-    Tile  DIRT            =  {250,  2,   BROWN,         1,  0,  0,  0,  1};
-    Tile  DUNGEON_BORDER  =  {250,  3,   DARK_RED,      0,  1,  0,  0,  0};
-    Tile  ROOM_WALL       =  {219,  4,   GRAY,          0,  0,  1,  0,  0};
-    Tile  PATH            =  {250,  5,   BROWN,         1,  0,  0,  0,  1};
-    Tile  MAIN_CHAR       =  {1,    6,   DARK_RED,      1,  1,  0,  0,  0};
-    Tile  MAIN_CHAR2      =  {1,    7,   DARKER_GREEN,  1,  1,  0,  0,  0};
-    Tile  MAIN_CHAR3      =  {1,    8,   BROWN,         1,  1,  0,  0,  0};
-    Tile  MAIN_CHAR4      =  {1,    9,   GRAY,          1,  1,  0,  0,  0};
-    Tile  TREE            =  {84,   10,  DARK_GREEN,    0,  0,  1,  0,  0};
-    Tile  BLOCK_WALL      =  {219,  11,  GRAY,          0,  0,  1,  0,  0};
-    Tile  DOWN_STAIR      =  {31,   12,  GRAY,          1,  0,  0,  0,  0};
-    Tile  UP_STAIR        =  {30,   13,  GRAY,          1,  0,  0,  0,  0};
-    Tile  KOBOLD          =  {107,  14,  DARK_GREEN,    0,  1,  0,  0,  0};
-    Tile  KOBOLD_SPAWNER  =  {21,   15,  GREEN,         0,  0,  1,  0,  0};
-    Tile  WATER           =  {247,  16,  BLUE,          0,  0,  0,  0,  0};
-    Tile  LIGHT_WATER     =  {126,  17,  BLUE,          0,  0,  0,  0,  0};
-    Tile  SAND1           =  {176,  18,  TAN,           1,  0,  0,  0,  1};
-    Tile  SAND2           =  {178,  19,  TAN,           1,  0,  0,  0,  1};
-    Tile  BIG_TREE        =  {116,  20,  DARK_GREEN,    0,  0,  1,  0,  0};
-    Tile  GRASS_DIRT      =  {250,  21,  DARKER_GREEN,  1,  0,  0,  0,  1};
-    Tile  KOBOLD_CORPSE   =  {107,  22,  GRAY,          1,  0,  0,  0,  0};
-    Tile  BOOTS           =  {28,   23,  BROWN,         1,  0,  0,  0,  0};
-    Tile  RABBIT          =  {114,  24,  BROWN,         0,  1,  0,  0,  0};
-    Tile  RABBIT_CORPSE   =  {114,  25,  GRAY,          1,  0,  0,  0,  0};
-    Tile  SWORD           =  {47,   26,  GRAY,          1,  0,  0,  0,  0};
-    Tile  POTATO          =  {7,    27,  BROWN,         1,  0,  0,  0,  0};
-    Tile  PLANT           =  {6,    28,  GREEN,         1,  0,  0,  0,  0};
-    Tile  WOOD_WALL       =  {176,  29,  BROWN,         0,  0,  1,  0,  0};
-    Tile  WOOD_FLOOR      =  {47,   30,  BROWN,         1,  0,  0,  0,  0};
-    Tile  DOOR            =  {43,   31,  BROWN,         1,  0,  1,  0,  0};
-    Tile  BURROW          =  {15,   32,  BROWN,         1,  0,  0,  0,  0};
-    Tile  HUT_WALL        =  {35,   33,  BROWN,         0,  0,  1,  0,  0};
-    Tile  AXE             =  {213,  34,  GRAY,          1,  0,  0,  0,  0};
-    Tile  LOG             =  {220,  35,  BROWN,         1,  0,  0,  0,  0};
-    Tile  WOLF            =  {119,  36,  BROWN,         1,  0,  0,  0,  0};
-    Tile  HUMAN           =  {104,  37,  TAN,           1,  0,  0,  0,  0};
-    Tile  COBBLE          =  {42,   38,  GRAY,          1,  0,  0,  0,  0};
+    Tile  EMPTY           =  {0,    0,   0,             1,  0,  0};
+    Tile  OVERWORLD_DIRT  =  {250,  1,   BROWN,         1,  0,  1};
+    Tile  DIRT            =  {250,  2,   BROWN,         1,  0,  1};
+    Tile  DUNGEON_BORDER  =  {250,  3,   DARK_RED,      0,  0,  0};
+    Tile  ROOM_WALL       =  {219,  4,   GRAY,          0,  1,  0};
+    Tile  PATH            =  {250,  5,   BROWN,         1,  0,  1};
+    Tile  MAIN_CHAR       =  {1,    6,   DARK_RED,      1,  0,  0};
+    Tile  MAIN_CHAR2      =  {1,    7,   DARKER_GREEN,  1,  0,  0};
+    Tile  MAIN_CHAR3      =  {1,    8,   BROWN,         1,  0,  0};
+    Tile  MAIN_CHAR4      =  {1,    9,   GRAY,          1,  0,  0};
+    Tile  TREE            =  {84,   10,  DARK_GREEN,    0,  1,  0};
+    Tile  BLOCK_WALL      =  {219,  11,  GRAY,          0,  1,  0};
+    Tile  DOWN_STAIR      =  {31,   12,  GRAY,          1,  0,  0};
+    Tile  UP_STAIR        =  {30,   13,  GRAY,          1,  0,  0};
+    Tile  KOBOLD          =  {107,  14,  DARK_GREEN,    0,  0,  0};
+    Tile  KOBOLD_SPAWNER  =  {21,   15,  GREEN,         0,  1,  0};
+    Tile  WATER           =  {247,  16,  BLUE,          0,  0,  0};
+    Tile  LIGHT_WATER     =  {126,  17,  BLUE,          0,  0,  0};
+    Tile  SAND1           =  {176,  18,  TAN,           1,  0,  1};
+    Tile  SAND2           =  {178,  19,  TAN,           1,  0,  1};
+    Tile  BIG_TREE        =  {116,  20,  DARK_GREEN,    0,  1,  0};
+    Tile  GRASS_DIRT      =  {250,  21,  DARKER_GREEN,  1,  0,  1};
+    Tile  KOBOLD_CORPSE   =  {107,  22,  GRAY,          1,  0,  0};
+    Tile  BOOTS           =  {28,   23,  BROWN,         1,  0,  0};
+    Tile  RABBIT          =  {114,  24,  BROWN,         0,  0,  0};
+    Tile  RABBIT_CORPSE   =  {114,  25,  GRAY,          1,  0,  0};
+    Tile  SWORD           =  {47,   26,  GRAY,          1,  0,  0};
+    Tile  POTATO          =  {7,    27,  BROWN,         1,  0,  0};
+    Tile  PLANT           =  {6,    28,  GREEN,         1,  0,  0};
+    Tile  WOOD_WALL       =  {176,  29,  BROWN,         0,  1,  0};
+    Tile  WOOD_FLOOR      =  {47,   30,  BROWN,         1,  0,  0};
+    Tile  DOOR            =  {43,   31,  BROWN,         1,  1,  0};
+    Tile  BURROW          =  {15,   32,  BROWN,         1,  0,  0};
+    Tile  HUT_WALL        =  {35,   33,  BROWN,         0,  1,  0};
+    Tile  AXE             =  {213,  34,  GRAY,          1,  0,  0};
+    Tile  LOG             =  {220,  35,  BROWN,         1,  0,  0};
+    Tile  WOLF            =  {119,  36,  BROWN,         1,  0,  0};
+    Tile  HUMAN           =  {104,  37,  TAN,           1,  0,  0};
+    Tile  COBBLE          =  {42,   38,  GRAY,          1,  0,  0};
 
     Tile TILE_INDEX[TILE_TYPE_COUNT] = { //THIS MUST CORRESPOND TO TILE IDS
         EMPTY,          //ID 0
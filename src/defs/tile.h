@@ -49,13 +49,6 @@ struct Tile {
          */
         bool can_be_moved_through;
 
-        /**
-         * If the tile is currently visible.
-         * Tiles will be marked as visible if they can currently be seen by the
-         * main character.  Otherwise, this will be false.
-         */
-        bool visible;
-
         /**
          * True if light can pass through the tile.
          * This value is used by the lighting system to determine whether or not
@@ -63,14 +56,6 @@ struct Tile {
          */
         bool opaque;
 
-        /**
-         * True if the main character has, at some point, seen the tile.
-         * If this is true, then the tile will be grayed out when it is
-         * not visible.  Otherwise, a solid black rectangle will be rendered
-         * instead of the tile.
-         */
-        bool seen;
-
         /**
          * True if this tile is at the floor level - this is used to determine if a
          * spawner or stairs can be placed here.
@@ -0,0 +1,486 @@
+/**
+ *  ANSI_TERMINAL.CPP
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <iostream>
+#include <string.h>
+#include <unistd.h>
+#include <sys/select.h>
+#include <color_def.h>
+#include "ansi_terminal.h"
+
+/**
+ * The unicode code point of every character in code page 437, which is the
+ * layout that the bitmap fonts use.
+ */
+static const int CP437[256] = {
+    0x0020, 0x263A, 0x263B, 0x2665, 0x2666, 0x2663, 0x2660, 0x2022,
+    0x25D8, 0x25CB, 0x25D9, 0x2642, 0x2640, 0x266A, 0x266B, 0x263C,
+    0x25BA, 0x25C4, 0x2195, 0x203C, 0x00B6, 0x00A7, 0x25AC, 0x21A8,
+    0x2191, 0x2193, 0x2192, 0x2190, 0x221F, 0x2194, 0x25B2, 0x25BC,
+    0x0020, 0x0021, 0x0022, 0x0023, 0x0024, 0x0025, 0x0026, 0x0027,
+    0x0028, 0x0029, 0x002A, 0x002B, 0x002C, 0x002D, 0x002E, 0x002F,
+    0x0030, 0x0031, 0x0032, 0x0033, 0x0034, 0x0035, 0x0036, 0x0037,
+    0x0038, 0x0039, 0x003A, 0x003B, 0x003C, 0x003D, 0x003E, 0x003F,
+    0x0040, 0x0041, 0x0042, 0x0043, 0x0044, 0x0045, 0x0046, 0x0047,
+    0x0048, 0x0049, 0x004A, 0x004B, 0x004C, 0x004D, 0x004E, 0x004F,
+    0x0050, 0x0051, 0x0052, 0x0053, 0x0054, 0x0055, 0x0056, 0x0057,
+    0x0058, 0x0059, 0x005A, 0x005B, 0x005C, 0x005D, 0x005E, 0x005F,
+    0x0060, 0x0061, 0x0062, 0x0063, 0x0064, 0x0065, 0x0066, 0x0067,
+    0x0068, 0x0069, 0x006A, 0x006B, 0x006C, 0x006D, 0x006E, 0x006F,
+    0x0070, 0x0071, 0x0072, 0x0073, 0x0074, 0x0075, 0x0076, 0x0077,
+    0x0078, 0x0079, 0x007A, 0x007B, 0x007C, 0x007D, 0x007E, 0x2302,
+    0x00C7, 0x00FC, 0x00E9, 0x00E2, 0x00E4, 0x00E0, 0x00E5, 0x00E7,
+    0x00EA, 0x00EB, 0x00E8, 0x00EF, 0x00EE, 0x00EC, 0x00C4, 0x00C5,
+    0x00C9, 0x00E6, 0x00C6, 0x00F4, 0x00F6, 0x00F2, 0x00FB, 0x00F9,
+    0x00FF, 0x00D6, 0x00DC, 0x00A2, 0x00A3, 0x00A5, 0x20A7, 0x0192,
+    0x00E1, 0x00ED, 0x00F3, 0x00FA, 0x00F1, 0x00D1, 0x00AA, 0x00BA,
+    0x00BF, 0x2310, 0x00AC, 0x00BD, 0x00BC, 0x00A1, 0x00AB, 0x00BB,
+    0x2591, 0x2592, 0x2593, 0x2502, 0x2524, 0x2561, 0x2562, 0x2556,
+    0x2555, 0x2563, 0x2551, 0x2557, 0x255D, 0x255C, 0x255B, 0x2510,
+    0x2514, 0x2534, 0x252C, 0x251C, 0x2500, 0x253C, 0x255E, 0x255F,
+    0x255A, 0x2554, 0x2569, 0x2566, 0x2560, 0x2550, 0x256C, 0x2567,
+    0x2568, 0x2564, 0x2565, 0x2559, 0x2558, 0x2552, 0x2553, 0x256B,
+    0x256A, 0x2518, 0x250C, 0x2588, 0x2584, 0x258C, 0x2590, 0x2580,
+    0x03B1, 0x00DF, 0x0393, 0x03C0, 0x03A3, 0x03C3, 0x00B5, 0x03C4,
+    0x03A6, 0x0398, 0x03A9, 0x03B4, 0x221E, 0x03C6, 0x03B5, 0x2229,
+    0x2261, 0x00B1, 0x2265, 0x2264, 0x2320, 0x2321, 0x00F7, 0x2248,
+    0x00B0, 0x2219, 0x00B7, 0x221A, 0x207F, 0x00B2, 0x25A0, 0x00A0
+};
+
+/**
+ * The brightness of each step of the 6x6x6 color cube in the xterm-256
+ * palette.
+ */
+static const int CUBE_STEPS[6] = {0, 95, 135, 175, 215, 255};
+
+static std::string to_utf8(int code_point)
+{
+    std::string s;
+    if(code_point < 0x80)
+    {
+        s += (char) code_point;
+    }
+    else if(code_point < 0x800)
+    {
+        s += (char) (0xC0 | (code_point >> 6));
+        s += (char) (0x80 | (code_point & 0x3F));
+    }
+    else
+    {
+        s += (char) (0xE0 | (code_point >> 12));
+        s += (char) (0x80 | ((code_point >> 6) & 0x3F));
+        s += (char) (0x80 | (code_point & 0x3F));
+    }
+    return s;
+}
+
+static int nearest_cube_step(int value)
+{
+    int best = 0;
+    for(int i = 1; i < 6; i++)
+    {
+        if(abs(CUBE_STEPS[i] - value) < abs(CUBE_STEPS[best] - value))
+        {
+            best = i;
+        }
+    }
+    return best;
+}
+
+static int color_distance(int r1, int g1, int b1, int r2, int g2, int b2)
+{
+    return (r1 - r2) * (r1 - r2) + (g1 - g2) * (g1 - g2) + (b1 - b2) * (b1 - b2);
+}
+
+bool AnsiTerminal::Cell::operator==(const Cell& other) const
+{
+    return chr == other.chr && fg == other.fg && bg == other.bg;
+}
+
+bool AnsiTerminal::Cell::operator!=(const Cell& other) const
+{
+    return !(*this == other);
+}
+
+AnsiTerminal::AnsiTerminal(int _width, int _height)
+{
+    width = _width;
+    height = _height;
+    raw_mode = false;
+    input_closed = false;
+    old_cout = NULL;
+    last_frame_bytes = 0;
+    memset(keystate, 0, sizeof(keystate));
+
+    Cell blank = {' ', BLACK, BLACK};
+    back = std::vector<Cell>(width * height, blank);
+    front = back;
+
+    for(int i = 0; i < 256; i++)
+    {
+        glyphs.push_back(to_utf8(CP437[i]));
+    }
+}
+
+AnsiTerminal::~AnsiTerminal()
+{
+    close();
+}
+
+void AnsiTerminal::open()
+{
+    if(!raw_mode && isatty(STDIN_FILENO))
+    {
+        tcgetattr(STDIN_FILENO, &old_settings);
+        struct termios raw = old_settings;
+        //No line buffering, no echo, and ctrl-c comes to us as a key so
+        //that the terminal always gets put back.
+        raw.c_lflag &= ~(ICANON | ECHO | ISIG);
+        raw.c_iflag &= ~(IXON | ICRNL);
+        raw.c_cc[VMIN] = 0;
+        raw.c_cc[VTIME] = 0;
+        tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+        raw_mode = true;
+    }
+
+    //Anything the rest of the game prints would end up in the middle of
+    //the screen, so send it to stderr instead.
+    old_cout = std::cout.rdbuf(std::cerr.rdbuf());
+
+    //Hide the cursor, set a black background and clear the screen.  After
+    //that, the terminal is showing nothing but blanks.
+    std::string init = "\x1b[?25l\x1b[0m\x1b[48;5;16m\x1b[2J";
+    write(STDOUT_FILENO, init.c_str(), init.size());
+    Cell blank = {' ', BLACK, BLACK};
+    front = std::vector<Cell>(width * height, blank);
+}
+
+void AnsiTerminal::close()
+{
+    if(raw_mode)
+    {
+        tcsetattr(STDIN_FILENO, TCSANOW, &old_settings);
+        raw_mode = false;
+
+        std::string reset = "\x1b[0m\x1b[2J\x1b[H\x1b[?25h";
+        write(STDOUT_FILENO, reset.c_str(), reset.size());
+    }
+    if(old_cout != NULL)
+    {
+        std::cout.rdbuf(old_cout);
+        old_cout = NULL;
+    }
+}
+
+int AnsiTerminal::palette_index(Uint32 color)
+{
+    std::unordered_map<Uint32, int>::iterator it = palette_cache.find(color);
+    if(it != palette_cache.end())
+    {
+        return it->second;
+    }
+
+    int r = (color >> 16) & 0xFF;
+    int g = (color >> 8) & 0xFF;
+    int b = color & 0xFF;
+
+    //Try the closest color in the cube and the closest gray, and keep
+    //whichever is nearer.
+    int cr = nearest_cube_step(r);
+    int cg = nearest_cube_step(g);
+    int cb = nearest_cube_step(b);
+    int cube = 16 + 36 * cr + 6 * cg + cb;
+    int cube_distance = color_distance(r, g, b, CUBE_STEPS[cr], CUBE_STEPS[cg], CUBE_STEPS[cb]);
+
+    int average = (r + g + b) / 3;
+    int gray_step = std::min(23, std::max(0, (average - 3) / 10));
+    int gray_value = 8 + 10 * gray_step;
+    int gray_distance = color_distance(r, g, b, gray_value, gray_value, gray_value);
+
+    int index = gray_distance < cube_distance ? 232 + gray_step : cube;
+    palette_cache[color] = index;
+    return index;
+}
+
+void AnsiTerminal::draw_chr(int x, int y, int chr, Uint32 color)
+{
+    if(x < 0 || x >= width || y < 0 || y >= height)
+    {
+        return;
+    }
+
+    //Only the low 24 bits are the color.
+    color &= 0xFFFFFF;
+    chr &= 0xFF;
+
+    Cell cell;
+    if(color == BLACK || chr == 0 || chr == ' ')
+    {
+        cell.chr = ' ';
+        cell.fg = BLACK;
+    }
+    else
+    {
+        cell.chr = chr;
+        cell.fg = color;
+    }
+    cell.bg = BLACK;
+    back[y * width + x] = cell;
+}
+
+void AnsiTerminal::clear_area(int x, int y, int _height, int _width, Uint32 color)
+{
+    Cell blank = {' ', BLACK, color & 0xFFFFFF};
+    for(int row = std::max(0, y); row < std::min(height, y + _height); row++)
+    {
+        for(int col = std::max(0, x); col < std::min(width, x + _width); col++)
+        {
+            back[row * width + col] = blank;
+        }
+    }
+}
+
+void AnsiTerminal::flip()
+{
+    std::string out;
+    char sequence[32];
+
+    //Where the terminal's cursor is, and what colors it's drawing with.
+    //-1 means that we don't know, so the first cell always sets them.
+    int cursor_x = -1;
+    int cursor_y = -1;
+    long current_fg = -1;
+    long current_bg = -1;
+
+    for(int y = 0; y < height; y++)
+    {
+        for(int x = 0; x < width; x++)
+        {
+            int i = y * width + x;
+            if(back[i] == front[i])
+            {
+                continue;
+            }
+
+            if(cursor_x != x || cursor_y != y)
+            {
+                snprintf(sequence, sizeof(sequence), "\x1b[%d;%dH", y + 1, x + 1);
+                out += sequence;
+            }
+
+            //A blank doesn't care what the foreground color is.
+            if(back[i].chr != ' ' && back[i].fg != current_fg)
+            {
+                snprintf(sequence, sizeof(sequence), "\x1b[38;5;%dm", palette_index(back[i].fg));
+                out += sequence;
+                current_fg = back[i].fg;
+            }
+            if(back[i].bg != current_bg)
+            {
+                snprintf(sequence, sizeof(sequence), "\x1b[48;5;%dm", palette_index(back[i].bg));
+                out += sequence;
+                current_bg = back[i].bg;
+            }
+
+            out += glyphs[back[i].chr];
+            front[i] = back[i];
+            cursor_x = x + 1;
+            cursor_y = y;
+        }
+    }
+
+    size_t written = 0;
+    while(written < out.size())
+    {
+        ssize_t result = write(STDOUT_FILENO, out.c_str() + written, out.size() - written);
+        if(result <= 0)
+        {
+            break;
+        }
+        written += result;
+    }
+    last_frame_bytes = out.size();
+}
+
+void AnsiTerminal::invalidate()
+{
+    //Nothing will ever be drawn with a character of -1, so every cell will
+    //look like it changed.
+    Cell unknown = {-1, BLACK, BLACK};
+    for(size_t i = 0; i < front.size(); i++)
+    {
+        front[i] = unknown;
+    }
+}
+
+/**
+ * Returns true if there's something to read on stdin right now.
+ */
+static bool input_ready(struct timeval* timeout)
+{
+    fd_set read_set;
+    FD_ZERO(&read_set);
+    FD_SET(STDIN_FILENO, &read_set);
+    return select(STDIN_FILENO + 1, &read_set, NULL, NULL, timeout) > 0;
+}
+
+void AnsiTerminal::read_input()
+{
+    memset(keystate, 0, sizeof(keystate));
+    if(input_closed)
+    {
+        return;
+    }
+
+    //stdin might be a pipe (for scripted runs), where read() would block,
+    //so always check that there's something there first.
+    char bytes[256];
+    struct timeval no_wait = {0, 0};
+    while(input_ready(&no_wait))
+    {
+        ssize_t count = read(STDIN_FILENO, bytes, sizeof(bytes));
+        if(count <= 0)
+        {
+            input_closed = true;
+            break;
+        }
+        pending_input.append(bytes, count);
+    }
+}
+
+bool AnsiTerminal::parse_key(SDL_Event* event)
+{
+    while(pending_input.size() > 0)
+    {
+        unsigned char c = pending_input[0];
+        size_t used = 1;
+        SDLKey sym = SDLK_UNKNOWN;
+        SDLMod mod = KMOD_NONE;
+        Uint16 unicode = 0;
+
+        if(c == 27)
+        {
+            if(pending_input.size() >= 3 && pending_input[1] == '[')
+            {
+                //Skip to the end of the escape sequence.  We only care
+                //about the arrow keys.
+                size_t end = 2;
+                while(end < pending_input.size() && (pending_input[end] < 0x40 || pending_input[end] > 0x7E))
+                {
+                    end++;
+                }
+                if(end == pending_input.size())
+                {
+                    return false;
+                }
+                used = end + 1;
+                switch(pending_input[end])
+                {
+                    case 'A': sym = SDLK_UP; break;
+                    case 'B': sym = SDLK_DOWN; break;
+                    case 'C': sym = SDLK_RIGHT; break;
+                    case 'D': sym = SDLK_LEFT; break;
+                    default: break;
+                }
+            }
+            else
+            {
+                sym = SDLK_ESCAPE;
+            }
+        }
+        else if(c == 3)
+        {
+            //ctrl-c
+            pending_input.erase(0, 1);
+            event->type = SDL_QUIT;
+            return true;
+        }
+        else if(c == '\r' || c == '\n')
+        {
+            sym = SDLK_RETURN;
+            unicode = '\r';
+        }
+        else if(c == 127 || c == 8)
+        {
+            sym = SDLK_BACKSPACE;
+            unicode = 8;
+        }
+        else if(c >= 32 && c < 127)
+        {
+            //SDL's key symbols are the same as lowercase ASCII.
+            if(c >= 'A' && c <= 'Z')
+            {
+                sym = (SDLKey) (c - 'A' + 'a');
+                mod = KMOD_LSHIFT;
+            }
+            else
+            {
+                sym = (SDLKey) c;
+            }
+            unicode = c;
+        }
+
+        pending_input.erase(0, used);
+        if(sym != SDLK_UNKNOWN)
+        {
+            keystate[sym] = 1;
+            event->type = SDL_KEYDOWN;
+            event->key.type = SDL_KEYDOWN;
+            event->key.state = SDL_PRESSED;
+            event->key.keysym.sym = sym;
+            event->key.keysym.mod = mod;
+            event->key.keysym.unicode = unicode;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool AnsiTerminal::poll_event(SDL_Event* event)
+{
+    return parse_key(event);
+}
+
+void AnsiTerminal::wait_for_input()
+{
+    if(pending_input.size() > 0)
+    {
+        return;
+    }
+
+    //Nothing is ever going to come, so just don't spin.
+    if(input_closed)
+    {
+        struct timeval frame = {0, 70000};
+        select(0, NULL, NULL, NULL, &frame);
+        return;
+    }
+    input_ready(NULL);
+}
+
+Uint8* AnsiTerminal::get_keystate()
+{
+    return keystate;
+}
+
+long AnsiTerminal::get_last_frame_bytes()
+{
+    return last_frame_bytes;
+}
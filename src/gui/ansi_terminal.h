@@ -0,0 +1,181 @@
+/**
+ *  ANSI_TERMINAL.H
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ANSI_TERMINAL_H
+#define ANSI_TERMINAL_H
+
+#include <string>
+#include <streambuf>
+#include <vector>
+#include <unordered_map>
+#include <termios.h>
+#include <SDL/SDL.h>
+#include "render_target.h"
+
+/**
+ * Draws the game to the terminal with ANSI escape codes, and reads keys
+ * from the terminal instead of an SDL window.  This lets the game run on a
+ * machine with no display (over ssh, for example).
+ *
+ * Everything gets drawn into a back buffer of cells.  When the frame is
+ * flipped, it is compared against what the terminal is already showing and
+ * only the cells that changed are written, with a cursor move in front of
+ * each run of changed cells and a color change only when the color actually
+ * changes.  A frame where the player takes one step is usually a few
+ * hundred bytes.
+ */
+class AnsiTerminal : public RenderTarget
+{
+    private:
+        /**
+         * A single character on the screen.  Anything drawn in black is
+         * stored as a blank, since that's what it looks like.
+         */
+        struct Cell
+        {
+            int chr;
+            Uint32 fg;
+            Uint32 bg;
+            bool operator==(const Cell& other) const;
+            bool operator!=(const Cell& other) const;
+        };
+
+        int width;
+        int height;
+
+        /**
+         * What the terminal is showing right now.
+         */
+        std::vector<Cell> front;
+
+        /**
+         * What is being drawn for the next frame.
+         */
+        std::vector<Cell> back;
+
+        /**
+         * The UTF-8 encoding of every code page 437 character, so that the
+         * font's box drawing characters and such show up correctly.
+         */
+        std::vector<std::string> glyphs;
+
+        /**
+         * Colors that have already been matched to the 256 color palette.
+         */
+        std::unordered_map<Uint32, int> palette_cache;
+
+        /**
+         * The terminal settings from before we put it in raw mode, so they
+         * can be put back when the game exits.
+         */
+        struct termios old_settings;
+        bool raw_mode;
+
+        /**
+         * Where std::cout was going before we took over stdout.
+         */
+        std::streambuf* old_cout;
+
+        /**
+         * Which keys were pressed since the last time input was polled.  A
+         * terminal only tells us when a key repeats, not when it's let go,
+         * so a key counts as held for the frame after it was seen.
+         */
+        Uint8 keystate[SDLK_LAST];
+
+        /**
+         * Bytes that have been read from stdin but not turned into events.
+         */
+        std::string pending_input;
+
+        /**
+         * Set when stdin hits the end of the file (a script that was piped
+         * in ran out).
+         */
+        bool input_closed;
+
+        long last_frame_bytes;
+
+        /**
+         * Returns the xterm-256 color closest to the given color.
+         */
+        int palette_index(Uint32 color);
+
+        /**
+         * Turns the first key in pending_input into an SDL event, and
+         * removes it from pending_input.
+         * @return false if there wasn't a whole key waiting.
+         */
+        bool parse_key(SDL_Event* event);
+
+    public:
+        AnsiTerminal(int _width, int _height);
+        ~AnsiTerminal();
+
+        /**
+         * Puts the terminal into raw mode, hides the cursor and clears the
+         * screen.
+         */
+        void open();
+
+        /**
+         * Puts the terminal back the way that we found it.
+         */
+        void close();
+
+        void draw_chr(int x, int y, int chr, Uint32 color);
+        void clear_area(int x, int y, int height, int width, Uint32 color);
+        void flip();
+
+        /**
+         * Forgets what's on the terminal, so the next flip redraws every
+         * cell.  Useful if something else wrote over the screen.
+         */
+        void invalidate();
+
+        /**
+         * Reads everything that is waiting on stdin without blocking, and
+         * forgets which keys were held last frame.  Should be called once
+         * a frame, before poll_event().
+         */
+        void read_input();
+
+        /**
+         * Gets the next key that was read, as if it had come from SDL.
+         * @return false if there are no keys waiting.
+         */
+        bool poll_event(SDL_Event* event);
+
+        /**
+         * Blocks until a key is pressed.
+         */
+        void wait_for_input();
+
+        /**
+         * The terminal equivalent of SDL_GetKeyState().
+         */
+        Uint8* get_keystate();
+
+        /**
+         * The number of bytes that were written for the last frame.
+         */
+        long get_last_frame_bytes();
+};
+
+#endif
@@ -26,7 +26,8 @@ enum Screen {
     DEATH_SCREEN,
     MENU_SCREEN,
     DEBUG_CONSOLE,
-    DIRECTION_SCREEN
+    DIRECTION_SCREEN,
+    OVERVIEW_SCREEN
 };
 
 enum KeyState {
@@ -22,19 +22,23 @@
 
 GUI::GUI() {
     world_map_gui = WorldMapGUI();
-    game = Game();
     menu = new StartMenu(1, Tileset::get("BLOCK_WALL"), game, world_map_gui);
     current_screen = MENU_SCREEN;
     screen = NULL;
     asciiBase = NULL;
     ascii = NULL;
+    renderer = NULL;
+    terminal = NULL;
     keyset = GAME;
     running = true;
+    ui_generation = 1;
+    refreshed_generation = 0;
+    rendered_generation = 0;
+    rendered_ui_generation = 0;
+    rendered_visibility_generation = 0;
+    overview_zoom = 1;
     debug = DebugConsole(&game);
-    trees.push_back(ai::GENERIC_AGGRESSIVE(&game));
-    trees.push_back(ai::GENERIC_PASSIVE(&game));
-    trees.push_back(ai::FOLLOW(&game));
-    trees.push_back(ai::NPC(&game));
+    trees = ai::all_trees(&game);
 }
 
 int GUI::OnExecute() {
@@ -47,14 +51,38 @@ int GUI::OnExecute() {
 
     while(running) {
         game_clock = pt::microsec_clock::local_time();
-        while(SDL_PollEvent(&e)) {
-            OnEvent(&e);
-        }
-
-        OnLoop();
-        OnRender();
+        {
+            ScopedTimer frame_timer("frame");
+            {
+                ScopedTimer input_timer("input");
+                if(terminal != NULL) {
+                    terminal->read_input();
+                    while(terminal->poll_event(&e)) {
+                        OnEvent(&e);
+                    }
+                } else {
+                    while(SDL_PollEvent(&e)) {
+                        OnEvent(&e);
+                    }
+                }
+            }
 
-        SDL_Delay(handle_framerate());
+            OnLoop();
+            OnRender();
+        }
+        Profiler::instance().end_frame();
+
+        //If nothing is going to happen until the player presses a key,
+        //then there's no point in waking up every frame.
+        if(is_idle()) {
+            if(terminal != NULL) {
+                terminal->wait_for_input();
+            } else if(SDL_WaitEvent(&e)) {
+                OnEvent(&e);
+            }
+        } else {
+            SDL_Delay(handle_framerate());
+        }
 
     }
 
@@ -81,6 +109,35 @@ int GUI::handle_framerate() {
     }
 }
 
+/**
+ * The game is idle when the world isn't being simulated (we're in a menu,
+ * paused, dead, etc.) and there isn't a key being held down that would
+ * keep moving something.
+ */
+bool GUI::is_idle() {
+    if(Profiler::instance().overlay_on()) {
+        return false;
+    }
+    if(game.is_initialized() && !game.is_paused() && current_screen == GAME_SCREEN) {
+        return false;
+    }
+    return !arrow_key_held();
+}
+
+bool GUI::arrow_key_held() {
+    Uint8* keystate = get_keystate();
+    return keystate[SDLK_UP] || keystate[SDLK_DOWN] ||
+        keystate[SDLK_LEFT] || keystate[SDLK_RIGHT];
+}
+
+Uint8* GUI::get_keystate() {
+    if(terminal != NULL) {
+        return terminal->get_keystate();
+    }
+    SDL_PumpEvents();
+    return SDL_GetKeyState(NULL);
+}
+
 GUI::~GUI()
 {
     delete menu;
@@ -101,6 +158,11 @@ void GUI::load_font(string font)
     //Set all pixels of color R 0, G 0xFF, B 0xFF to be transparent
     SDL_SetColorKey( ascii, SDL_SRCCOLORKEY, colorkey );
     SDL_SetColorKey( ascii, SDL_SRCCOLORKEY, colorkey );
+
+    if(renderer != NULL)
+    {
+        ((SDLRenderTarget*)renderer)->set_font(ascii);
+    }
 }
 
 void GUI::add_characters(std::vector<Character*> characters)
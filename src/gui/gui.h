@@ -36,9 +36,13 @@
 #include "game_states.h"
 #include "debug.h"
 #include "behavior_tree.h"
+#include "tree_runner.h"
 #include "ai_defs.h"
 #include "message.h"
 #include "tileset.h"
+#include "profiler.h"
+#include "render_target.h"
+#include "ansi_terminal.h"
 
 //forward declarations
 class Menu;
@@ -74,15 +78,73 @@ class GUI : public VirtualEvent {
         Game game;
         std::vector<BehaviorTree> trees;
 
+        /**
+         * Runs the actors of all of the trees every frame.
+         */
+        TreeRunner tree_runner;
+
+        /**
+         * Goes up whenever something outside of the game world changes
+         * what should be on the screen (key presses, screen changes, menu
+         * movement).  Works alongside Game::get_generation() to decide
+         * whether a frame needs to be drawn.
+         */
+        unsigned long ui_generation;
+
+        /**
+         * The game generation that the canvas was last refreshed at.
+         */
+        unsigned long refreshed_generation;
+
+        /**
+         * The game and ui generations that were last drawn to the screen.
+         */
+        unsigned long rendered_generation;
+        unsigned long rendered_ui_generation;
+
+        /**
+         * The field of view generation that was last drawn to the screen.
+         * @see Game::get_visibility_generation()
+         */
+        unsigned long rendered_visibility_generation;
+
+        /**
+         * How far out the in-game world map is zoomed.  At 0 every
+         * character is a chunk; at 1 every character is a block of a chunk
+         * summary.
+         */
+        int overview_zoom;
+
+        /**
+         * The block that the world map is centered on, in blocks from the
+         * top left of the world.
+         */
+        IntPoint overview_center;
+
 
         SDL_Event event;
         SDL_Surface* screen;
         SDL_Surface* asciiBase;
         SDL_Surface* ascii;
 
+        /**
+         * Where everything gets drawn.  Either an SDLRenderTarget, or the
+         * terminal if the renderer setting is "ansi".
+         */
+        RenderTarget* renderer;
+
+        /**
+         * The terminal backend, or NULL if we're drawing with SDL.  Kept
+         * separately from renderer because it also handles input.
+         */
+        AnsiTerminal* terminal;
+
 
         void add_characters(std::vector<Character*> characters);
         int handle_framerate();
+        bool is_idle();
+        bool arrow_key_held();
+        Uint8* get_keystate();
         void clear_screen();
         void render_canvas();
         void render_characters();
@@ -93,6 +155,11 @@ class GUI : public VirtualEvent {
         void render_target();
         void render_animations();
         void render_message();
+        int render_perf(int height);
+        void render_overview();
+        void render_minimap(int height);
+        void render_summaries(int x, int y, int height, int width, IntPoint top_left, int depth);
+        IntPoint main_char_block();
         void clear_area(IntPoint start, IntPoint size);
         int render_stats(Character* chara, int height);
         void handle_direction(int row, int col);
@@ -20,6 +20,16 @@
 #include "gui.h"
 
 void GUI::OnCleanup() {
-    SDL_FreeSurface (ascii);
+    if(terminal != NULL)
+    {
+        terminal->close();
+    }
+    else
+    {
+        SDL_FreeSurface (ascii);
+    }
+    delete renderer;
+    renderer = NULL;
+    terminal = NULL;
     SDL_Quit();
 }
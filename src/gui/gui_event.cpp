@@ -31,6 +31,8 @@
 
 void GUI::OnEvent(SDL_Event* Event) {
     VirtualEvent::OnEvent(Event);
+    //Anything could have changed, so the next frame has to be drawn.
+    ui_generation++;
 }
 
 void GUI::OnKeyDown(SDLKey sym, SDLMod mod, Uint16 unicode) {
@@ -123,7 +125,7 @@ void GUI::perform_action_press(SDLKey key) {
                     //push back
                     //hoohoohoo! Casting to a subclass! Dirty and dangerous!
                     //(But it works fine here imo)
-                    if(((FontMenu*)menu)->get_font() != "")
+                    if(((FontMenu*)menu)->get_font() != "" && terminal == NULL)
                     {
                         load_font(((FontMenu*)menu)->get_font());
                     }
@@ -170,7 +172,7 @@ void GUI::perform_action_press(SDLKey key) {
                 game.change_depth(-1, &game.main_char);
                 game.update_buffer(game.main_char.get_chunk());
                 if(game.main_char.get_depth() >= 0) {
-                    game.recalculate_visibility_lines(10);
+                    game.set_visibility_radius(10);
     }
             }
             break;
@@ -180,7 +182,7 @@ void GUI::perform_action_press(SDLKey key) {
                 game.change_depth(1, &game.main_char);
                 game.update_buffer(game.main_char.get_chunk());
                 if(game.main_char.get_depth() >= 0) {
-                    game.recalculate_visibility_lines(10);
+                    game.set_visibility_radius(10);
                 }
             }
             break;
@@ -235,6 +237,54 @@ void GUI::perform_action_press(SDLKey key) {
             }
             break;
 
+        case SDLK_p:
+            //Show how long each part of the frame is taking.
+            if(current_screen == GAME_SCREEN)
+            {
+                Profiler::instance().toggle_overlay();
+            }
+            break;
+
+        case SDLK_w:
+            //Open or close the world map.
+            if(current_screen == GAME_SCREEN)
+            {
+                current_screen = OVERVIEW_SCREEN;
+                overview_center = main_char_block();
+                game.pause();
+            }
+            else if(current_screen == OVERVIEW_SCREEN)
+            {
+                current_screen = GAME_SCREEN;
+                game.unpause();
+            }
+            break;
+
+        case SDLK_MINUS:
+            //Zoom out, showing more tiles per character.
+            if(current_screen == GAME_SCREEN)
+            {
+                IntPoint view = game.get_view_size();
+                game.set_view(view.row, view.col, game.get_zoom() + 1);
+            }
+            else if(current_screen == OVERVIEW_SCREEN)
+            {
+                overview_zoom = 0;
+            }
+            break;
+        case SDLK_EQUALS:
+            //Zoom back in.
+            if(current_screen == GAME_SCREEN && game.get_zoom() > 1)
+            {
+                IntPoint view = game.get_view_size();
+                game.set_view(view.row, view.col, game.get_zoom() - 1);
+            }
+            else if(current_screen == OVERVIEW_SCREEN)
+            {
+                overview_zoom = 1;
+            }
+            break;
+
         case SDLK_SPACE:
             if(current_screen == GAME_SCREEN)
             {
@@ -247,24 +297,44 @@ void GUI::perform_action_press(SDLKey key) {
             {
                 handle_direction(-1, 0);
             }
+            else if(current_screen == OVERVIEW_SCREEN)
+            {
+                //Scroll a chunk at a time.
+                overview_center = overview_center + IntPoint(-(CHUNK_HEIGHT / ChunkSummary::BLOCK_SIZE), 0);
+            }
             break;
         case SDLK_DOWN:
             if(current_screen == DIRECTION_SCREEN)
             {
                 handle_direction(1, 0);
             }
+            else if(current_screen == OVERVIEW_SCREEN)
+            {
+                //Scroll a chunk at a time.
+                overview_center = overview_center + IntPoint(CHUNK_HEIGHT / ChunkSummary::BLOCK_SIZE, 0);
+            }
             break;
         case SDLK_LEFT:
             if(current_screen == DIRECTION_SCREEN)
             {
                 handle_direction(0, -1);
             }
+            else if(current_screen == OVERVIEW_SCREEN)
+            {
+                //Scroll a chunk at a time.
+                overview_center = overview_center + IntPoint(0, -(CHUNK_WIDTH / ChunkSummary::BLOCK_SIZE));
+            }
             break;
         case SDLK_RIGHT:
             if(current_screen == DIRECTION_SCREEN)
             {
                 handle_direction(0, 1);
             }
+            else if(current_screen == OVERVIEW_SCREEN)
+            {
+                //Scroll a chunk at a time.
+                overview_center = overview_center + IntPoint(0, CHUNK_WIDTH / ChunkSummary::BLOCK_SIZE);
+            }
             break;
 
         case SDLK_q:
@@ -283,8 +353,11 @@ void GUI::perform_action_press(SDLKey key) {
 
 
 void GUI::perform_action_cont() {
-    SDL_PumpEvents();
-    Uint8* keystate = SDL_GetKeyState(NULL);
+    Uint8* keystate = get_keystate();
+
+    if(current_screen != GAME_SCREEN && arrow_key_held()) {
+        ui_generation++;
+    }
 
     if (current_screen == MENU_SCREEN) {
         if(keystate[SDLK_UP]) {
@@ -307,9 +380,7 @@ void GUI::perform_action_cont() {
             world_map_gui.move_cursor(0, 1);
         }
     } else if(current_screen == GAME_SCREEN) {
-        //THIS IS IMPORTANT, as it it turns out.
-        if(game.is_initialized() && game.is_paused() == false) {
-            game.undo_visibility();
+        if(game.is_initialized() && game.is_paused() == false && arrow_key_held()) {
             IntPoint old_chunk = game.main_char.get_chunk();
             if(keystate[SDLK_LEFT]){
                 game.move_char(-1, 0, &game.main_char);
@@ -24,6 +24,10 @@ namespace gregorian = boost::gregorian;
 
 bool GUI::OnInit() {
     string font_pref = "default";
+    string renderer_pref = "sdl";
+    int view_width = GAME_WIDTH;
+    int view_height = GAME_HEIGHT;
+    int zoom = 1;
     std::ifstream pref_file;
     pref_file.open(DATADIR "/settings.conf");
     if(pref_file.good())
@@ -37,6 +41,22 @@ bool GUI::OnInit() {
             {
                 font_pref = value;
             }
+            else if(pref == "renderer")
+            {
+                renderer_pref = value;
+            }
+            else if(pref == "view_width")
+            {
+                view_width = atoi(value.c_str());
+            }
+            else if(pref == "view_height")
+            {
+                view_height = atoi(value.c_str());
+            }
+            else if(pref == "zoom")
+            {
+                zoom = atoi(value.c_str());
+            }
         }
         pref_file.close();
     }
@@ -47,6 +67,25 @@ bool GUI::OnInit() {
         return false;
     }
 
+    //The view can't be bigger than the part of the screen that the map is
+    //drawn on.
+    view_width = std::max(1, std::min(view_width, GAME_WIDTH));
+    view_height = std::max(1, std::min(view_height, GAME_HEIGHT));
+    game.set_view(view_height, view_width, std::max(1, zoom));
+
+    game_clock = pt::microsec_clock::local_time();
+
+    //Draw to the terminal instead of opening a window.  There's no video,
+    //so only the timer gets initialized.
+    if(renderer_pref == "ansi")
+    {
+        SDL_Init(SDL_INIT_TIMER);
+        terminal = new AnsiTerminal(SCREEN_WIDTH, SCREEN_HEIGHT);
+        terminal->open();
+        renderer = terminal;
+        return true;
+    }
+
     //initialize stuff
     SDL_Init(SDL_INIT_TIMER | SDL_INIT_VIDEO );
 
@@ -65,7 +104,7 @@ bool GUI::OnInit() {
 
     SDL_EnableUNICODE(SDL_ENABLE);
 
-    game_clock = pt::microsec_clock::local_time();
+    renderer = new SDLRenderTarget(screen, ascii);
 
     return true;
 }
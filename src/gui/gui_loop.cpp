@@ -21,26 +21,39 @@
 
 
 void GUI::OnLoop() {
-    perform_action_cont();
+    {
+        ScopedTimer input_timer("input");
+        perform_action_cont();
+    }
     if(game.is_initialized() && game.is_paused() == false && current_screen == GAME_SCREEN) {
-        game.act(STD_MS_PER_FRAME);
-        for(int i=0;i<trees.size();i++)
         {
-            trees[i].run_actors(STD_MS_PER_FRAME);
+            ScopedTimer act_timer("act");
+            game.act(STD_MS_PER_FRAME);
+        }
+        game.collect_paths();
+        {
+            ScopedTimer ai_timer("ai");
+            tree_runner.run(trees, &game, STD_MS_PER_FRAME);
+        }
+        game.dispatch_paths();
+        //Only rebuild the canvas if something has actually changed since
+        //the last time it was built.
+        if(game.get_generation() != refreshed_generation)
+        {
+            ScopedTimer refresh_timer("refresh");
+            game.refresh();
+            refreshed_generation = game.get_generation();
+        }
+        {
+            ScopedTimer spawner_timer("spawners");
+            game.run_spawners();
         }
-        game.refresh();
-        game.run_spawners();
         add_characters(game.flush_characters());
         game.clear_character_queue();
         if(!game.main_char.is_alive())
         {
            current_screen = DEATH_SCREEN;
+           ui_generation++;
         }
     }
-    else if(game.is_initialized() && game.is_paused())
-    {
-        //this shouldn't effect anything else because the game is paused,
-        //and it'll make navigating the menu less of a pain.
-        SDL_Delay(100);
-    }
 }
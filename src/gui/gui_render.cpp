@@ -22,19 +22,31 @@
 #include "menu.h"
 
 void GUI::OnRender() {
+    //Nothing has changed since the last frame, so the screen is already
+    //correct.  The perf overlay changes every frame, so always draw it.
+    if(game.get_generation() == rendered_generation &&
+            ui_generation == rendered_ui_generation &&
+            game.get_visibility_generation() == rendered_visibility_generation &&
+            !Profiler::instance().overlay_on()) {
+        return;
+    }
+    rendered_generation = game.get_generation();
+    rendered_ui_generation = ui_generation;
+    rendered_visibility_generation = game.get_visibility_generation();
+
     if(current_screen == MENU_SCREEN) {
         render_menu(menu);
     } else if(current_screen == MAP_SCREEN) {
-        std::vector<std::vector<MapTile> > map_canvas = world_map_gui.get_canvas();
+        const std::vector<std::vector<MapTile> >& map_canvas = world_map_gui.get_canvas();
         for(size_t i = 0; i < map_canvas.size(); i++) {
             for(size_t j = 0; j < map_canvas[i].size(); j++) {
-                drawChr(j, i, map_canvas[i][j].char_count, ascii, screen, map_canvas[i][j].color);
+                renderer->draw_chr(j, i, map_canvas[i][j].char_count, map_canvas[i][j].color);
             }
         }
-        drawStr(0, GAME_HEIGHT - 2, std::string("Use the arrow keys to move the cursor.").c_str(),
-                ascii, screen, WHITE);
-        drawStr(0, GAME_HEIGHT - 1, std::string("Press ENTER to spawn on the selected map tile.").c_str(),
-                ascii, screen, WHITE);
+        renderer->draw_str(0, GAME_HEIGHT - 2, std::string("Use the arrow keys to move the cursor.").c_str(),
+                WHITE);
+        renderer->draw_str(0, GAME_HEIGHT - 1, std::string("Press ENTER to spawn on the selected map tile.").c_str(),
+                WHITE);
     } else if (current_screen == GAME_SCREEN) {
         render_canvas();
         render_target();
@@ -45,12 +57,14 @@ void GUI::OnRender() {
         render_interface();
         render_message();
 
+    } else if(current_screen == OVERVIEW_SCREEN) {
+        render_overview();
     } else if(current_screen == DIRECTION_SCREEN)
     {
-        drawStr(0, 0, std::string("Pick a direction to perform the action.").c_str(), ascii, screen, WHITE);
+        renderer->draw_str(0, 0, std::string("Pick a direction to perform the action.").c_str(), WHITE);
     } else if (current_screen == DEATH_SCREEN) {
         clear_screen();
-        drawStr(GAME_WIDTH/2 - 12, GAME_HEIGHT/2, std::string("You suck, uninstall bro.").c_str(), ascii, screen, WHITE);
+        renderer->draw_str(GAME_WIDTH/2 - 12, GAME_HEIGHT/2, std::string("You suck, uninstall bro.").c_str(), WHITE);
     } else if (current_screen == DEBUG_CONSOLE) {
         render_canvas();
         render_target();
@@ -59,10 +73,10 @@ void GUI::OnRender() {
         render_debug();
     }
     if(game.is_paused()) {
-        drawStr(GAME_WIDTH-20, 0, std::string("Paused").c_str(), ascii, screen, WHITE);
+        renderer->draw_str(GAME_WIDTH-20, 0, std::string("Paused").c_str(), WHITE);
     }
 
-    SDL_Flip(screen);
+    renderer->flip();
 }
 
 void GUI::clear_screen()
@@ -71,70 +85,74 @@ void GUI::clear_screen()
     {
         for(int j=0;j<GAME_HEIGHT;j++)
         {
-            drawStr(i, j, std::string(" ").c_str(), ascii, screen, WHITE);
+            renderer->draw_str(i, j, std::string(" ").c_str(), WHITE);
         }
     }
 }
 
 void GUI::render_canvas()
 {
+    ScopedTimer timer("r_canvas");
     clear_screen();
-    TilePointerMatrix tm = game.get_canvas();
+    const TilePointerMatrix& tm = game.get_canvas();
     for(size_t i = 0; i < tm.size(); i++) {
         for(size_t j = 0; j < tm[i].size(); j++) {
             if(game.visibility_on) {
                 //If the tile is visible, render it fully.
-                if(tm[i][j]->visible) {
-                    drawChr(j, i, tm[i][j]->char_count, ascii, screen, tm[i][j]->color);
+                if(game.in_fov(IntPoint(i, j))) {
+                    renderer->draw_chr(j, i, tm[i][j]->char_count, tm[i][j]->color);
 
                 //If the tile is not visible, but has been seen, render it in
                 //grey.
-                } else if(tm[i][j]->seen) {
-                    drawChr(j, i, tm[i][j]->char_count, ascii, screen, VERY_DARK_GRAY);
+                } else if(game.is_explored(IntPoint(i, j))) {
+                    renderer->draw_chr(j, i, tm[i][j]->char_count, VERY_DARK_GRAY);
                     //We probably shouldn't draw the chara layer on non-visible
                     //tiles.
                 } else {
                     //Draw an empty tile
-                    drawChr(j, i, 0, ascii, screen, 0);
+                    renderer->draw_chr(j, i, 0, 0);
                 }
             } else {
-                drawChr(j, i, tm[i][j]->char_count, ascii, screen, tm[i][j]->color);
+                renderer->draw_chr(j, i, tm[i][j]->char_count, tm[i][j]->color);
             }
         }
     }
 }
 
 void GUI::render_characters() {
+    ScopedTimer timer("r_chars");
     Tile current_tile;
     IntPoint current_point;
-    TilePointerMatrix tm = game.get_canvas();
     std::vector<Character*> tl = game.get_vis_characters();
     for(size_t i = 0; i < tl.size(); i++) {
         IntPoint temp_chunk = IntPoint(tl[i]->get_chunk_y(),tl[i]->get_chunk_x());
         IntPoint temp_coords = IntPoint(tl[i]->get_y(), tl[i]->get_x());
         current_tile = tl[i]->get_char();
         current_point = game.get_canvas_coords(temp_chunk, temp_coords);
-        if(tm[current_point.row][current_point.col]->visible) {
-            drawChr(current_point.col, current_point.row,
-                    current_tile.char_count, ascii, screen, current_tile.color);
+        if(game.is_vis(current_point) && game.in_fov(current_point)) {
+            renderer->draw_chr(current_point.col, current_point.row,
+                    current_tile.char_count, current_tile.color);
         }
     }
 }
 
 void GUI::render_main_char() {
-    drawChr(GAME_WIDTH/2, GAME_HEIGHT/2, game.main_char.get_char().char_count, ascii, screen, game.main_char.get_char().color);
+    ScopedTimer timer("r_main");
+    IntPoint point = game.get_canvas_coords(game.main_char.get_chunk(), game.main_char.get_coords());
+    renderer->draw_chr(point.col, point.row, game.main_char.get_char().char_count, game.main_char.get_char().color);
 }
 
 void GUI::render_interface() {
+    ScopedTimer timer("r_ui");
     Character* target = game.main_char.get_target();
     int height = 0;
 
-    drawStr(UI_START, height, std::string("Main Character").c_str(), ascii, screen, WHITE);
+    renderer->draw_str(UI_START, height, std::string("Main Character").c_str(), WHITE);
 
     height = render_stats(&game.main_char, height + 1);
     height ++;
 
-    drawStr(UI_START, height, std::string("Target").c_str(), ascii, screen, WHITE);
+    renderer->draw_str(UI_START, height, std::string("Target").c_str(), WHITE);
 
     //Render the current target
     if(target != NULL)
@@ -143,13 +161,22 @@ void GUI::render_interface() {
     }
     else
     {
-        drawStr(UI_START, height + 1, std::string("None").c_str(), ascii, screen, WHITE);
+        renderer->draw_str(UI_START, height + 1, std::string("None").c_str(), WHITE);
+    }
+
+    if(Profiler::instance().overlay_on())
+    {
+        render_perf(height + 2);
+    }
+    else
+    {
+        render_minimap(height + 2);
     }
 
     //Render that you have a level!
     if(game.main_char.get_new_levels() > 0)
     {
-        drawStr(UI_START, SCREEN_HEIGHT - 1, std::string("Level up!").c_str(), ascii, screen, RED);
+        renderer->draw_str(UI_START, SCREEN_HEIGHT - 1, std::string("Level up!").c_str(), RED);
     }
 }
 
@@ -159,7 +186,7 @@ int GUI::render_stats(Character* chara, int height)
     {
         stringstream ss;
         ss << STAT_NAMES[i] << ": " << chara->get_current_stat(i) << "/" << chara->get_stat(i);
-        drawStr(UI_START, height, ss.str().c_str(), ascii, screen, WHITE);
+        renderer->draw_str(UI_START, height, ss.str().c_str(), WHITE);
         height++;
     }
     return height;
@@ -169,6 +196,7 @@ int GUI::render_stats(Character* chara, int height)
 //WHEN DID THIS GET SO BIG?? REFACTOR THIS!
 void GUI::render_menu(Menu* menu)
 {
+    ScopedTimer timer("r_menu");
 
     //menus will always be rendered in the middle of the screen, fyi
     //clear the background in the specified height/width
@@ -194,7 +222,7 @@ void GUI::render_menu(Menu* menu)
         {
             for(int col = extra_col; col <= extra_end_col; col++)
             {
-                drawChr(col, row, menu->border.char_count, ascii, screen, BLACK);
+                renderer->draw_chr(col, row, menu->border.char_count, BLACK);
             }
         }
     }
@@ -204,7 +232,7 @@ void GUI::render_menu(Menu* menu)
     {
         for(int col = start_col; col <= end_col; col++)
         {
-            drawChr(col, row, menu->border.char_count, ascii, screen, BLACK);
+            renderer->draw_chr(col, row, menu->border.char_count, BLACK);
         }
     }
 
@@ -214,8 +242,7 @@ void GUI::render_menu(Menu* menu)
     starting_col = (GAME_WIDTH - menu->title.size()) / 2;
 
     //draw the title
-    drawStr(starting_col, (GAME_HEIGHT/4), menu->title.c_str(),
-            ascii, screen, RED);
+    renderer->draw_str(starting_col, (GAME_HEIGHT/4), menu->title.c_str(), RED);
 
 
     int color, string_size;
@@ -231,7 +258,7 @@ void GUI::render_menu(Menu* menu)
 
         color = RED;
 
-        drawStr(extra_col, extra_row + menu->padding + i, option.c_str(), ascii, screen, color);
+        renderer->draw_str(extra_col, extra_row + menu->padding + i, option.c_str(), color);
     }
 
     //Render selections
@@ -250,27 +277,29 @@ void GUI::render_menu(Menu* menu)
             color = DARK_GRAY;
         }
 
-        drawStr(starting_col, start_row + menu->padding + i,
-                option.c_str(), ascii, screen, color);
+        renderer->draw_str(starting_col, start_row + menu->padding + i,
+                option.c_str(), color);
     }
 
 }
 
 void GUI::render_target()
 {
-    TilePointerMatrix tm = game.get_canvas();
+    ScopedTimer timer("r_target");
+    const TilePointerMatrix& tm = game.get_canvas();
     if(game.main_char.get_target() != NULL)
     {
         Character* chara = game.main_char.get_target();
         IntPoint temp_chunk = chara->get_chunk();
 
-        std::vector<IntPoint> sight = chara->sight_tiles();
+        std::vector<IntPoint> sight;
+        game.visible_sight_tiles(chara, sight);
         for(int i=0;i<sight.size();i++)
         {
             IntPoint point = game.get_canvas_coords(temp_chunk, sight[i]);
-            if(game.is_vis(point) && tm[point.row][point.col]->visible)
+            if(game.is_vis(point) && game.in_fov(point))
             {
-                drawChr(point.col, point.row, tm[point.row][point.col]->char_count, ascii, screen, YELLOW);
+                renderer->draw_chr(point.col, point.row, tm[point.row][point.col]->char_count, YELLOW);
             }
         }
     }
@@ -278,21 +307,22 @@ void GUI::render_target()
 
 void GUI::render_debug()
 {
+    ScopedTimer timer("r_debug");
     std::unordered_map<std::string, Tile>* tileset = &Tileset::instance()->get_tileset();
     for(int i=0;i<GAME_WIDTH;i++)
     {
-        drawChr(i, GAME_HEIGHT-3, (*tileset)["BLOCK_WALL"].char_count, ascii, screen, BLACK);
-        drawChr(i, GAME_HEIGHT-2, (*tileset)["BLOCK_WALL"].char_count, ascii, screen, BLACK);
+        renderer->draw_chr(i, GAME_HEIGHT-3, (*tileset)["BLOCK_WALL"].char_count, BLACK);
+        renderer->draw_chr(i, GAME_HEIGHT-2, (*tileset)["BLOCK_WALL"].char_count, BLACK);
     }
-    drawChr(input.size(), GAME_HEIGHT-2, (*tileset)["BLOCK_WALL"].char_count, ascii, screen, WHITE);
-    drawStr(0, GAME_HEIGHT-3, debug.get_message().c_str(), ascii, screen, WHITE);
-    drawStr(0, GAME_HEIGHT-2, input.c_str(), ascii, screen, WHITE);
+    renderer->draw_chr(input.size(), GAME_HEIGHT-2, (*tileset)["BLOCK_WALL"].char_count, WHITE);
+    renderer->draw_str(0, GAME_HEIGHT-3, debug.get_message().c_str(), WHITE);
+    renderer->draw_str(0, GAME_HEIGHT-2, input.c_str(), WHITE);
 }
 
 void GUI::render_animations()
 {
+    ScopedTimer timer("r_anims");
     std::vector<Animation> anims = game.get_animations();
-    TilePointerMatrix tm = game.get_canvas();
     for(int i=0;i<anims.size();i++)
     {
         Frame f = anims[i].get_frame();
@@ -303,9 +333,9 @@ void GUI::render_animations()
         {
             Actor a = f.actor(j);
             coords = vis + IntPoint(a.get_y(), a.get_x());
-            if(game.is_vis(coords) && tm[coords.row][coords.col]->visible)
+            if(game.is_vis(coords) && game.in_fov(coords))
             {
-                drawChr(coords.col, coords.row, a.get_char(), ascii, screen, a.get_color());
+                renderer->draw_chr(coords.col, coords.row, a.get_char(), a.get_color());
             }
         }
     }
@@ -313,10 +343,188 @@ void GUI::render_animations()
 
 void GUI::clear_area(IntPoint start, IntPoint size)
 {
-    clearArea(start.col, start.row, size.row, size.col, screen, BLACK);
+    renderer->clear_area(start.col, start.row, size.row, size.col, BLACK);
+}
+
+/**
+ * Draws the percentiles of each profiled section in the UI panel.  There's
+ * only UI_WIDTH columns to work with, so names get cut short and times are
+ * written in milliseconds with as few characters as possible.
+ */
+int GUI::render_perf(int height)
+{
+    Profiler* profiler = &Profiler::instance();
+    std::vector<std::string> sections = profiler->get_sections();
+    int percents[3] = {50, 95, 99};
+
+    renderer->draw_str(UI_START, height, std::string("perf    p50 p95 p99").c_str(), WHITE);
+    height++;
+    for(int i=0;i<sections.size() && height < SCREEN_HEIGHT - 1;i++)
+    {
+        stringstream ss;
+        ss << sections[i].substr(0, 7);
+        ss << std::string(8 - ss.str().size(), ' ');
+        for(int j=0;j<3;j++)
+        {
+            long micros = profiler->percentile(sections[i], percents[j]);
+            char value[8];
+            if(micros < 9950)
+            {
+                snprintf(value, sizeof(value), "%3.1f", micros / 1000.0);
+            }
+            else
+            {
+                snprintf(value, sizeof(value), "%3ld", std::min(micros / 1000, 999L));
+            }
+            ss << value << (j < 2 ? " " : "");
+        }
+
+        //Anything blowing the frame budget is drawn in red.
+        int color = profiler->percentile(sections[i], 95) > STD_MS_PER_FRAME * 1000 ? RED : LIGHT_GRAY;
+        renderer->draw_str(UI_START, height, ss.str().c_str(), color);
+        height++;
+    }
+
+    //How much the terminal backend is sending down the wire.
+    if(terminal != NULL && height < SCREEN_HEIGHT - 1)
+    {
+        stringstream ss;
+        ss << "bytes   " << terminal->get_last_frame_bytes();
+        renderer->draw_str(UI_START, height, ss.str().c_str(), LIGHT_GRAY);
+        height++;
+    }
+    return height;
 }
 
 void GUI::render_message()
 {
-    drawStr(0, MESSAGE_HEIGHT, MessageBoard::instance().get_current_message().c_str(), ascii, screen, WHITE);
+    ScopedTimer timer("r_msg");
+    renderer->draw_str(0, MESSAGE_HEIGHT, MessageBoard::instance().get_current_message().c_str(), WHITE);
+}
+
+/**
+ * Draws chunk summaries onto the screen, one character per block.
+ * Blocks that the main character hasn't seen yet are drawn as if nobody
+ * had been there.
+ * @param top_left The block to draw at (x, y), counted in blocks from the
+ * top left of the world.
+ */
+void GUI::render_summaries(int x, int y, int height, int width, IntPoint top_left, int depth)
+{
+    const int block_rows = CHUNK_HEIGHT / ChunkSummary::BLOCK_SIZE;
+    const int block_cols = CHUNK_WIDTH / ChunkSummary::BLOCK_SIZE;
+    const std::vector<std::vector<MapTile> >& world = game.get_world_map();
+
+    for(int i = 0; i < height; i++)
+    {
+        int block_row = top_left.row + i;
+        int chunk_row = block_row >= 0 ? block_row / block_rows : -1;
+        for(int j = 0; j < width; j++)
+        {
+            int block_col = top_left.col + j;
+            int chunk_col = block_col >= 0 ? block_col / block_cols : -1;
+            const ChunkSummary* summary = game.get_chunk_summary(IntPoint(chunk_row, chunk_col), depth);
+            bool known = summary != NULL;
+            if(known)
+            {
+                //Chunks in the buffer only show the blocks that have been
+                //seen.  The rest are gone, and so is what was seen of them.
+                const Bitplane* explored = game.get_explored(IntPoint(chunk_row, chunk_col), depth);
+                int size = ChunkSummary::BLOCK_SIZE;
+                known = explored == NULL || explored->any((block_row % block_rows) * size,
+                        (block_col % block_cols) * size, size, size);
+            }
+
+            if(known)
+            {
+                const SummaryCell& cell = summary->get_cell(block_row % block_rows, block_col % block_cols);
+                renderer->draw_chr(x + j, y + i, cell.char_count, cell.color);
+            }
+            else if(depth == 0 && chunk_row >= 0 && chunk_row < WORLD_HEIGHT &&
+                    chunk_col >= 0 && chunk_col < WORLD_WIDTH)
+            {
+                //Nobody has been here yet, so all we know is what the world
+                //map says.
+                renderer->draw_chr(x + j, y + i, world[chunk_row][chunk_col].char_count, VERY_DARK_GRAY);
+            }
+            else
+            {
+                renderer->draw_chr(x + j, y + i, 0, BLACK);
+            }
+        }
+    }
+}
+
+IntPoint GUI::main_char_block()
+{
+    IntPoint chunk = game.main_char.get_chunk();
+    IntPoint coords = game.main_char.get_coords();
+    return IntPoint(chunk.row * (CHUNK_HEIGHT / ChunkSummary::BLOCK_SIZE) + coords.row / ChunkSummary::BLOCK_SIZE,
+            chunk.col * (CHUNK_WIDTH / ChunkSummary::BLOCK_SIZE) + coords.col / ChunkSummary::BLOCK_SIZE);
+}
+
+/**
+ * Draws the world map over the game area.  Zoomed all the way out it's the
+ * same map that the game was started from, with the chunks that have been
+ * visited drawn brighter.  Zoomed in, every chunk is drawn from its summary.
+ */
+void GUI::render_overview()
+{
+    ScopedTimer timer("r_overview");
+    Tile main_tile = game.main_char.get_char();
+    int depth = game.main_char.get_depth();
+    clear_area(IntPoint(0, 0), IntPoint(SCREEN_HEIGHT, SCREEN_WIDTH));
+
+    if(overview_zoom == 0)
+    {
+        const std::vector<std::vector<MapTile> >& world = game.get_world_map();
+        for(int i = 0; i < WORLD_HEIGHT && i < GAME_HEIGHT - 1; i++)
+        {
+            for(int j = 0; j < WORLD_WIDTH && j < GAME_WIDTH; j++)
+            {
+                bool visited = game.get_chunk_summary(IntPoint(i, j), depth) != NULL;
+                renderer->draw_chr(j, i, world[i][j].char_count, visited ? world[i][j].color : VERY_DARK_GRAY);
+            }
+        }
+        IntPoint chunk = game.main_char.get_chunk();
+        renderer->draw_chr(chunk.col, chunk.row, main_tile.char_count, main_tile.color);
+    }
+    else
+    {
+        int height = GAME_HEIGHT - 1;
+        int width = GAME_WIDTH;
+        IntPoint top_left = IntPoint(overview_center.row - height / 2, overview_center.col - width / 2);
+        render_summaries(0, 0, height, width, top_left, depth);
+
+        IntPoint block = main_char_block() - top_left;
+        if(block.row >= 0 && block.row < height && block.col >= 0 && block.col < width)
+        {
+            renderer->draw_chr(block.col, block.row, main_tile.char_count, main_tile.color);
+        }
+    }
+
+    renderer->draw_str(0, GAME_HEIGHT - 1,
+            std::string("World map. Arrow keys scroll, - and = zoom, w goes back.").c_str(), WHITE);
+}
+
+/**
+ * Draws the blocks around the main character at the bottom of the UI panel.
+ */
+void GUI::render_minimap(int height)
+{
+    const int map_height = 11;
+    const int map_width = UI_WIDTH - 1;
+    int top = SCREEN_HEIGHT - 2 - map_height;
+    if(top <= height)
+    {
+        return;
+    }
+
+    renderer->draw_str(UI_START, top - 1, std::string("Map").c_str(), WHITE);
+    IntPoint center = main_char_block();
+    IntPoint top_left = IntPoint(center.row - map_height / 2, center.col - map_width / 2);
+    render_summaries(UI_START, top, map_height, map_width, top_left, game.main_char.get_depth());
+
+    Tile main_tile = game.main_char.get_char();
+    renderer->draw_chr(UI_START + map_width / 2, top + map_height / 2, main_tile.char_count, main_tile.color);
 }
@@ -0,0 +1,67 @@
+/**
+ *  RENDER_TARGET.CPP
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include <ASCII_Lib.h>
+#include "render_target.h"
+
+RenderTarget::~RenderTarget()
+{
+
+}
+
+void RenderTarget::draw_str(int x, int y, const char s[], Uint32 color)
+{
+    size_t length = strlen(s);
+    for(size_t i = 0; i < length; i++)
+    {
+        draw_chr(x + i, y, (unsigned char) s[i], color);
+    }
+}
+
+SDLRenderTarget::SDLRenderTarget(SDL_Surface* _screen, SDL_Surface* _font)
+{
+    screen = _screen;
+    font = _font;
+}
+
+void SDLRenderTarget::set_font(SDL_Surface* _font)
+{
+    font = _font;
+}
+
+void SDLRenderTarget::draw_chr(int x, int y, int chr, Uint32 color)
+{
+    drawChr(x, y, chr, font, screen, color);
+}
+
+void SDLRenderTarget::draw_str(int x, int y, const char s[], Uint32 color)
+{
+    drawStr(x, y, s, font, screen, color);
+}
+
+void SDLRenderTarget::clear_area(int x, int y, int height, int width, Uint32 color)
+{
+    clearArea(x, y, height, width, screen, color);
+}
+
+void SDLRenderTarget::flip()
+{
+    SDL_Flip(screen);
+}
@@ -0,0 +1,85 @@
+/**
+ *  RENDER_TARGET.H
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RENDER_TARGET_H
+#define RENDER_TARGET_H
+
+#include <SDL/SDL.h>
+
+/**
+ * Something that the GUI can draw characters onto.  Every position is in
+ * tiles (columns and rows), not pixels, and every color is one of the
+ * 0xRRGGBB integers from color.ini.  The GUI doesn't know or care whether
+ * it ends up in an SDL window or a terminal.
+ */
+class RenderTarget
+{
+    public:
+        virtual ~RenderTarget();
+
+        /**
+         * Draws a single character.
+         * @param x The column to draw at.
+         * @param y The row to draw at.
+         * @param chr The code page 437 index of the character.
+         * @param color The color to draw the character in.
+         */
+        virtual void draw_chr(int x, int y, int chr, Uint32 color) = 0;
+
+        /**
+         * Draws a string, starting at (x, y) and going right.
+         */
+        virtual void draw_str(int x, int y, const char s[], Uint32 color);
+
+        /**
+         * Fills a rectangle with a solid color.
+         */
+        virtual void clear_area(int x, int y, int height, int width, Uint32 color) = 0;
+
+        /**
+         * Shows everything that has been drawn since the last flip.
+         */
+        virtual void flip() = 0;
+};
+
+/**
+ * Draws using the ASCII_Lib bitmap font onto an SDL surface.
+ */
+class SDLRenderTarget : public RenderTarget
+{
+    private:
+        SDL_Surface* screen;
+        SDL_Surface* font;
+
+    public:
+        SDLRenderTarget(SDL_Surface* _screen, SDL_Surface* _font);
+
+        /**
+         * Changes the font that characters get drawn with.  Used by the
+         * font menu.
+         */
+        void set_font(SDL_Surface* _font);
+
+        void draw_chr(int x, int y, int chr, Uint32 color);
+        void draw_str(int x, int y, const char s[], Uint32 color);
+        void clear_area(int x, int y, int height, int width, Uint32 color);
+        void flip();
+};
+
+#endif
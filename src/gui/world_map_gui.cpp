@@ -39,7 +39,7 @@ void WorldMapGUI::new_world() {
 }
 
 void WorldMapGUI::refresh() {
-    MapTileMatrix raw_map = world_map.get_map();
+    const MapTileMatrix& raw_map = world_map.get_map();
     for(int i = 0; i < height; i++) {
         for(int j = 0; j < width; j++) {
             canvas[i][j] = raw_map[i][j];
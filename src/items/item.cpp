@@ -21,6 +21,16 @@
 
 #include "item.h"
 
+void* Item::operator new(size_t size)
+{
+    return ObjectPool::get("items", size).allocate();
+}
+
+void Item::operator delete(void* memory)
+{
+    ObjectPool::release(memory);
+}
+
 Item::Item()
 {
 }
@@ -23,6 +23,7 @@
 #define ITEM_H
 #include "defs.h"
 #include "int_point.h"
+#include "object_pool.h"
 
 #include <string>
 
@@ -115,6 +116,13 @@ class Item
          */
         bool can_consume;
 
+        /**
+         * Items of every kind come out of an ObjectPool, since they're
+         * made and deleted with every character and every plant drop.
+         */
+        static void* operator new(size_t size);
+        static void operator delete(void* memory);
+
         /**
          * The blank constructor.
          */
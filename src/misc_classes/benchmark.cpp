@@ -0,0 +1,1264 @@
+/**
+ *  BENCHMARK.CPP
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <map>
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include "benchmark.h"
+#include "bresenham.h"
+#include "shadowcast.h"
+#include "sight_cone.h"
+#include "path_search.h"
+#include "path_queue.h"
+#include "chunk_layer.h"
+#include "procedurally_blind_db.h"
+#include "constants.h"
+#include "route_planner.h"
+#include "ai_defs.h"
+#include "flat_tree.h"
+#include "tree_runner.h"
+#include "overworld_gen.h"
+#include "spring_matrix.h"
+#include "plant.h"
+#include "game.h"
+#include "object_pool.h"
+
+namespace pt = boost::posix_time;
+
+namespace
+{
+    std::map<std::string, benchmark::BenchmarkFunction>& registry()
+    {
+        static std::map<std::string, benchmark::BenchmarkFunction> functions;
+        if(functions.empty())
+        {
+            functions["fov"] = &benchmark::fov;
+            functions["sight"] = &benchmark::sight;
+            functions["path"] = &benchmark::path;
+            functions["route"] = &benchmark::route;
+            functions["jps"] = &benchmark::jps;
+            functions["queue"] = &benchmark::queue;
+            functions["behavior"] = &benchmark::behavior;
+            functions["schedule"] = &benchmark::schedule;
+            functions["decide"] = &benchmark::decide;
+            functions["crowd"] = &benchmark::crowd;
+            functions["spawn"] = &benchmark::spawn;
+        }
+        return functions;
+    }
+
+    long now_micros()
+    {
+        static const pt::ptime epoch = pt::microsec_clock::universal_time();
+        return (pt::microsec_clock::universal_time() - epoch).total_microseconds();
+    }
+
+    /**
+     * How many objects all of the pools have room for.
+     */
+    long pool_reserved()
+    {
+        long reserved = 0;
+        const std::vector<ObjectPool*>& pools = ObjectPool::get_pools();
+        for(size_t i = 0; i < pools.size(); i++)
+        {
+            reserved += pools[i]->get_stats().reserved;
+        }
+        return reserved;
+    }
+
+    /**
+     * A square map with the viewer in the middle and walls scattered
+     * around it.  Uses its own random numbers, so that every run gets the
+     * same map and the game's rand() isn't disturbed.
+     */
+    struct RandomWalls
+    {
+        int size;
+        std::vector<bool> walls;
+        mutable long visits;
+
+        RandomWalls(int radius, int percent)
+        {
+            size = radius * 2 + 3;
+            walls = std::vector<bool>(size * size);
+            visits = 0;
+            unsigned int seed = 12345;
+            for(int i = 0; i < size * size; i++)
+            {
+                seed = seed * 1103515245 + 12345;
+                walls[i] = (seed >> 16) % 100 < percent;
+            }
+            walls[(size / 2) * size + size / 2] = false;
+        }
+
+        bool operator()(int row, int col) const
+        {
+            visits++;
+            int r = row + size / 2;
+            int c = col + size / 2;
+            if(r < 0 || c < 0 || r >= size || c >= size)
+            {
+                return true;
+            }
+            return walls[r * size + c];
+        }
+    };
+
+    /**
+     * The old way of doing the field of view: a Bresenham line out to
+     * every point on two circles, walked until it hits a wall.
+     */
+    void ray_walk(const std::vector<std::vector<IntPoint> >& lines, const RandomWalls& walls,
+            VisibleSet& visible)
+    {
+        visible.clear();
+        for(size_t i = 0; i < lines.size(); i++)
+        {
+            for(size_t j = 1; j < lines[i].size(); j++)
+            {
+                const IntPoint& point = lines[i][j];
+                visible.set(point.row, point.col);
+                if(walls(point.row, point.col))
+                {
+                    break;
+                }
+            }
+        }
+    }
+
+    /**
+     * Counts the cells that a sight cone walk gets to.
+     */
+    struct CountCells
+    {
+        long cells;
+
+        void operator()(int row, int col)
+        {
+            cells++;
+        }
+    };
+
+    /**
+     * Passability grids for generated layers, and pairs of open tiles on
+     * them that are between half of the radius and the radius apart.
+     */
+    struct LayerQueries
+    {
+        std::vector<BitGrid> grids;
+        std::vector<int> layers;
+        std::vector<IntPoint> starts;
+        std::vector<IntPoint> goals;
+
+        void add_grid(const BitGrid& grid, int per_layer, int radius)
+        {
+            std::vector<IntPoint> open;
+            for(int row = 0; row < grid.get_height(); row++)
+            {
+                for(int col = 0; col < grid.get_width(); col++)
+                {
+                    if(grid.test(row, col))
+                    {
+                        open.push_back(IntPoint(row, col));
+                    }
+                }
+            }
+            grids.push_back(grid);
+            add_queries(grids.size() - 1, open, per_layer, radius);
+        }
+
+        void add_queries(int layer, const std::vector<IntPoint>& open, int count, int radius)
+        {
+            unsigned int seed = 54321 + layer;
+            for(int tries = 0; tries < count * 20 && open.size() > 1; tries++)
+            {
+                seed = seed * 1103515245 + 12345;
+                IntPoint start = open[(seed >> 16) % open.size()];
+                seed = seed * 1103515245 + 12345;
+                IntPoint goal = open[(seed >> 16) % open.size()];
+                int distance = std::max(std::abs(goal.row - start.row), std::abs(goal.col - start.col));
+                if(distance >= radius / 2 && distance <= radius)
+                {
+                    layers.push_back(layer);
+                    starts.push_back(start);
+                    goals.push_back(goal);
+                    if(--count == 0)
+                    {
+                        return;
+                    }
+                }
+            }
+        }
+    };
+
+    BitGrid ground_grid(ChunkLayer& layer)
+    {
+        BitGrid grid(CHUNK_HEIGHT, CHUNK_WIDTH);
+        for(int row = 0; row < CHUNK_HEIGHT; row++)
+        {
+            for(int col = 0; col < CHUNK_WIDTH; col++)
+            {
+                grid.assign(row, col, layer.get_tile(row, col).can_be_moved_through);
+            }
+        }
+        return grid;
+    }
+
+    LayerQueries dungeon_queries(int count, int per_layer, int radius)
+    {
+        LayerQueries queries;
+        //The dungeon builder uses rand(), so seed it to get the same
+        //dungeons every time, and put the clock back in afterwards.
+        srand(12345);
+        for(int i = 0; i < count; i++)
+        {
+            ChunkLayer layer(CHUNK_WIDTH, CHUNK_HEIGHT);
+            pblind_db::build_dungeon(CHUNK_WIDTH, CHUNK_HEIGHT, 5, layer);
+            queries.add_grid(ground_grid(layer), per_layer, radius);
+        }
+        srand(time(NULL));
+        return queries;
+    }
+
+    /**
+     * Forest overworld layers, with trees planted the way
+     * Chunk::build_some_dank_trees plants them.
+     */
+    LayerQueries forest_queries(int count, int per_layer, int radius)
+    {
+        LayerQueries queries;
+        srand(24680);
+        for(int i = 0; i < count; i++)
+        {
+            ChunkLayer layer(CHUNK_WIDTH, CHUNK_HEIGHT);
+            overworld_gen::build_forest_overworld(layer);
+            BitGrid grid = ground_grid(layer);
+
+            int min = 1;
+            int max = 10;
+            int tree_size = 2;
+            IntPoint trees_per_side(CHUNK_HEIGHT / ((min + max) / 2 + tree_size) + 1,
+                    CHUNK_WIDTH / ((min + max) / 2 + tree_size) + 1);
+            SpringMatrix trees(trees_per_side, tree_size, min, max, 0);
+            trees.deform_matrix(1);
+            std::vector<SpringPoint*> points = trees.get_matrix();
+            for(size_t p = 0; p < points.size(); p++)
+            {
+                int x = points[p]->get_x();
+                int y = points[p]->get_y();
+                if(!layer.in_layer(x, y) || !layer.get_tile(y, x).can_build_overtop)
+                {
+                    continue;
+                }
+                Plant tree(x, y, 0, 0, plants::tree);
+                TileMatrix* sprites = tree.get_sprites();
+                for(size_t j = 0; j < sprites->size(); j++)
+                {
+                    for(size_t k = 0; k < sprites->at(j).size(); k++)
+                    {
+                        if(!tree.get_sprite(j, k)->can_be_moved_through && grid.in_bounds(y + j, x + k))
+                        {
+                            grid.assign(y + j, x + k, false);
+                        }
+                    }
+                }
+            }
+            queries.add_grid(grid, per_layer, radius);
+        }
+        srand(time(NULL));
+        return queries;
+    }
+
+    /**
+     * What a path from PathSearch costs to walk, counting from the tile
+     * after the start.
+     */
+    int path_cost(const std::vector<IntPoint>& path, IntPoint start)
+    {
+        int cost = 0;
+        IntPoint previous = start;
+        for(int i = (int)path.size() - 1; i >= 0; i--)
+        {
+            cost += PathSearch::octile(path[i].row - previous.row, path[i].col - previous.col);
+            previous = path[i];
+        }
+        return cost;
+    }
+
+    struct SearchResults
+    {
+        double micros;
+        long expanded;
+        int found;
+        long cost;
+    };
+
+    /**
+     * Runs every query in a mode a few times over.
+     */
+    SearchResults time_searches(SearchMode mode, const LayerQueries& queries, int radius, int rounds)
+    {
+        PathSearch search;
+        SearchResults results = {0, 0, 0, 0};
+        int total = queries.starts.size();
+        long start = now_micros();
+        for(int r = 0; r < rounds; r++)
+        {
+            for(int i = 0; i < total; i++)
+            {
+                const BitGrid& grid = queries.grids[queries.layers[i]];
+                if(search.find(mode, grid, queries.starts[i], queries.goals[i], radius) && r == 0)
+                {
+                    results.found++;
+                    results.cost += path_cost(search.get_path(), queries.starts[i]);
+                }
+                results.expanded += search.get_expanded();
+            }
+        }
+        long time = now_micros() - start;
+        results.micros = total > 0 ? (double)time / (total * rounds) : 0;
+        results.expanded = total > 0 ? results.expanded / (total * rounds) : 0;
+        return results;
+    }
+
+    /**
+     * The A* the game used to have: open and closed lists that are
+     * searched from front to back, with the lists copied for every search.
+     */
+    struct ListNode
+    {
+        int parent;
+        IntPoint coords;
+        int f;
+        int g;
+        int h;
+    };
+
+    int find_in(IntPoint point, std::vector<ListNode> list)
+    {
+        for(size_t i = 0; i < list.size(); i++)
+        {
+            if(list[i].coords == point)
+            {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    std::vector<IntPoint> list_a_star(IntPoint start, IntPoint goal, const BitGrid& passable,
+            int radius, long& expanded)
+    {
+        std::vector<ListNode> open;
+        std::vector<ListNode> closed;
+        std::vector<ListNode> current_list;
+        ListNode first = {-1, start, 0, 0, 0};
+        open.push_back(first);
+        while(find_in(goal, open) == -1 && !open.empty())
+        {
+            size_t smallest = 0;
+            for(size_t i = 1; i < open.size(); i++)
+            {
+                if(open[i].f < open[smallest].f)
+                {
+                    smallest = i;
+                }
+            }
+            int cur_index = current_list.size();
+            current_list.push_back(open[smallest]);
+            open.erase(open.begin() + smallest);
+            closed.push_back(current_list[cur_index]);
+            expanded++;
+
+            IntPoint cur = current_list[cur_index].coords;
+            for(int i = cur.row - 1; i <= cur.row + 1; i++)
+            {
+                for(int j = cur.col - 1; j <= cur.col + 1; j++)
+                {
+                    bool in_range = std::abs(i - start.row) <= radius && std::abs(j - start.col) <= radius;
+                    if((i == cur.row && j == cur.col) || !in_range || !passable.test(i, j) ||
+                            find_in(IntPoint(i, j), closed) != -1)
+                    {
+                        continue;
+                    }
+                    int g = current_list[cur_index].g + ((i != cur.row && j != cur.col) ? 14 : 10);
+                    int open_index = find_in(IntPoint(i, j), open);
+                    if(open_index == -1)
+                    {
+                        int h = (std::abs(i - goal.row) + std::abs(j - goal.col)) * 10;
+                        ListNode node = {cur_index, IntPoint(i, j), g + h, g, h};
+                        open.push_back(node);
+                    }
+                    else if(g < open[open_index].g)
+                    {
+                        open[open_index].g = g;
+                        open[open_index].parent = cur_index;
+                        open[open_index].f = g + open[open_index].h;
+                    }
+                }
+            }
+        }
+
+        std::vector<IntPoint> path;
+        int index = find_in(goal, open);
+        if(index != -1)
+        {
+            ListNode current = open[index];
+            while(current.parent != -1)
+            {
+                path.push_back(current.coords);
+                current = current_list[current.parent];
+            }
+        }
+        return path;
+    }
+
+    /**
+     * Every tile of the buffer that's further than keep_away from the
+     * center and has nobody on it, a row at a time, split into the ones
+     * that can be walked on and the ones that can't.
+     */
+    void free_tiles(const BitGrid& passable, const std::vector<std::vector<CharacterHandle> >& index,
+            IntPoint center, int keep_away, std::vector<IntPoint>& open, std::vector<IntPoint>& blocked)
+    {
+        for(int row = 0; row < passable.get_height(); row++)
+        {
+            for(int col = 0; col < passable.get_width(); col++)
+            {
+                int distance = std::max(std::abs(row - center.row), std::abs(col - center.col));
+                if(distance > keep_away && Character::lookup(index[row][col]) == NULL)
+                {
+                    (passable.test(row, col) ? open : blocked).push_back(IntPoint(row, col));
+                }
+            }
+        }
+    }
+
+    int turns_taken = 0;
+
+    /**
+     * A leaf that only counts how many times it's been run, so that
+     * timing a tree with it times the scheduling and nothing else.
+     */
+    class CountTurn : public LeafNode<CountTurn>
+    {
+        public:
+            static int run(Character* chara, Game* game)
+            {
+                turns_taken++;
+                return SUCCESS;
+            }
+    };
+}
+
+std::string benchmark::names()
+{
+    std::string result;
+    std::map<std::string, BenchmarkFunction>::iterator it;
+    for(it = registry().begin(); it != registry().end(); it++)
+    {
+        result += (result.empty() ? "" : " ") + it->first;
+    }
+    return result;
+}
+
+bool benchmark::exists(const std::string& name)
+{
+    return registry().count(name) > 0;
+}
+
+std::string benchmark::run(const std::string& name, Game* game)
+{
+    if(!exists(name))
+    {
+        return "";
+    }
+    return registry()[name](game);
+}
+
+std::string benchmark::fov(Game* game)
+{
+    int radii[3] = {15, 30, 60};
+    std::stringstream summary;
+    for(int r = 0; r < 3; r++)
+    {
+        int radius = radii[r];
+        int iterations = 60000 / radius;
+        RandomWalls walls(radius, 15);
+
+        //Build the ray table the same way the game used to.
+        IntPoint center = IntPoint(0, 0);
+        std::vector<IntPoint> circle = bresenham_circle(center, radius);
+        std::vector<IntPoint> smaller = bresenham_circle(center, radius - 1);
+        circle.insert(circle.end(), smaller.begin(), smaller.end());
+        std::vector<std::vector<IntPoint> > lines;
+        for(size_t i = 0; i < circle.size(); i++)
+        {
+            lines.push_back(bresenham_line(center, circle[i]));
+        }
+
+        VisibleSet rays(radius);
+        walls.visits = 0;
+        long start = now_micros();
+        for(int i = 0; i < iterations; i++)
+        {
+            ray_walk(lines, walls, rays);
+        }
+        long ray_time = now_micros() - start;
+        long ray_visits = walls.visits / iterations;
+
+        VisibleSet shadows;
+        walls.visits = 0;
+        start = now_micros();
+        for(int i = 0; i < iterations; i++)
+        {
+            shadowcast::compute(radius, walls, shadows);
+        }
+        long shadow_time = now_micros() - start;
+        long shadow_visits = walls.visits / iterations;
+
+        double ray_each = (double)ray_time / iterations;
+        double shadow_each = (double)shadow_time / iterations;
+        std::cout << "fov radius " << radius << ": rays " << ray_each << "us, "
+            << ray_visits << " cells looked at, " << rays.count() << " visible; "
+            << "shadowcasting " << shadow_each << "us, "
+            << shadow_visits << " cells looked at, " << shadows.count() << " visible" << std::endl;
+
+        summary << (r > 0 ? " | " : "") << "r" << radius << " rays " << (long)ray_each
+            << "us shadow " << (long)shadow_each << "us";
+    }
+    return summary.str();
+}
+
+std::string benchmark::sight(Game* game)
+{
+    const int viewers = 500;
+    const int radius = 15;
+    const int view = 25;
+    RandomWalls walls(radius, 15);
+
+    //What every target search used to do: build the arc and a line out
+    //to every point on it, then look at every point on every line.
+    IntPoint center = IntPoint(0, 0);
+    long old_cells = 0;
+    long start = now_micros();
+    for(int i = 0; i < viewers; i++)
+    {
+        int direction = (i * 7) % 100;
+        IntPoint bounds = IntPoint(direction + view / 2, direction - view / 2);
+        std::vector<IntPoint> arc = bresenham_arc(center, radius, bounds);
+        std::vector<IntPoint> points;
+        for(size_t j = 0; j < arc.size(); j++)
+        {
+            std::vector<IntPoint> line = bresenham_line(center, arc[j]);
+            points.insert(points.end(), line.begin(), line.end());
+        }
+        for(size_t j = 0; j < points.size(); j++)
+        {
+            walls(points[j].row, points[j].col);
+        }
+        old_cells += points.size();
+    }
+    long old_time = now_micros() - start;
+
+    //The first pass builds the tables, so time that separately.
+    std::vector<unsigned char> scratch;
+    CountCells counter = {0};
+    start = now_micros();
+    for(int i = 0; i < viewers; i++)
+    {
+        sight_cone::trace(sight_cone::get(radius, (i * 7) % 100, view), walls, scratch, counter);
+    }
+    long build_time = now_micros() - start;
+
+    counter.cells = 0;
+    start = now_micros();
+    for(int i = 0; i < viewers; i++)
+    {
+        sight_cone::trace(sight_cone::get(radius, (i * 7) % 100, view), walls, scratch, counter);
+    }
+    long cone_time = now_micros() - start;
+
+    std::cout << "sight, " << viewers << " viewers at radius " << radius << " and view " << view
+        << ": arcs " << old_time << "us, " << old_cells / viewers << " cells each; "
+        << "cones " << cone_time << "us (" << build_time << "us with building the tables), "
+        << counter.cells / viewers << " visible cells each" << std::endl;
+
+    std::stringstream summary;
+    summary << viewers << " viewers: arcs " << old_time << "us cones " << cone_time
+        << "us (first " << build_time << "us)";
+    return summary.str();
+}
+
+std::string benchmark::path(Game* game)
+{
+    const int radius = 20;
+    LayerQueries queries = dungeon_queries(8, 40, radius);
+    int total = queries.starts.size();
+    //The list version is slow enough that it only gets some of them.
+    int list_total = std::min(total, 40);
+
+    long list_expanded = 0;
+    int list_found = 0;
+    long start = now_micros();
+    for(int i = 0; i < list_total; i++)
+    {
+        const BitGrid& grid = queries.grids[queries.layers[i]];
+        list_found += !list_a_star(queries.starts[i], queries.goals[i], grid, radius, list_expanded).empty();
+    }
+    long list_time = now_micros() - start;
+
+    PathSearch search;
+    long heap_expanded = 0;
+    int heap_found = 0;
+    const int rounds = 10;
+    start = now_micros();
+    for(int r = 0; r < rounds; r++)
+    {
+        for(int i = 0; i < total; i++)
+        {
+            const BitGrid& grid = queries.grids[queries.layers[i]];
+            heap_found += search.a_star(grid, queries.starts[i], queries.goals[i], radius);
+            heap_expanded += search.get_expanded();
+        }
+    }
+    long heap_time = now_micros() - start;
+
+    double list_each = list_total > 0 ? (double)list_time / list_total : 0;
+    double heap_each = total > 0 ? (double)heap_time / (total * rounds) : 0;
+    std::cout << "path, " << queries.grids.size() << " dungeon layers, radius " << radius << ": "
+        << "lists " << list_each << "us each, " << (list_total > 0 ? list_expanded / list_total : 0)
+        << " expanded, " << list_found << "/" << list_total << " found; "
+        << "heap " << heap_each << "us each, " << (total > 0 ? heap_expanded / (total * rounds) : 0)
+        << " expanded, " << heap_found / rounds << "/" << total << " found" << std::endl;
+
+    std::stringstream summary;
+    summary << total << " paths: lists " << (long)list_each << "us heap " << (long)heap_each << "us";
+    return summary.str();
+}
+
+std::string benchmark::route(Game* game)
+{
+    //Load a patch of chunks around the spot with the most land in the
+    //world, so the routes don't depend on where the main character is.
+    const int diameter = 5;
+    const int reach = diameter / 2;
+    std::vector<std::vector<MapTile> >& world = game->world_map.get_map();
+    IntPoint center = IntPoint(reach, reach);
+    int most_land = -1;
+    for(int i = reach; i + reach < (int)world.size(); i++)
+    {
+        for(int j = reach; j + reach < (int)world[i].size(); j++)
+        {
+            int land = 0;
+            for(int a = -reach; a <= reach; a++)
+            {
+                for(int b = -reach; b <= reach; b++)
+                {
+                    land += !(world[i + a][j + b] == map_tile::MAP_WATER);
+                }
+            }
+            if(land > most_land)
+            {
+                most_land = land;
+                center = IntPoint(i, j);
+            }
+        }
+    }
+    ChunkMatrix chunks(diameter, center, world, "");
+    IntPoint offset = chunks.get_offset();
+    const int depth = 0;
+
+    //All of the chunks in one grid, for PathSearch.
+    BitGrid whole(CHUNK_HEIGHT * diameter, CHUNK_WIDTH * diameter);
+    std::vector<IntPoint> open;
+    for(int i = 0; i < diameter; i++)
+    {
+        for(int j = 0; j < diameter; j++)
+        {
+            const ChunkPortals* portals = chunks.get_chunk_abs(offset.row + i, offset.col + j)->get_portals(depth);
+            if(portals == NULL)
+            {
+                continue;
+            }
+            const BitGrid& passable = portals->get_passable();
+            for(int row = 0; row < CHUNK_HEIGHT; row++)
+            {
+                for(int col = 0; col < CHUNK_WIDTH; col++)
+                {
+                    if(passable.test(row, col))
+                    {
+                        whole.assign(i * CHUNK_HEIGHT + row, j * CHUNK_WIDTH + col, true);
+                        open.push_back(IntPoint(i * CHUNK_HEIGHT + row, j * CHUNK_WIDTH + col));
+                    }
+                }
+            }
+        }
+    }
+    if(open.size() < 2)
+    {
+        std::cout << "route: no open tiles to plan routes between" << std::endl;
+        return "no open tiles";
+    }
+
+    //Pairs of open tiles at least a chunk apart.
+    std::vector<IntPoint> starts;
+    std::vector<IntPoint> goals;
+    unsigned int seed = 777;
+    for(int tries = 0; tries < 10000 && starts.size() < 100; tries++)
+    {
+        seed = seed * 1103515245 + 12345;
+        IntPoint start = open[(seed >> 16) % open.size()];
+        seed = seed * 1103515245 + 12345;
+        IntPoint goal = open[(seed >> 16) % open.size()];
+        if(std::abs(start.col - goal.col) >= CHUNK_WIDTH || std::abs(start.row - goal.row) >= CHUNK_HEIGHT)
+        {
+            starts.push_back(start);
+            goals.push_back(goal);
+        }
+    }
+
+    RoutePlanner planner;
+    long route_expanded = 0;
+    long route_stops = 0;
+    int route_found = 0;
+    long start_time = now_micros();
+    for(size_t i = 0; i < starts.size(); i++)
+    {
+        RouteStop from = {IntPoint(offset.row + starts[i].row / CHUNK_HEIGHT, offset.col + starts[i].col / CHUNK_WIDTH),
+            IntPoint(starts[i].row % CHUNK_HEIGHT, starts[i].col % CHUNK_WIDTH), depth};
+        RouteStop to = {IntPoint(offset.row + goals[i].row / CHUNK_HEIGHT, offset.col + goals[i].col / CHUNK_WIDTH),
+            IntPoint(goals[i].row % CHUNK_HEIGHT, goals[i].col % CHUNK_WIDTH), depth};
+        if(planner.plan(chunks, from, to, false))
+        {
+            route_found++;
+            route_stops += planner.get_route().size();
+        }
+        route_expanded += planner.get_expanded();
+    }
+    long route_time = now_micros() - start_time;
+
+    PathSearch search;
+    long tile_expanded = 0;
+    int tile_found = 0;
+    int radius = std::max(CHUNK_HEIGHT, CHUNK_WIDTH) * diameter;
+    start_time = now_micros();
+    for(size_t i = 0; i < starts.size(); i++)
+    {
+        tile_found += search.a_star(whole, starts[i], goals[i], radius);
+        tile_expanded += search.get_expanded();
+    }
+    long tile_time = now_micros() - start_time;
+
+    int count = starts.size();
+    std::cout << "route, " << count << " routes over " << diameter << "x" << diameter << " chunks around "
+        << center << ": "
+        << "portals " << route_time / count << "us each, " << route_expanded / count << " expanded, "
+        << route_found << " found, " << (route_found > 0 ? route_stops / route_found : 0) << " stops; "
+        << "tiles " << tile_time / count << "us each, " << tile_expanded / count << " expanded, "
+        << tile_found << " found" << std::endl;
+
+    std::stringstream summary;
+    summary << count << " routes: portals " << route_time / count << "us tiles " << tile_time / count << "us";
+    return summary.str();
+}
+
+std::string benchmark::jps(Game* game)
+{
+    const int radius = 40;
+    const int rounds = 10;
+    std::string names[2] = {"dungeon", "forest"};
+    LayerQueries queries[2] = {dungeon_queries(8, 50, radius), forest_queries(8, 50, radius)};
+
+    std::stringstream summary;
+    for(int q = 0; q < 2; q++)
+    {
+        SearchResults a_star = time_searches(PATH_A_STAR, queries[q], radius, rounds);
+        SearchResults jump = time_searches(PATH_JUMP_POINT, queries[q], radius, rounds);
+        int total = queries[q].starts.size();
+        std::cout << "jps, " << queries[q].grids.size() << " " << names[q] << " layers, "
+            << total << " paths, radius " << radius << ": "
+            << "a* " << a_star.micros << "us each, " << a_star.expanded << " expanded, "
+            << a_star.found << " found; "
+            << "jps " << jump.micros << "us each, " << jump.expanded << " expanded, "
+            << jump.found << " found; "
+            << "total cost " << a_star.cost << " vs " << jump.cost << std::endl;
+
+        summary << (q > 0 ? ", " : "") << names[q] << " a* " << (long)a_star.micros << "us/"
+            << a_star.expanded << " jps " << (long)jump.micros << "us/" << jump.expanded;
+    }
+    return summary.str();
+}
+
+std::string benchmark::queue(Game* game)
+{
+    //Lay the dungeons out side by side as one grid, the way the buffer
+    //holds several chunks.
+    const int radius = 40;
+    LayerQueries queries = dungeon_queries(8, 50, radius);
+    BitGrid grid(CHUNK_HEIGHT * 2, CHUNK_WIDTH * 4);
+    for(size_t l = 0; l < queries.grids.size(); l++)
+    {
+        for(int row = 0; row < CHUNK_HEIGHT; row++)
+        {
+            for(int col = 0; col < CHUNK_WIDTH; col++)
+            {
+                grid.assign((l / 4) * CHUNK_HEIGHT + row, (l % 4) * CHUNK_WIDTH + col,
+                        queries.grids[l].test(row, col));
+            }
+        }
+    }
+    std::vector<IntPoint> starts;
+    std::vector<IntPoint> goals;
+    for(size_t i = 0; i < queries.starts.size(); i++)
+    {
+        IntPoint offset((queries.layers[i] / 4) * CHUNK_HEIGHT, (queries.layers[i] % 4) * CHUNK_WIDTH);
+        starts.push_back(queries.starts[i] + offset);
+        goals.push_back(queries.goals[i] + offset);
+    }
+    int total = starts.size();
+
+    PathSearch search;
+    std::vector<std::vector<IntPoint> > expected(total);
+    long start = now_micros();
+    for(int i = 0; i < total; i++)
+    {
+        if(search.find(PATH_JUMP_POINT, grid, starts[i], goals[i], radius))
+        {
+            expected[i] = search.get_path();
+        }
+    }
+    long sync_time = now_micros() - start;
+
+    std::stringstream summary;
+    summary << total << " paths: inline " << sync_time << "us";
+    std::cout << "queue, " << total << " paths on " << grid.get_height() << "x" << grid.get_width()
+        << " tiles, radius " << radius << ": inline " << sync_time << "us" << std::endl;
+
+    int thread_counts[2] = {1, 0};
+    for(int t = 0; t < 2; t++)
+    {
+        PathQueue queue(thread_counts[t]);
+        start = now_micros();
+        for(int i = 0; i < total; i++)
+        {
+            queue.submit(starts[i], goals[i], 0, radius, PATH_JUMP_POINT);
+        }
+        queue.dispatch(grid, 0, 1);
+        long frame_time = now_micros() - start;
+        queue.wait();
+        std::vector<PathResult> results;
+        queue.collect(results);
+        long batch_time = now_micros() - start;
+
+        int different = 0;
+        for(int i = 0; i < total; i++)
+        {
+            if(results[i].path.size() != expected[i].size() ||
+                    !std::equal(expected[i].begin(), expected[i].end(), results[i].path.begin(),
+                        [](IntPoint a, IntPoint b){ return a == b; }))
+            {
+                different++;
+            }
+        }
+        std::cout << "  " << queue.get_threads() << " workers: " << frame_time
+            << "us on the main thread, " << batch_time << "us until collected, "
+            << different << " different from inline" << std::endl;
+        summary << ", " << queue.get_threads() << " workers " << frame_time << "/" << batch_time << "us";
+    }
+    return summary.str();
+}
+
+std::string benchmark::behavior(Game* game)
+{
+    const int wanted = 10000;
+    const int rounds = 5;
+    const int keep_away = 40;
+
+    IntPoint center = game->get_buffer_coords(game->main_char.get_chunk(), game->main_char.get_coords());
+    //Open tiles first, and then anywhere free if there aren't enough, so
+    //that an all water buffer still gets its actors.
+    std::vector<IntPoint> open;
+    std::vector<IntPoint> blocked;
+    free_tiles(game->buffer_passable, game->character_index, center, keep_away, open, blocked);
+    unsigned int seed = 8675309;
+    std::vector<IntPoint>* lists[2] = {&open, &blocked};
+    for(int l = 0; l < 2; l++)
+    {
+        std::vector<IntPoint>& tiles = *lists[l];
+        for(int i = (int)tiles.size() - 1; i > 0; i--)
+        {
+            seed = seed * 1103515245 + 12345;
+            std::swap(tiles[i], tiles[(seed >> 16) % (i + 1)]);
+        }
+    }
+    open.insert(open.end(), blocked.begin(), blocked.end());
+
+    std::vector<BActor> actors;
+    IntPoint main_chunk = game->main_char.get_chunk();
+    int depth = game->main_char.get_depth();
+    for(int i = 0; i < wanted && i < (int)open.size(); i++)
+    {
+        IntPoint tile = open[i];
+        Enemy* enemy = new Enemy(tile.col % CHUNK_WIDTH, tile.row % CHUNK_HEIGHT, depth, kobold);
+        enemy->set_chunk(main_chunk + IntPoint(tile.row / CHUNK_HEIGHT - game->buffer_radius,
+                    tile.col / CHUNK_WIDTH - game->buffer_radius));
+        game->list_character(enemy);
+        game->character_to_index(enemy);
+        actors.push_back(BActor(enemy));
+    }
+    long ticks = (long)actors.size() * rounds;
+
+    BNode* root = ai::build("GENERIC_AGGRESSIVE");
+    FlatTree tree(root);
+    std::vector<FlatTree::Frame> stack;
+    long start = now_micros();
+    for(int r = 0; r < rounds; r++)
+    {
+        for(size_t i = 0; i < actors.size(); i++)
+        {
+            root->tick(actors[i], game);
+        }
+    }
+    long node_time = now_micros() - start;
+    start = now_micros();
+    for(int r = 0; r < rounds; r++)
+    {
+        for(size_t i = 0; i < actors.size(); i++)
+        {
+            tree.run(actors[i].get_character(), game, stack);
+        }
+    }
+    long flat_time = now_micros() - start;
+    delete root;
+
+    for(int i = (int)actors.size() - 1; i >= 0; i--)
+    {
+        game->remove_enemy(actors[i].get_character());
+    }
+
+    double node_rate = node_time > 0 ? ticks * 1000000.0 / node_time : 0;
+    double flat_rate = flat_time > 0 ? ticks * 1000000.0 / flat_time : 0;
+    std::cout << "behavior, " << actors.size() << " actors on GENERIC_AGGRESSIVE ("
+        << tree.size() << " nodes), " << rounds << " rounds: nodes " << node_time << "us, "
+        << (long)node_rate << " ticks/s; flat " << flat_time << "us, "
+        << (long)flat_rate << " ticks/s" << std::endl;
+
+    std::stringstream summary;
+    summary << actors.size() << " actors: nodes " << (long)node_rate << " ticks/s, flat "
+        << (long)flat_rate << " ticks/s";
+    return summary.str();
+}
+
+std::string benchmark::schedule(Game* game)
+{
+    const int count = 10000;
+    const long game_ms = 70000;
+    //The game's frame, GUI::STD_MS_PER_FRAME, and a much shorter one,
+    //where most actors sit out most frames.
+    const long frame_lengths[2] = {70, 10};
+
+    std::stringstream summary;
+    summary << count << " actors:";
+    for(int l = 0; l < 2; l++)
+    {
+        long frame_ms = frame_lengths[l];
+        int frames = game_ms / frame_ms;
+
+        //Two of each, so that each way starts with the same timers.
+        //They're kept as Characters to be deleted the same way the game
+        //does.
+        std::vector<Character*> polled;
+        std::vector<Character*> wheeled;
+        EnemyType types[4] = {enemies::kobold, enemies::rabbit, enemies::wolf_companion, enemies::human};
+        for(int i = 0; i < count; i++)
+        {
+            EnemyType type = types[i % 4];
+            polled.push_back(new Enemy(0, 0, 0, type));
+            wheeled.push_back(new Enemy(0, 0, 0, type));
+        }
+
+        BNode* counter = new CountTurn;
+        FlatTree tree(counter);
+        delete counter;
+        std::vector<FlatTree::Frame> stack;
+        std::vector<BActor> actors;
+        for(int i = 0; i < count; i++)
+        {
+            actors.push_back(BActor(polled[i]));
+        }
+        turns_taken = 0;
+        long start = now_micros();
+        for(int f = 0; f < frames; f++)
+        {
+            //What run_actors used to do: ask every actor, every frame.
+            for(size_t i = 0; i < actors.size(); i++)
+            {
+                if(actors[i].should_tick(frame_ms))
+                {
+                    actors[i].check_interrupts();
+                    tree.run(actors[i].get_character(), game, stack, actors[i].get_running_node());
+                }
+            }
+        }
+        long poll_time = now_micros() - start;
+        int poll_turns = turns_taken;
+
+        BehaviorTree scheduled(new CountTurn, game, -1);
+        for(int i = 0; i < count; i++)
+        {
+            scheduled.add_actor(BActor(wheeled[i]));
+        }
+        turns_taken = 0;
+        start = now_micros();
+        for(int f = 0; f < frames; f++)
+        {
+            scheduled.run_actors(frame_ms);
+        }
+        long wheel_time = now_micros() - start;
+        int wheel_turns = turns_taken;
+
+        for(int i = 0; i < count; i++)
+        {
+            delete polled[i];
+            delete wheeled[i];
+        }
+
+        std::cout << "schedule, " << count << " actors for " << frames << " frames of "
+            << frame_ms << "ms: polling " << poll_time << "us for " << poll_turns
+            << " turns (" << (long)count * frames << " actors looked at), wheel "
+            << wheel_time << "us for " << wheel_turns << " turns" << std::endl;
+        summary << " " << frame_ms << "ms frames polling " << poll_time << "us, wheel "
+            << wheel_time << "us" << (l == 0 ? ";" : "");
+    }
+    return summary.str();
+}
+
+std::string benchmark::decide(Game* game)
+{
+    const int wanted = 5000;
+    const int frames = 100;
+    const long frame_ms = 70;
+    const int keep_away = 40;
+    const int worker_counts[3] = {1, 2, 4};
+
+    //The tiles aren't shuffled, so the actors are packed in rows and keep
+    //trying to step into the same places.
+    IntPoint center = game->get_buffer_coords(game->main_char.get_chunk(), game->main_char.get_coords());
+    std::vector<IntPoint> open;
+    std::vector<IntPoint> blocked;
+    free_tiles(game->buffer_passable, game->character_index, center, keep_away, open, blocked);
+    IntPoint main_chunk = game->main_char.get_chunk();
+    int depth = game->main_char.get_depth();
+
+    std::stringstream summary;
+    int placed = std::min(wanted, (int)open.size());
+    summary << placed << " actors:";
+    unsigned long first_hash = 0;
+    bool same = true;
+    for(int w = 0; w < 3; w++)
+    {
+        std::vector<Character*> added;
+        std::vector<BehaviorTree> trees;
+        trees.push_back(ai::tree("GENERIC_AGGRESSIVE", game));
+        for(int i = 0; i < placed; i++)
+        {
+            IntPoint tile = open[i];
+            Enemy* enemy = new Enemy(tile.col % CHUNK_WIDTH, tile.row % CHUNK_HEIGHT, depth, enemies::kobold);
+            enemy->set_chunk(main_chunk + IntPoint(tile.row / CHUNK_HEIGHT - game->buffer_radius,
+                        tile.col / CHUNK_WIDTH - game->buffer_radius));
+            game->list_character(enemy);
+            game->character_to_index(enemy);
+            trees[0].add_actor(BActor(enemy));
+            added.push_back(enemy);
+        }
+
+        //Waiting for the paths every frame keeps them from coming back
+        //at different times in different runs.
+        TreeRunner runner(worker_counts[w]);
+        long start = now_micros();
+        for(int f = 0; f < frames; f++)
+        {
+            game->collect_paths();
+            runner.run(trees, game, frame_ms);
+            game->dispatch_paths();
+            game->path_queue.wait();
+        }
+        long time = now_micros() - start;
+        game->collect_paths();
+
+        unsigned long hash = 14695981039346656037UL;
+        for(int i = 0; i < placed; i++)
+        {
+            IntPoint where = utility::get_abs(added[i]->get_chunk(), added[i]->get_coords());
+            hash = (hash ^ (unsigned int)where.row) * 1099511628211UL;
+            hash = (hash ^ (unsigned int)where.col) * 1099511628211UL;
+        }
+        if(w == 0)
+        {
+            first_hash = hash;
+        }
+        same = same && hash == first_hash;
+
+        for(int i = placed - 1; i >= 0; i--)
+        {
+            game->remove_enemy(added[i]);
+        }
+
+        std::cout << "decide, " << placed << " actors on GENERIC_AGGRESSIVE for " << frames
+            << " frames with " << runner.get_workers() << " workers: " << time << "us, state "
+            << std::hex << hash << std::dec << std::endl;
+        summary << " " << runner.get_workers() << "w " << time << "us";
+    }
+    summary << (same ? ", same every time" : ", DIFFERENT");
+    return summary.str();
+}
+
+std::string benchmark::crowd(Game* game)
+{
+    const int count = 100000;
+    const int rounds = 20;
+
+    int diameter = game->buffer_radius * 2 + 1;
+    IntPoint main_chunk = game->main_char.get_chunk();
+    int depth = game->main_char.get_depth();
+    unsigned int seed = 12345;
+    std::vector<Character*> added;
+    for(int i = 0; i < count; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        int row = (seed >> 8) % (CHUNK_HEIGHT * diameter);
+        seed = seed * 1103515245 + 12345;
+        int col = (seed >> 8) % (CHUNK_WIDTH * diameter);
+        Enemy* enemy = new Enemy(col % CHUNK_WIDTH, row % CHUNK_HEIGHT, depth + i % 2, enemies::kobold);
+        enemy->set_chunk(main_chunk + IntPoint(row / CHUNK_HEIGHT - game->buffer_radius,
+                    col / CHUNK_WIDTH - game->buffer_radius));
+        game->list_character(enemy);
+        added.push_back(enemy);
+    }
+
+    //What update_character_index and get_vis_characters used to do.
+    std::vector<Character*>& characters = game->character_list;
+    int object_visible = 0;
+    long start = now_micros();
+    for(int r = 0; r < rounds; r++)
+    {
+        game->clear_character_index();
+        for(size_t i = 0; i < characters.size(); i++)
+        {
+            if(game->point_in_buffer(characters[i]->get_chunk(), characters[i]->get_coords()))
+            {
+                game->character_to_index(characters[i]);
+            }
+        }
+        game->character_to_index(&game->main_char);
+
+        object_visible = 0;
+        IntPoint main_char_coords = game->main_char.get_coords();
+        IntPoint radius = IntPoint((game->view_height * game->zoom) / 2, (game->view_width * game->zoom) / 2);
+        for(size_t i = 0; i < characters.size(); i++)
+        {
+            if(utility::in_range(characters[i]->get_chunk(), characters[i]->get_coords(), main_chunk,
+                        main_char_coords, radius) && characters[i]->get_depth() == depth)
+            {
+                object_visible++;
+            }
+        }
+    }
+    long object_time = now_micros() - start;
+    std::vector<std::vector<CharacterHandle> > object_index = game->character_index;
+
+    int stream_visible = 0;
+    start = now_micros();
+    for(int r = 0; r < rounds; r++)
+    {
+        game->update_character_index();
+        stream_visible = game->get_vis_characters().size();
+    }
+    long stream_time = now_micros() - start;
+    bool same = object_index == game->character_index && object_visible == stream_visible;
+
+    for(int i = count - 1; i >= 0; i--)
+    {
+        game->unlist_character(added[i]);
+        delete added[i];
+    }
+    game->update_character_index();
+
+    std::cout << "crowd, " << count << " characters, index and visible characters " << rounds
+        << " times: each character " << object_time << "us, store arrays " << stream_time << "us, "
+        << stream_visible << " visible" << (same ? "" : ", DIFFERENT") << std::endl;
+    std::stringstream summary;
+    summary << count << " characters: each character " << object_time << "us, store arrays "
+        << stream_time << "us" << (same ? "" : ", DIFFERENT");
+    return summary.str();
+}
+
+std::string benchmark::spawn(Game* game)
+{
+    const int count = 5000;
+    const int bursts = 10;
+
+    long reserved_after_first = 0;
+    long first_time = 0;
+    long rest_time = 0;
+    EnemyType types[4] = {enemies::kobold, enemies::rabbit, enemies::wolf_companion, enemies::human};
+    for(int b = 0; b < bursts; b++)
+    {
+        long start = now_micros();
+        //Deleted as Characters, the way the game does it.
+        std::vector<Character*> burst;
+        for(int i = 0; i < count * 4; i++)
+        {
+            burst.push_back(new Enemy(0, 0, 0, types[i % 4]));
+        }
+        for(int i = 0; i < (int)burst.size(); i++)
+        {
+            delete burst[i];
+        }
+        long time = now_micros() - start;
+
+        long reserved = pool_reserved();
+        if(b == 0)
+        {
+            first_time = time;
+            reserved_after_first = reserved;
+        }
+        else
+        {
+            rest_time += time;
+        }
+        std::cout << "spawn, burst " << b << " of " << count * 4 << " enemies: " << time << "us, "
+            << reserved << " objects reserved in the pools" << std::endl;
+    }
+    std::cout << ObjectPool::report();
+
+    long reserved = pool_reserved();
+    std::stringstream summary;
+    summary << count * 4 << " enemies a burst: first " << first_time << "us, then "
+        << rest_time / (bursts - 1) << "us each, " << reserved - reserved_after_first
+        << " more reserved after the first";
+    return summary.str();
+}
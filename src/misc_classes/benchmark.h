@@ -0,0 +1,138 @@
+/**
+ *  BENCHMARK.H
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <string>
+#include <vector>
+
+class Game;
+
+/**
+ * Benchmarks that can be run from the debug console with "bench <name>".
+ * Each one returns a single line of results short enough to fit in the
+ * console, and prints the full results to stdout.
+ */
+namespace benchmark
+{
+    typedef std::string (*BenchmarkFunction)(Game* game);
+
+    /**
+     * The names of all of the benchmarks, separated by spaces.
+     */
+    std::string names();
+
+    bool exists(const std::string& name);
+
+    /**
+     * Runs the benchmark with the given name.
+     * @return The results, or an empty string if there's no such benchmark.
+     */
+    std::string run(const std::string& name, Game* game);
+
+    /**
+     * Compares the Bresenham ray walk that the field of view used to use
+     * with shadowcasting, at radii 15, 30 and 60, on a map with walls
+     * scattered around at random.
+     */
+    std::string fov(Game* game);
+
+    /**
+     * Compares building a sight arc and lines for every target search with
+     * walking the precomputed sight cones, for 500 viewers facing different
+     * ways.
+     */
+    std::string sight(Game* game);
+
+    /**
+     * Compares the old A*, which kept its open and closed lists in plain
+     * vectors, with PathSearch, on paths between open tiles of generated
+     * dungeon layers.
+     */
+    std::string path(Game* game);
+
+    /**
+     * Loads the 5x5 chunks with the most land in the world, and plans
+     * routes between open tiles at least a chunk apart, with the chunk
+     * portals and with PathSearch over all of the chunks at once.
+     */
+    std::string route(Game* game);
+
+    /**
+     * Compares A* with jump point search on paths between open tiles of
+     * generated dungeon layers and forest overworlds, counting how many
+     * tiles each one expands as well as how long it takes.
+     */
+    std::string jps(Game* game);
+
+    /**
+     * Finds a batch of paths across dungeon layers laid side by side,
+     * first inline and then through a PathQueue with one worker and
+     * with the default number, and checks that every worker count gives
+     * the same paths.
+     */
+    std::string queue(Game* game);
+
+    /**
+     * Puts 10000 actors on free tiles of the buffer, far enough from the
+     * main character that they can't reach it, and runs GENERIC_AGGRESSIVE
+     * on every one of them a few times, first by ticking the nodes and
+     * then with the compiled FlatTree.  The actors are taken out again
+     * afterwards.
+     */
+    std::string behavior(Game* game);
+
+    /**
+     * Gives 10000 actors of every enemy type a tree that does nothing,
+     * and runs them for 70 seconds of game time, first by asking every
+     * actor every frame whether it's time for it to act, and then with
+     * the timing wheel in BehaviorTree.  It's done once with the game's
+     * frame length and once with a much shorter one.
+     */
+    std::string schedule(Game* game);
+
+    /**
+     * Packs 5000 kobolds in rows on the open tiles of the buffer, away
+     * from the main character, and runs them on GENERIC_AGGRESSIVE for
+     * 100 frames through a TreeRunner with 1, 2 and 4 workers.  Checks
+     * that every kobold ends up in the same place whatever the number of
+     * workers.
+     */
+    std::string decide(Game* game);
+
+    /**
+     * Scatters 100000 kobolds over the buffer, half of them on the main
+     * character's depth, and builds the character index and finds the
+     * visible characters 20 times each: once by asking every character in
+     * the list for its position, and once with the game's own loops, which
+     * read the CharacterStore's arrays.  Checks that both find the same.
+     */
+    std::string crowd(Game* game);
+
+    /**
+     * Makes and deletes 5000 enemies of every type, with their corpses
+     * and equipment, 10 times over, and times each burst.  After the first
+     * one the pools are nearly big enough, and only grow when a burst
+     * happens to hand out more equipment than any before it.
+     */
+    std::string spawn(Game* game);
+}
+
+#endif
@@ -0,0 +1,110 @@
+/**
+ *  BIT_GRID.CPP
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include "bit_grid.h"
+
+BitGrid::BitGrid()
+{
+    resize(0, 0);
+}
+
+BitGrid::BitGrid(int _height, int _width)
+{
+    resize(_height, _width);
+}
+
+void BitGrid::resize(int _height, int _width)
+{
+    height = _height;
+    width = _width;
+    words_per_row = (width + 63) / 64;
+    words = std::vector<uint64_t>(height * words_per_row);
+}
+
+void BitGrid::clear()
+{
+    std::fill(words.begin(), words.end(), 0);
+}
+
+int BitGrid::get_height() const
+{
+    return height;
+}
+
+int BitGrid::get_width() const
+{
+    return width;
+}
+
+int BitGrid::get_words_per_row() const
+{
+    return words_per_row;
+}
+
+const uint64_t* BitGrid::row_words(int row) const
+{
+    return &words[row * words_per_row];
+}
+
+uint64_t BitGrid::get_bits(int row, int col) const
+{
+    if(row < 0 || row >= height || col >= width || col <= -64)
+    {
+        return 0;
+    }
+    if(col < 0)
+    {
+        return get_bits(row, 0) << -col;
+    }
+
+    const uint64_t* current = row_words(row);
+    int word = col >> 6;
+    int shift = col & 63;
+    uint64_t bits = current[word] >> shift;
+    if(shift != 0 && word + 1 < words_per_row)
+    {
+        bits |= current[word + 1] << (64 - shift);
+    }
+    return bits;
+}
+
+unsigned int BitGrid::neighborhood(int row, int col) const
+{
+    unsigned int above = get_bits(row - 1, col - 1) & 7;
+    unsigned int middle = get_bits(row, col - 1) & 7;
+    unsigned int below = get_bits(row + 1, col - 1) & 7;
+    return above | (middle << 3) | (below << 6);
+}
+
+bool BitGrid::row_clear(int row, int first_col, int last_col) const
+{
+    first_col = std::max(first_col, 0);
+    last_col = std::min(last_col, width - 1);
+    for(int col = first_col; col <= last_col; col += 64)
+    {
+        int count = std::min(64, last_col - col + 1);
+        uint64_t mask = count == 64 ? ~(uint64_t)0 : (((uint64_t)1 << count) - 1);
+        if(get_bits(row, col) & mask)
+        {
+            return false;
+        }
+    }
+    return true;
+}
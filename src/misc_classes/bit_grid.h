@@ -0,0 +1,112 @@
+/**
+ *  BIT_GRID.H
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BIT_GRID_H
+#define BIT_GRID_H
+
+#include <vector>
+#include <stdint.h>
+
+/**
+ * A grid of bits where every row starts on a fresh 64-bit word, so a row
+ * can be handed out as a plain array of words.  The game keeps one of
+ * these for which tiles of the buffer block light and one for which can
+ * be walked through, so that the field of view, pathfinding and the AI
+ * can test 64 tiles at once instead of following a Tile* for every one.
+ *
+ * Bits past the end of a row are always 0.
+ */
+class BitGrid
+{
+    private:
+        int height;
+        int width;
+        int words_per_row;
+        std::vector<uint64_t> words;
+
+    public:
+        BitGrid();
+        BitGrid(int _height, int _width);
+
+        /**
+         * Changes the size of the grid and turns every bit off.
+         */
+        void resize(int _height, int _width);
+
+        /**
+         * Turns every bit off.
+         */
+        void clear();
+
+        int get_height() const;
+        int get_width() const;
+        int get_words_per_row() const;
+
+        /**
+         * The words_per_row words that make up a row.  Bit i of word w is
+         * the tile in column w * 64 + i.
+         */
+        const uint64_t* row_words(int row) const;
+
+        /**
+         * The 64 tiles of a row starting at col, with bit 0 being col.
+         * col can be negative, and anything off the edge of the grid comes
+         * back as 0.
+         */
+        uint64_t get_bits(int row, int col) const;
+
+        /**
+         * The 3x3 block of tiles centered on (row, col) as 9 bits, a row at
+         * a time from the top left.  Bit 4 is (row, col) itself, and bit
+         * (dr + 1) * 3 + (dc + 1) is (row + dr, col + dc).
+         */
+        unsigned int neighborhood(int row, int col) const;
+
+        /**
+         * True if every bit from first_col to last_col (inclusive) of a row
+         * is off.  Off the edge counts as off.
+         */
+        bool row_clear(int row, int first_col, int last_col) const;
+
+        bool in_bounds(int row, int col) const
+        {
+            return row >= 0 && col >= 0 && row < height && col < width;
+        }
+
+        /**
+         * Whether the bit at (row, col) is on.  Off the edge is off.
+         */
+        bool test(int row, int col) const
+        {
+            if(!in_bounds(row, col))
+            {
+                return false;
+            }
+            return (words[row * words_per_row + (col >> 6)] >> (col & 63)) & 1;
+        }
+
+        void assign(int row, int col, bool value)
+        {
+            uint64_t& word = words[row * words_per_row + (col >> 6)];
+            uint64_t bit = (uint64_t)1 << (col & 63);
+            word = value ? (word | bit) : (word & ~bit);
+        }
+};
+
+#endif
@@ -39,4 +39,19 @@ static const int WORLD_HEIGHT = 50;
 
 static const int MESSAGE_HEIGHT = 49;
 
+/**
+ * How far the shared maps that characters use to chase or run from a
+ * target reach out from the target.
+ */
+static const int FLOW_FIELD_RADIUS = 40;
+
+/**
+ * How far, in tiles, a character can be from the main character and still
+ * get the full attention of the AI.  Anyone further away than that, or on
+ * another layer, is only thought about every COARSE_AI_RATE turns and
+ * heads straight for wherever it's going instead of finding a path.
+ */
+static const int FULL_AI_RANGE = 60;
+static const int COARSE_AI_RATE = 4;
+
 #endif
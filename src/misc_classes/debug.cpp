@@ -19,6 +19,7 @@
  *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <sstream>
 #include "debug.h"
 
 DebugConsole::DebugConsole()
@@ -42,6 +43,11 @@ DebugConsole::DebugConsole(Game* _game)
     func_map["spawn"] = &DebugConsole::spawn;
     func_map["teleport"] = &DebugConsole::teleport;
     func_map["togglevis"] = &DebugConsole::togglevis;
+    func_map["perf"] = &DebugConsole::perf;
+    func_map["view"] = &DebugConsole::view;
+    func_map["bench"] = &DebugConsole::bench;
+    func_map["treeprof"] = &DebugConsole::treeprof;
+    func_map["pools"] = &DebugConsole::pools;
 }
 
 void DebugConsole::run_command(std::string input)
@@ -108,6 +114,26 @@ void DebugConsole::help(std::vector<std::string> command, std::vector<int> args)
     {
         debug_message = db_messages[HELP_TELEPORT];
     }
+    else if(command[0] == "perf")
+    {
+        debug_message = db_messages[HELP_PERF];
+    }
+    else if(command[0] == "view")
+    {
+        debug_message = db_messages[HELP_VIEW];
+    }
+    else if(command[0] == "bench")
+    {
+        debug_message = db_messages[HELP_BENCH] + " Benchmarks: " + benchmark::names();
+    }
+    else if(command[0] == "treeprof")
+    {
+        debug_message = db_messages[HELP_TREEPROF];
+    }
+    else if(command[0] == "pools")
+    {
+        debug_message = db_messages[HELP_POOLS];
+    }
     else
     {
         debug_message = db_messages[GENERAL_ERROR];
@@ -134,6 +160,19 @@ void DebugConsole::list(std::vector<std::string> command, std::vector<int> args)
         ss << "Chunk (x, y): (" << chunk_x<<", "<<chunk_y<<"), Coords (x, y) : ("<<x<<", "<<y<<")";
         debug_message = ss.str();
     }
+    else if(command[0] == "population")
+    {
+        int full = 0;
+        int coarse = 0;
+        std::vector<Character*>& characters = game->get_characters();
+        for(int i=0;i<characters.size();i++)
+        {
+            (game->ai_detail(characters[i]) == AI_FULL ? full : coarse)++;
+        }
+        std::stringstream ss;
+        ss << "Full AI: " << full << ", coarse AI: " << coarse << ", in unloaded chunks: " << game->get_population().size();
+        debug_message = ss.str();
+    }
     else
     {
         debug_message = db_messages[GENERAL_ERROR];
@@ -186,6 +225,191 @@ void DebugConsole::togglevis(std::vector<std::string> command, std::vector<int>
     }
 }
 
+void DebugConsole::perf(std::vector<std::string> command, std::vector<int> args)
+{
+    if(command.size() < 1)
+    {
+        debug_message = db_messages[HELP_PERF];
+    }
+    else if(command[0] == "overlay")
+    {
+        Profiler::instance().toggle_overlay();
+        debug_message = db_messages[COMPLETE];
+    }
+    else if(command[0] == "reset")
+    {
+        Profiler::instance().reset();
+        debug_message = db_messages[COMPLETE];
+    }
+    else if(command[0] == "dump")
+    {
+        std::string file_name = DATADIR "/perf.csv";
+        if(command.size() > 1)
+        {
+            file_name = command[1];
+        }
+
+        if(Profiler::instance().dump_csv(file_name))
+        {
+            debug_message = "Frame timings written to " + file_name;
+        }
+        else
+        {
+            debug_message = "Couldn't write to " + file_name;
+        }
+    }
+    else
+    {
+        debug_message = db_messages[GENERAL_ERROR];
+    }
+}
+
+void DebugConsole::treeprof(std::vector<std::string> command, std::vector<int> args)
+{
+    NodeProfiler& profiler = NodeProfiler::instance();
+    if(command.size() < 1)
+    {
+        debug_message = db_messages[HELP_TREEPROF];
+    }
+    else if(command[0] == "on" || command[0] == "off")
+    {
+        profiler.set_enabled(command[0] == "on");
+        debug_message = db_messages[COMPLETE];
+    }
+    else if(command[0] == "reset")
+    {
+        profiler.reset();
+        debug_message = db_messages[COMPLETE];
+    }
+    else if(command[0] == "show")
+    {
+        std::vector<int> trees = profiler.get_trees();
+        if(command.size() > 1)
+        {
+            debug_message = profiler.report(args[1]);
+        }
+        else if(trees.empty())
+        {
+            debug_message = "Nothing recorded yet. Try 'treeprof on'.";
+        }
+        else
+        {
+            //Every tree goes to stdout, and the console gets the first.
+            for(int i=trees.size() - 1;i>=0;i--)
+            {
+                debug_message = profiler.report(trees[i]);
+            }
+        }
+    }
+    else if(command[0] == "dump")
+    {
+        std::string file_name = DATADIR "/treeprof.json";
+        if(command.size() > 1)
+        {
+            file_name = command[1];
+        }
+
+        if(profiler.dump_json(file_name))
+        {
+            debug_message = "Node timings written to " + file_name;
+        }
+        else
+        {
+            debug_message = "Couldn't write to " + file_name;
+        }
+    }
+    else
+    {
+        debug_message = db_messages[GENERAL_ERROR];
+    }
+}
+
+void DebugConsole::pools(std::vector<std::string> command, std::vector<int> args)
+{
+    if(command.size() < 1)
+    {
+        debug_message = db_messages[HELP_POOLS];
+    }
+    else if(command[0] == "show")
+    {
+        //Every pool goes to stdout, and the console gets the totals for
+        //each family.
+        std::cout << ObjectPool::report();
+        std::vector<std::string> families;
+        std::map<std::string, PoolStats> totals;
+        const std::vector<ObjectPool*>& all = ObjectPool::get_pools();
+        for(int i=0;i<all.size();i++)
+        {
+            std::string family = all[i]->get_family();
+            if(totals.count(family) == 0)
+            {
+                families.push_back(family);
+            }
+            const PoolStats& stats = all[i]->get_stats();
+            PoolStats& total = totals[family];
+            total.live += stats.live;
+            total.peak += stats.peak;
+            total.recycled += stats.recycled;
+            total.reserved += stats.reserved;
+        }
+
+        std::stringstream message;
+        for(int i=0;i<families.size();i++)
+        {
+            const PoolStats& total = totals[families[i]];
+            message << (i > 0 ? "; " : "") << families[i] << ": " << total.live << " live, "
+                << total.peak << " peak, " << total.recycled << " recycled";
+        }
+        debug_message = families.empty() ? "Nothing has been pooled yet." : message.str();
+    }
+    else if(command[0] == "reset")
+    {
+        ObjectPool::reset_stats();
+        debug_message = db_messages[COMPLETE];
+    }
+    else
+    {
+        debug_message = db_messages[GENERAL_ERROR];
+    }
+}
+
+void DebugConsole::view(std::vector<std::string> command, std::vector<int> args)
+{
+    if(command.size() < 2)
+    {
+        debug_message = db_messages[NUM_ARG_ERROR];
+    }
+    else
+    {
+        //The view has to fit in the part of the screen that the map uses.
+        int width = std::max(1, std::min(args[0], GAME_WIDTH));
+        int height = std::max(1, std::min(args[1], GAME_HEIGHT));
+        int zoom = game->get_zoom();
+        if(command.size() > 2)
+        {
+            zoom = std::max(1, args[2]);
+        }
+        game->set_view(height, width, zoom);
+        debug_message = db_messages[COMPLETE];
+    }
+}
+
+void DebugConsole::bench(std::vector<std::string> command, std::vector<int> args)
+{
+    if(command.size() < 1)
+    {
+        debug_message = db_messages[HELP_BENCH] + " Benchmarks: " + benchmark::names();
+    }
+    else if(!benchmark::exists(command[0]))
+    {
+        debug_message = "No benchmark called " + command[0] + ". Benchmarks: " + benchmark::names();
+    }
+    else
+    {
+        debug_message = benchmark::run(command[0], game);
+    }
+}
+
 std::string DebugConsole::get_message()
 {
     return debug_message;
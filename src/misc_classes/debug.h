@@ -28,6 +28,10 @@
 
 #include "game.h"
 #include "utility.h"
+#include "profiler.h"
+#include "node_profiler.h"
+#include "object_pool.h"
+#include "benchmark.h"
 
 class DebugConsole;
 
@@ -47,19 +51,29 @@ enum DEBUG_MESSAGES
     HELP_LIST,
     HELP_KILLALL,
     HELP_TELEPORT,
+    HELP_PERF,
+    HELP_VIEW,
+    HELP_BENCH,
+    HELP_TREEPROF,
+    HELP_POOLS,
     LIST_ENEMYTYPE,
     COMPLETE
 };
 
-static std::string db_messages[10] = {
+static std::string db_messages[15] = {
     "I'm sorry, I couldn't understand that command.",
     "Too few arguments.",
     "Incorrect argument types.",
-    "Commands: spawn, help, list, killall.  Type 'help <command>' for how to use a command.",
+    "Commands: spawn, help, list, killall, perf, view, bench, treeprof, pools.  Type 'help <command>' for how to use a command.",
     "Spawn enemies.  Args: chunk_x, chunk_y, x, y, depth, type of enemy, times to run command.",
-    "List available something. Options are: enemytype, coords",
+    "List available something. Options are: enemytype, coords, population",
     "Kill all the enemies.  Like, all of them.",
     "Teleports the player. Args: chunk_x, chunk_y, x, y",
+    "Frame timings. Options are: overlay, reset, dump <file>",
+    "Changes the map view. Args: width, height, zoom (tiles per character)",
+    "Runs a benchmark. Args: name. Full results go to stdout.",
+    "Behavior tree node timings. Options are: on, off, reset, show <ai id>, dump <file>",
+    "Character and item pool use. Options are: show, reset",
     "EnemyTypes--1: Kobold, 2: Rabbit",
     "Done."
 };
@@ -179,6 +193,38 @@ class DebugConsole
          * @param args The list of int arguments for the function.
          */
         void togglevis(std::vector<std::string> command, std::vector<int> args);
+
+        /**
+         * Shows, resets, or dumps the frame timings to a CSV file.
+         * @param command The list of string arguments for the function.
+         * @param args The list of int arguments for the function.
+         */
+        void perf(std::vector<std::string> command, std::vector<int> args);
+
+        /**
+         * Turns the behavior tree profiler on and off, shows what it has
+         * recorded for a tree, or dumps all of it to a JSON file.
+         * @param command The list of string arguments for the function.
+         * @param args The list of int arguments for the function.
+         */
+        void treeprof(std::vector<std::string> command, std::vector<int> args);
+
+        /**
+         * Shows how full the character and item pools are, or starts
+         * their peaks and recycled counts again.
+         * @param command The list of string arguments for the function.
+         * @param args The list of int arguments for the function.
+         */
+        void pools(std::vector<std::string> command, std::vector<int> args);
+
+        void view(std::vector<std::string> command, std::vector<int> args);
+
+        /**
+         * Runs one of the benchmarks in benchmark.h.
+         * @param command The name of the benchmark.
+         * @param args Unused.
+         */
+        void bench(std::vector<std::string> command, std::vector<int> args);
 };
 
 #endif
@@ -0,0 +1,207 @@
+/**
+ *  FLOW_FIELD.CPP
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include "flow_field.h"
+
+const int FlowField::UNREACHABLE;
+
+FlowField::FlowField()
+{
+    top = 0;
+    left = 0;
+    rows = 0;
+    cols = 0;
+    flee_built = false;
+    lowest = 0;
+}
+
+void FlowField::build(const BitGrid& passable, IntPoint _target, int _radius)
+{
+    build_area(passable, _target, _target.row - _radius, _target.col - _radius,
+            _radius * 2 + 1, _radius * 2 + 1);
+}
+
+void FlowField::build_area(const BitGrid& passable, IntPoint _target, int _top, int _left,
+        int _rows, int _cols)
+{
+    target = _target;
+    top = _top;
+    left = _left;
+    rows = _rows;
+    cols = _cols;
+    distances.assign(rows * cols, UNREACHABLE);
+    flee.clear();
+    flee_built = false;
+
+    int target_index = (target.row - top) * cols + (target.col - left);
+    distances[target_index] = 0;
+    lowest = 0;
+    push(target_index, 0);
+    relax(passable, distances);
+}
+
+void FlowField::build_flee(const BitGrid& passable)
+{
+    if(flee_built)
+    {
+        return;
+    }
+
+    flee.assign(distances.size(), UNREACHABLE);
+    lowest = 0;
+    for(size_t i = 0; i < distances.size(); i++)
+    {
+        if(distances[i] != UNREACHABLE)
+        {
+            flee[i] = -(distances[i] * 6) / 5;
+            lowest = std::min(lowest, flee[i]);
+        }
+    }
+    for(size_t i = 0; i < flee.size(); i++)
+    {
+        if(flee[i] != UNREACHABLE)
+        {
+            push(i, flee[i]);
+        }
+    }
+    relax(passable, flee);
+    flee_built = true;
+}
+
+void FlowField::push(int index, int cost)
+{
+    size_t bucket = cost - lowest;
+    if(bucket >= buckets.size())
+    {
+        buckets.resize(bucket + 64);
+    }
+    buckets[bucket].push_back(index);
+}
+
+void FlowField::relax(const BitGrid& passable, std::vector<int>& costs)
+{
+    for(size_t bucket = 0; bucket < buckets.size(); bucket++)
+    {
+        int cost = lowest + bucket;
+        //The bucket can grow while it's being looked at, and pushing can
+        //move it, so it has to be looked up every time.
+        for(size_t k = 0; k < buckets[bucket].size(); k++)
+        {
+            int index = buckets[bucket][k];
+            if(costs[index] != cost)
+            {
+                continue;
+            }
+
+            int row = index / cols;
+            int col = index % cols;
+            unsigned int around = passable.neighborhood(row + top, col + left);
+            for(int bit = 0; bit < 9; bit++)
+            {
+                if(bit == 4 || !((around >> bit) & 1))
+                {
+                    continue;
+                }
+                int next_row = row + bit / 3 - 1;
+                int next_col = col + bit % 3 - 1;
+                if(next_row < 0 || next_col < 0 || next_row >= rows || next_col >= cols)
+                {
+                    continue;
+                }
+                int next = next_row * cols + next_col;
+                int next_cost = cost + ((bit & 1) ? 10 : 14);
+                if(next_cost < costs[next])
+                {
+                    costs[next] = next_cost;
+                    push(next, next_cost);
+                }
+            }
+        }
+        buckets[bucket].clear();
+    }
+}
+
+bool FlowField::has_flee() const
+{
+    return flee_built;
+}
+
+IntPoint FlowField::get_target() const
+{
+    return target;
+}
+
+bool FlowField::covers(IntPoint point) const
+{
+    int row = point.row - top;
+    int col = point.col - left;
+    return row >= 0 && col >= 0 && row < rows && col < cols;
+}
+
+int FlowField::distance(IntPoint point) const
+{
+    if(!covers(point))
+    {
+        return UNREACHABLE;
+    }
+    return distances[(point.row - top) * cols + (point.col - left)];
+}
+
+IntPoint FlowField::step_towards(IntPoint point) const
+{
+    return downhill(point, distances);
+}
+
+IntPoint FlowField::step_away(IntPoint point) const
+{
+    return downhill(point, flee);
+}
+
+IntPoint FlowField::downhill(IntPoint point, const std::vector<int>& costs) const
+{
+    IntPoint best = IntPoint(0, 0);
+    if(!covers(point))
+    {
+        return best;
+    }
+
+    int row = point.row - top;
+    int col = point.col - left;
+    int lowest = costs[row * cols + col];
+    //Straight moves are looked at first, so they win ties.
+    static const int order[8][2] = {{-1, 0}, {0, -1}, {0, 1}, {1, 0},
+        {-1, -1}, {-1, 1}, {1, -1}, {1, 1}};
+    for(int i = 0; i < 8; i++)
+    {
+        int next_row = row + order[i][0];
+        int next_col = col + order[i][1];
+        if(next_row < 0 || next_col < 0 || next_row >= rows || next_col >= cols)
+        {
+            continue;
+        }
+        int cost = costs[next_row * cols + next_col];
+        if(cost < lowest)
+        {
+            lowest = cost;
+            best = IntPoint(order[i][0], order[i][1]);
+        }
+    }
+    return best;
+}
@@ -0,0 +1,140 @@
+/**
+ *  FLOW_FIELD.H
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FLOW_FIELD_H
+#define FLOW_FIELD_H
+
+#include <vector>
+#include <climits>
+
+#include "int_point.h"
+#include "bit_grid.h"
+
+/**
+ * A Dijkstra map: the cost of the shortest path from every tile in a
+ * square window to one target tile, using the same 10/14 move costs as
+ * PathSearch.  It only has to be built once for everybody chasing the
+ * same target, and then each of them finds its next step by looking at
+ * the eight tiles around it.
+ *
+ * It can also be turned into a map for running away.  Just walking up
+ * the distances leads into the nearest dead end, so instead every
+ * distance is multiplied by -1.2 and the map is smoothed out again with
+ * another Dijkstra pass.  Walking down that map heads away from the
+ * target, but will go past it to reach a way out that's far enough away.
+ */
+class FlowField
+{
+    public:
+        /**
+         * What tiles that can't reach the target are set to.
+         */
+        static const int UNREACHABLE = INT_MAX;
+
+        FlowField();
+
+        /**
+         * Works out the distance to the target from every tile no more
+         * than radius tiles away from it, and throws away the running
+         * away map.
+         */
+        void build(const BitGrid& passable, IntPoint _target, int _radius);
+
+        /**
+         * The same as build(), but for a window with its top left corner
+         * at (_top, _left) that's _rows by _cols tiles.  The target has to
+         * be inside of it.
+         */
+        void build_area(const BitGrid& passable, IntPoint _target, int _top, int _left,
+                int _rows, int _cols);
+
+        /**
+         * Works out the running away map from the distances, if it hasn't
+         * been done since the last build().
+         */
+        void build_flee(const BitGrid& passable);
+
+        bool has_flee() const;
+
+        IntPoint get_target() const;
+
+        /**
+         * True if the point is inside of the window the map covers.
+         */
+        bool covers(IntPoint point) const;
+
+        /**
+         * The cost of getting from the point to the target, or UNREACHABLE.
+         */
+        int distance(IntPoint point) const;
+
+        /**
+         * The direction that gets closest to the target from the point,
+         * or (0, 0) if nowhere is closer.
+         */
+        IntPoint step_towards(IntPoint point) const;
+
+        /**
+         * The direction to run away in from the point, or (0, 0) if
+         * nowhere is better.  build_flee() has to have been called.
+         */
+        IntPoint step_away(IntPoint point) const;
+
+    private:
+        IntPoint target;
+
+        /**
+         * The top left corner of the window and its size.
+         */
+        int top;
+        int left;
+        int rows;
+        int cols;
+
+        std::vector<int> distances;
+        std::vector<int> flee;
+        bool flee_built;
+
+        /**
+         * The open list, as one bucket of tiles for every cost starting
+         * from lowest.  Moves only ever cost 10 or 14, so taking the
+         * buckets in order is Dijkstra without a heap.  Tiles whose cost
+         * went down after they were added are skipped when their old
+         * bucket comes up.
+         */
+        std::vector<std::vector<int> > buckets;
+        int lowest;
+
+        void push(int index, int cost);
+
+        /**
+         * Runs Dijkstra over the window, starting from whatever is already
+         * in the buckets, and lowering costs wherever it finds a cheaper
+         * way.
+         */
+        void relax(const BitGrid& passable, std::vector<int>& costs);
+
+        /**
+         * The neighbor of the point with the lowest cost, if it's lower
+         * than the point's own.
+         */
+        IntPoint downhill(IntPoint point, const std::vector<int>& costs) const;
+};
+
+#endif
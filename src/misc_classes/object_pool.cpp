@@ -0,0 +1,166 @@
+/**
+ *  OBJECT_POOL.CPP
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <sstream>
+#include <cstring>
+#include <new>
+#include "object_pool.h"
+
+namespace
+{
+    const size_t ALIGNMENT = alignof(std::max_align_t);
+
+    size_t round_up(size_t size)
+    {
+        return (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    }
+
+    const int DEFAULT_BLOCK_OBJECTS = 256;
+}
+
+PoolStats::PoolStats() : live(0), peak(0), recycled(0), reserved(0)
+{
+}
+
+ObjectPool::ObjectPool(const char* _family, size_t _object_size, int _block_objects)
+{
+    family = _family;
+    object_size = _object_size;
+    stride = round_up(sizeof(Header)) + round_up(object_size);
+    block_objects = _block_objects;
+    free_list = NULL;
+    unused = NULL;
+    unused_count = 0;
+}
+
+std::vector<ObjectPool*>& ObjectPool::pools()
+{
+    //Never deleted, so that objects deleted at exit can still be given
+    //back.
+    static std::vector<ObjectPool*>* all = new std::vector<ObjectPool*>;
+    return *all;
+}
+
+ObjectPool& ObjectPool::get(const char* family, size_t object_size)
+{
+    std::vector<ObjectPool*>& all = pools();
+    for(size_t i = 0; i < all.size(); i++)
+    {
+        if(all[i]->object_size == object_size && strcmp(all[i]->family, family) == 0)
+        {
+            return *all[i];
+        }
+    }
+    all.push_back(new ObjectPool(family, object_size, DEFAULT_BLOCK_OBJECTS));
+    return *all.back();
+}
+
+const std::vector<ObjectPool*>& ObjectPool::get_pools()
+{
+    return pools();
+}
+
+void ObjectPool::add_block()
+{
+    //::operator new is aligned for anything, and the stride keeps every
+    //object after the first aligned the same way.
+    char* block = static_cast<char*>(::operator new(stride * block_objects));
+    blocks.push_back(block);
+    unused = block;
+    unused_count = block_objects;
+    stats.reserved += block_objects;
+}
+
+void* ObjectPool::allocate()
+{
+    Header* header;
+    if(free_list != NULL)
+    {
+        header = free_list;
+        free_list = header->next;
+        stats.recycled++;
+    }
+    else
+    {
+        if(unused_count == 0)
+        {
+            add_block();
+        }
+        header = reinterpret_cast<Header*>(unused);
+        unused += stride;
+        unused_count--;
+    }
+    header->pool = this;
+    stats.live++;
+    stats.peak = std::max(stats.peak, stats.live);
+    return reinterpret_cast<char*>(header) + round_up(sizeof(Header));
+}
+
+void ObjectPool::release(void* memory)
+{
+    if(memory == NULL)
+    {
+        return;
+    }
+    Header* header = reinterpret_cast<Header*>(static_cast<char*>(memory) - round_up(sizeof(Header)));
+    ObjectPool* pool = header->pool;
+    header->next = pool->free_list;
+    pool->free_list = header;
+    pool->stats.live--;
+}
+
+std::string ObjectPool::report()
+{
+    std::stringstream out;
+    std::vector<ObjectPool*>& all = pools();
+    for(size_t i = 0; i < all.size(); i++)
+    {
+        const PoolStats& pool_stats = all[i]->stats;
+        out << all[i]->family << " (" << all[i]->object_size << " bytes): " << pool_stats.live
+            << " live, " << pool_stats.peak << " peak, " << pool_stats.recycled << " recycled, "
+            << pool_stats.reserved << " reserved" << std::endl;
+    }
+    return out.str();
+}
+
+void ObjectPool::reset_stats()
+{
+    std::vector<ObjectPool*>& all = pools();
+    for(size_t i = 0; i < all.size(); i++)
+    {
+        all[i]->stats.peak = all[i]->stats.live;
+        all[i]->stats.recycled = 0;
+    }
+}
+
+const char* ObjectPool::get_family() const
+{
+    return family;
+}
+
+size_t ObjectPool::get_object_size() const
+{
+    return object_size;
+}
+
+const PoolStats& ObjectPool::get_stats() const
+{
+    return stats;
+}
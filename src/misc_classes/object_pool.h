@@ -0,0 +1,148 @@
+/**
+ *  OBJECT_POOL.H
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OBJECT_POOL_H
+#define OBJECT_POOL_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+/**
+ * How much a pool is being used.
+ */
+struct PoolStats
+{
+    PoolStats();
+
+    /**
+     * Objects handed out and not given back yet.
+     */
+    long live;
+
+    /**
+     * The most that have been live at once.
+     */
+    long peak;
+
+    /**
+     * How many objects got the memory of one that had been given back,
+     * instead of new memory.
+     */
+    long recycled;
+
+    /**
+     * How many objects the pool has room for without getting another
+     * block.
+     */
+    long reserved;
+};
+
+/**
+ * Hands out memory for objects of one size, out of blocks that are never
+ * given back to the system.  Memory that's given back goes on a free list
+ * and is handed out again first, so once a pool has grown to fit the most
+ * objects it needs at once, making and deleting them doesn't touch the
+ * system allocator, and objects never move.
+ *
+ * Every object has a pointer to its pool in front of it, so it can be
+ * given back without knowing its size, which matters for characters
+ * deleted through a Character pointer.  Pools are only used from the main
+ * thread, like everything else that makes or deletes characters and
+ * items.
+ */
+class ObjectPool
+{
+    public:
+        /**
+         * The pool for objects of a family and size, which is made the
+         * first time it's asked for.  Derived classes are bigger than
+         * their base, so each size gets its own pool.
+         * @param family What the objects are, for the stats.
+         */
+        static ObjectPool& get(const char* family, size_t object_size);
+
+        /**
+         * Gives back memory from any pool.  Does nothing for NULL.
+         */
+        static void release(void* memory);
+
+        /**
+         * Every pool that's been made.
+         */
+        static const std::vector<ObjectPool*>& get_pools();
+
+        /**
+         * The stats for every pool, one pool per line.
+         */
+        static std::string report();
+
+        /**
+         * Starts every pool's peak again from how many are live now, and
+         * zeroes how many have been recycled.
+         */
+        static void reset_stats();
+
+        void* allocate();
+
+        const char* get_family() const;
+        size_t get_object_size() const;
+        const PoolStats& get_stats() const;
+
+    private:
+        /**
+         * What's in front of every object: its pool while it's handed
+         * out, and the next free one while it isn't.
+         */
+        union Header
+        {
+            ObjectPool* pool;
+            Header* next;
+        };
+
+        ObjectPool(const char* _family, size_t _object_size, int _block_objects);
+        ObjectPool(const ObjectPool&);
+        ObjectPool& operator=(const ObjectPool&);
+
+        void add_block();
+
+        const char* family;
+        size_t object_size;
+
+        /**
+         * The distance from one object's header to the next's.
+         */
+        size_t stride;
+        int block_objects;
+
+        std::vector<char*> blocks;
+        Header* free_list;
+
+        /**
+         * The part of the newest block that's never been handed out.
+         */
+        char* unused;
+        int unused_count;
+
+        PoolStats stats;
+
+        static std::vector<ObjectPool*>& pools();
+};
+
+#endif
@@ -0,0 +1,168 @@
+/**
+ *  PATH_QUEUE.CPP
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include "path_queue.h"
+
+PathQueue::PathQueue(int threads)
+{
+    snapshot_depth = 0;
+    snapshot_version = 0;
+    have_snapshot = false;
+    next_claim = 0;
+    finished = 0;
+    next_ticket = 0;
+    stopping = false;
+
+    if(threads <= 0)
+    {
+        threads = std::max(1, (int)std::thread::hardware_concurrency() - 1);
+    }
+    for(int i = 0; i < threads; i++)
+    {
+        workers.push_back(std::thread(&PathQueue::work, this));
+    }
+}
+
+PathQueue::~PathQueue()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    work_ready.notify_all();
+    for(size_t i = 0; i < workers.size(); i++)
+    {
+        workers[i].join();
+    }
+}
+
+unsigned long PathQueue::submit(IntPoint start, IntPoint goal, int depth, int budget, SearchMode mode)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    next_ticket++;
+    if(next_ticket == 0)
+    {
+        next_ticket = 1;
+    }
+    PathRequest request = {next_ticket, start, goal, depth, budget, mode};
+    queued.push_back(request);
+    return next_ticket;
+}
+
+bool PathQueue::dispatch(const BitGrid& passable, int depth, unsigned long version)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if(queued.empty() || !batch.empty())
+        {
+            return false;
+        }
+
+        //Nothing is reading the snapshot while there's no batch out.
+        if(!have_snapshot || version != snapshot_version || depth != snapshot_depth)
+        {
+            snapshot = passable;
+            snapshot_depth = depth;
+            snapshot_version = version;
+            have_snapshot = true;
+        }
+        batch.swap(queued);
+        results.resize(batch.size());
+        next_claim = 0;
+        finished = 0;
+    }
+    work_ready.notify_all();
+    return true;
+}
+
+bool PathQueue::collect(std::vector<PathResult>& out)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if(batch.empty() || finished < batch.size())
+    {
+        return false;
+    }
+    out.swap(results);
+    results.clear();
+    batch.clear();
+    return true;
+}
+
+void PathQueue::wait()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    work_done.wait(lock, [this]{ return finished >= batch.size(); });
+}
+
+size_t PathQueue::waiting()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return queued.size();
+}
+
+int PathQueue::get_threads() const
+{
+    return workers.size();
+}
+
+void PathQueue::work()
+{
+    PathSearch search;
+    std::unique_lock<std::mutex> lock(mutex);
+    while(true)
+    {
+        work_ready.wait(lock, [this]{ return stopping || next_claim < batch.size(); });
+        if(stopping)
+        {
+            return;
+        }
+
+        //The batch and the snapshot stay put until every request in it is
+        //finished, so they can be read without the lock.
+        size_t first = next_claim;
+        size_t last = std::min(batch.size(), first + CLAIM_SIZE);
+        next_claim = last;
+        lock.unlock();
+        for(size_t i = first; i < last; i++)
+        {
+            solve(batch[i], search, results[i]);
+        }
+        lock.lock();
+
+        finished += last - first;
+        if(finished == batch.size())
+        {
+            work_done.notify_all();
+        }
+    }
+}
+
+void PathQueue::solve(const PathRequest& request, PathSearch& search, PathResult& result) const
+{
+    result.ticket = request.ticket;
+    result.version = snapshot_version;
+    result.path.clear();
+    result.found = request.depth == snapshot_depth &&
+        search.find(request.mode, snapshot, request.start, request.goal, request.budget);
+    if(result.found)
+    {
+        result.path = search.get_path();
+    }
+}
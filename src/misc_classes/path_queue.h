@@ -0,0 +1,177 @@
+/**
+ *  PATH_QUEUE.H
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PATH_QUEUE_H
+#define PATH_QUEUE_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "int_point.h"
+#include "bit_grid.h"
+#include "path_search.h"
+
+/**
+ * A path that somebody wants found.
+ */
+struct PathRequest
+{
+    unsigned long ticket;
+    IntPoint start;
+    IntPoint goal;
+
+    /**
+     * The layer the path is on.  Requests for any other layer than the
+     * snapshot's fail.
+     */
+    int depth;
+
+    /**
+     * How far from the start, in rows or columns, the search can go.
+     */
+    int budget;
+    SearchMode mode;
+};
+
+/**
+ * What a worker found for a request.  The path is the same as
+ * PathSearch::get_path() would give, with the next step at the back.
+ */
+struct PathResult
+{
+    unsigned long ticket;
+    bool found;
+    std::vector<IntPoint> path;
+
+    /**
+     * The version of the snapshot the path was found on.
+     */
+    unsigned long version;
+};
+
+/**
+ * Finds paths on worker threads, so that a long search doesn't hold up the
+ * frame that asked for it.
+ *
+ * Requests pile up as they're submitted.  dispatch() copies the
+ * passability grid into a snapshot and hands every waiting request to the
+ * workers as one batch, and collect() picks up the results once the
+ * whole batch is done.  Neither of them waits for the workers: while a
+ * batch is out, new requests wait for the next one, and collect() just
+ * says there's nothing yet.
+ *
+ * The snapshot doesn't change while a batch is out, every worker has its
+ * own PathSearch, and the results come back in the order the requests
+ * went in, so a batch always gives the same results for the same snapshot
+ * no matter how many workers there are or which one got what.
+ */
+class PathQueue
+{
+    public:
+        /**
+         * Starts the workers.
+         * @param threads How many there should be.  0 means one fewer
+         * than the number of cores, but at least one.
+         */
+        PathQueue(int threads = 0);
+
+        /**
+         * Stops the workers, after they finish what they're on.
+         */
+        ~PathQueue();
+
+        /**
+         * Adds a request to the next batch.
+         * @return The ticket that the result will come back with.  Never 0.
+         */
+        unsigned long submit(IntPoint start, IntPoint goal, int depth, int budget, SearchMode mode);
+
+        /**
+         * Sends the waiting requests off as a batch, unless there aren't
+         * any or the last batch hasn't been collected yet.
+         * @param passable The grid to search.  It's copied, unless the
+         * snapshot already has this version of it.
+         * @param depth The layer the grid is for.
+         * @param version Changes whenever the grid does.
+         * @return Whether a batch went out.
+         */
+        bool dispatch(const BitGrid& passable, int depth, unsigned long version);
+
+        /**
+         * Takes the results of the batch, if it's done.
+         * @param results Gets the results, in the order they were
+         * submitted.
+         * @return Whether there were any.
+         */
+        bool collect(std::vector<PathResult>& results);
+
+        /**
+         * Blocks until the batch that's out is done.
+         */
+        void wait();
+
+        /**
+         * How many requests are waiting for the next batch.
+         */
+        size_t waiting();
+
+        int get_threads() const;
+
+    private:
+        /**
+         * How many requests a worker takes at a time.  Taking a few at
+         * once keeps the workers from fighting over the lock.
+         */
+        static const size_t CLAIM_SIZE = 8;
+
+        std::vector<std::thread> workers;
+        std::mutex mutex;
+        std::condition_variable work_ready;
+        std::condition_variable work_done;
+
+        std::vector<PathRequest> queued;
+        std::vector<PathRequest> batch;
+        std::vector<PathResult> results;
+
+        BitGrid snapshot;
+        int snapshot_depth;
+        unsigned long snapshot_version;
+        bool have_snapshot;
+
+        /**
+         * The first request in the batch that no worker has taken, and
+         * how many have been finished.
+         */
+        size_t next_claim;
+        size_t finished;
+
+        unsigned long next_ticket;
+        bool stopping;
+
+        void work();
+
+        /**
+         * Runs one request on the snapshot.
+         */
+        void solve(const PathRequest& request, PathSearch& search, PathResult& result) const;
+};
+
+#endif
@@ -0,0 +1,430 @@
+/**
+ *  PATH_SEARCH.CPP
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include "path_search.h"
+
+PathSearch::PathSearch()
+{
+    top = 0;
+    left = 0;
+    side = 0;
+    generation = 0;
+    expanded = 0;
+}
+
+int PathSearch::octile(int drow, int dcol)
+{
+    drow = drow < 0 ? -drow : drow;
+    dcol = dcol < 0 ? -dcol : dcol;
+    return 10 * std::max(drow, dcol) + 4 * std::min(drow, dcol);
+}
+
+void PathSearch::begin(int _top, int _left, int _side)
+{
+    top = _top;
+    left = _left;
+    side = _side;
+    size_t cells = side * side;
+    if(g.size() < cells)
+    {
+        g.resize(cells);
+        parent.resize(cells);
+        opened.resize(cells, 0);
+        closed.resize(cells, 0);
+    }
+
+    generation++;
+    if(generation == 0)
+    {
+        //The stamps wrapped around, so old ones could look new again.
+        std::fill(opened.begin(), opened.end(), 0);
+        std::fill(closed.begin(), closed.end(), 0);
+        generation = 1;
+    }
+    open.clear();
+    path.clear();
+    expanded = 0;
+}
+
+int PathSearch::start_search(const BitGrid& passable, IntPoint start, IntPoint goal, int radius)
+{
+    begin(start.row - radius, start.col - radius, radius * 2 + 1);
+    if(!open_at(passable, goal.row, goal.col))
+    {
+        return -1;
+    }
+    return (goal.row - top) * side + (goal.col - left);
+}
+
+bool PathSearch::find(SearchMode mode, const BitGrid& passable, IntPoint start, IntPoint goal, int radius)
+{
+    if(mode == PATH_JUMP_POINT)
+    {
+        return jump_point(passable, start, goal, radius);
+    }
+    return a_star(passable, start, goal, radius);
+}
+
+bool PathSearch::a_star(const BitGrid& passable, IntPoint start, IntPoint goal, int radius)
+{
+    int goal_index = start_search(passable, start, goal, radius);
+    if(goal_index == -1)
+    {
+        return false;
+    }
+    int goal_row = goal_index / side;
+    int goal_col = goal_index % side;
+    int start_index = radius * side + radius;
+    if(goal_index == start_index)
+    {
+        return true;
+    }
+
+    g[start_index] = 0;
+    parent[start_index] = -1;
+    opened[start_index] = generation;
+    OpenNode first = {octile(goal.row - start.row, goal.col - start.col), 0, start_index};
+    open.push_back(first);
+
+    while(!open.empty())
+    {
+        std::pop_heap(open.begin(), open.end(), LaterNode());
+        OpenNode current = open.back();
+        open.pop_back();
+        if(closed[current.index] == generation || current.g != g[current.index])
+        {
+            //A better way here was found after this was pushed.
+            continue;
+        }
+        closed[current.index] = generation;
+        expanded++;
+
+        if(current.index == goal_index)
+        {
+            build_path(goal_index, start_index);
+            return true;
+        }
+
+        int row = current.index / side;
+        int col = current.index % side;
+        unsigned int around = passable.neighborhood(row + top, col + left);
+        for(int bit = 0; bit < 9; bit++)
+        {
+            if(bit == 4 || !((around >> bit) & 1))
+            {
+                continue;
+            }
+            int next_row = row + bit / 3 - 1;
+            int next_col = col + bit % 3 - 1;
+            if(next_row < 0 || next_col < 0 || next_row >= side || next_col >= side)
+            {
+                continue;
+            }
+
+            int next = next_row * side + next_col;
+            if(closed[next] == generation)
+            {
+                continue;
+            }
+            int next_g = current.g + ((bit & 1) ? 10 : 14);
+            if(opened[next] == generation && g[next] <= next_g)
+            {
+                continue;
+            }
+
+            opened[next] = generation;
+            g[next] = next_g;
+            parent[next] = current.index;
+            OpenNode node = {next_g + octile(goal_row - next_row, goal_col - next_col), next_g, next};
+            open.push_back(node);
+            std::push_heap(open.begin(), open.end(), LaterNode());
+        }
+    }
+    return false;
+}
+
+bool PathSearch::jump_point(const BitGrid& passable, IntPoint start, IntPoint goal, int radius)
+{
+    int goal_index = start_search(passable, start, goal, radius);
+    if(goal_index == -1)
+    {
+        return false;
+    }
+    int start_index = radius * side + radius;
+    if(goal_index == start_index)
+    {
+        return true;
+    }
+
+    g[start_index] = 0;
+    parent[start_index] = -1;
+    opened[start_index] = generation;
+    OpenNode first = {octile(goal.row - start.row, goal.col - start.col), 0, start_index};
+    open.push_back(first);
+
+    while(!open.empty())
+    {
+        std::pop_heap(open.begin(), open.end(), LaterNode());
+        OpenNode current = open.back();
+        open.pop_back();
+        if(closed[current.index] == generation || current.g != g[current.index])
+        {
+            continue;
+        }
+        closed[current.index] = generation;
+        expanded++;
+
+        if(current.index == goal_index)
+        {
+            build_path(goal_index, start_index);
+            return true;
+        }
+
+        int row = current.index / side + top;
+        int col = current.index % side + left;
+
+        //The directions worth jumping in, as bits of a 3x3 block like
+        //BitGrid::neighborhood.  The start has to try all of them, but
+        //everywhere else only needs the ones that the way in points at,
+        //plus any forced neighbors.
+        unsigned int directions = 0x1ef;
+        if(parent[current.index] != -1)
+        {
+            int from_row = parent[current.index] / side + top;
+            int from_col = parent[current.index] % side + left;
+            int drow = (row > from_row) - (row < from_row);
+            int dcol = (col > from_col) - (col < from_col);
+            directions = 1 << ((drow + 1) * 3 + (dcol + 1));
+            if(drow != 0 && dcol != 0)
+            {
+                directions |= 1 << ((drow + 1) * 3 + 1);
+                directions |= 1 << (3 + (dcol + 1));
+                if(!open_at(passable, row, col - dcol))
+                {
+                    directions |= 1 << ((drow + 1) * 3 + (-dcol + 1));
+                }
+                if(!open_at(passable, row - drow, col))
+                {
+                    directions |= 1 << ((-drow + 1) * 3 + (dcol + 1));
+                }
+            }
+            else if(drow == 0)
+            {
+                for(int side_row = -1; side_row <= 1; side_row += 2)
+                {
+                    if(!open_at(passable, row + side_row, col))
+                    {
+                        directions |= 1 << ((side_row + 1) * 3 + (dcol + 1));
+                    }
+                }
+            }
+            else
+            {
+                for(int side_col = -1; side_col <= 1; side_col += 2)
+                {
+                    if(!open_at(passable, row, col + side_col))
+                    {
+                        directions |= 1 << ((drow + 1) * 3 + (side_col + 1));
+                    }
+                }
+            }
+        }
+
+        for(int bit = 0; bit < 9; bit++)
+        {
+            if(!((directions >> bit) & 1))
+            {
+                continue;
+            }
+            int drow = bit / 3 - 1;
+            int dcol = bit % 3 - 1;
+            int next = jump(passable, row + drow, col + dcol, drow, dcol, goal);
+            if(next == -1)
+            {
+                continue;
+            }
+            int distance = octile(next / side + top - row, next % side + left - col);
+            push_jump(next, current.index, current.g + distance, goal);
+        }
+    }
+    return false;
+}
+
+void PathSearch::push_jump(int index, int from, int next_g, IntPoint goal)
+{
+    if(closed[index] == generation || (opened[index] == generation && g[index] <= next_g))
+    {
+        return;
+    }
+    opened[index] = generation;
+    g[index] = next_g;
+    parent[index] = from;
+    int h = octile(goal.row - (index / side + top), goal.col - (index % side + left));
+    OpenNode node = {next_g + h, next_g, index};
+    open.push_back(node);
+    std::push_heap(open.begin(), open.end(), LaterNode());
+}
+
+int PathSearch::jump(const BitGrid& passable, int row, int col, int drow, int dcol, IntPoint goal) const
+{
+    if(drow == 0)
+    {
+        return jump_row(passable, row, col, dcol, goal);
+    }
+
+    while(open_at(passable, row, col))
+    {
+        if(row == goal.row && col == goal.col)
+        {
+            return (row - top) * side + (col - left);
+        }
+
+        if(dcol == 0)
+        {
+            //A wall beside the column with an opening just past it.
+            for(int side_col = -1; side_col <= 1; side_col += 2)
+            {
+                if(!open_at(passable, row, col + side_col) &&
+                        open_at(passable, row + drow, col + side_col))
+                {
+                    return (row - top) * side + (col - left);
+                }
+            }
+        }
+        else
+        {
+            if((!open_at(passable, row, col - dcol) && open_at(passable, row + drow, col - dcol)) ||
+                    (!open_at(passable, row - drow, col) && open_at(passable, row - drow, col + dcol)))
+            {
+                return (row - top) * side + (col - left);
+            }
+
+            //A diagonal move is a jump point if either of the straight
+            //lines out of it finds one.
+            if(jump_row(passable, row, col + dcol, dcol, goal) != -1 ||
+                    jump(passable, row + drow, col, drow, 0, goal) != -1)
+            {
+                return (row - top) * side + (col - left);
+            }
+        }
+
+        row += drow;
+        col += dcol;
+    }
+    return -1;
+}
+
+int PathSearch::jump_row(const BitGrid& passable, int row, int col, int dcol, IntPoint goal) const
+{
+    if(row < top || row >= top + side)
+    {
+        return -1;
+    }
+    bool has_above = row - 1 >= top;
+    bool has_below = row + 1 < top + side;
+
+    //Each pass looks at 63 tiles instead of 64, since whether a tile has
+    //a forced neighbor depends on the tile after it too.
+    if(dcol > 0)
+    {
+        int end = left + side;
+        while(col < end)
+        {
+            int span = std::min(63, end - col);
+            uint64_t here = passable.get_bits(row, col);
+            uint64_t above = has_above ? passable.get_bits(row - 1, col) : 0;
+            uint64_t below = has_below ? passable.get_bits(row + 1, col) : 0;
+            uint64_t stop = ~here | (~above & (above >> 1)) | (~below & (below >> 1));
+            if(row == goal.row && goal.col >= col && goal.col < col + span)
+            {
+                stop |= (uint64_t)1 << (goal.col - col);
+            }
+            stop &= ((uint64_t)1 << span) - 1;
+            if(stop != 0)
+            {
+                int bit = __builtin_ctzll(stop);
+                if(!((here >> bit) & 1))
+                {
+                    return -1;
+                }
+                return (row - top) * side + (col + bit - left);
+            }
+            col += span;
+        }
+    }
+    else
+    {
+        //Going left, the row is read so that col is the top bit.
+        while(col >= left)
+        {
+            int span = std::min(63, col - left + 1);
+            int base = col - 63;
+            uint64_t here = passable.get_bits(row, base);
+            uint64_t above = has_above ? passable.get_bits(row - 1, base) : 0;
+            uint64_t below = has_below ? passable.get_bits(row + 1, base) : 0;
+            uint64_t stop = ~here | (~above & (above << 1)) | (~below & (below << 1));
+            if(row == goal.row && goal.col <= col && goal.col > col - span)
+            {
+                stop |= (uint64_t)1 << (goal.col - base);
+            }
+            stop &= ~(((uint64_t)1 << (64 - span)) - 1);
+            if(stop != 0)
+            {
+                int bit = 63 - __builtin_clzll(stop);
+                if(!((here >> bit) & 1))
+                {
+                    return -1;
+                }
+                return (row - top) * side + (base + bit - left);
+            }
+            col -= span;
+        }
+    }
+    return -1;
+}
+
+void PathSearch::build_path(int goal_index, int start_index)
+{
+    for(int index = goal_index; index != start_index; index = parent[index])
+    {
+        int row = index / side;
+        int col = index % side;
+        int parent_row = parent[index] / side;
+        int parent_col = parent[index] % side;
+        int drow = (parent_row > row) - (parent_row < row);
+        int dcol = (parent_col > col) - (parent_col < col);
+        while(row != parent_row || col != parent_col)
+        {
+            path.push_back(IntPoint(row + top, col + left));
+            row += drow;
+            col += dcol;
+        }
+    }
+}
+
+const std::vector<IntPoint>& PathSearch::get_path() const
+{
+    return path;
+}
+
+int PathSearch::get_expanded() const
+{
+    return expanded;
+}
@@ -0,0 +1,224 @@
+/**
+ *  PATH_SEARCH.H
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PATH_SEARCH_H
+#define PATH_SEARCH_H
+
+#include <vector>
+
+#include "int_point.h"
+#include "bit_grid.h"
+
+/**
+ * The ways that PathSearch can look for a path.  Both find a shortest
+ * path; jump point search just gets there while touching fewer tiles.
+ */
+enum SearchMode
+{
+    PATH_A_STAR,
+    PATH_JUMP_POINT
+};
+
+/**
+ * Finds paths on a passability grid with A*.  Moves go in all eight
+ * directions, costing 10 straight and 14 diagonally.
+ *
+ * A search only looks at a square window around the start, and every
+ * tile in the window gets a slot in flat arrays for its g value, its
+ * parent and whether it's closed.  Rather than clearing those arrays
+ * before each search, every slot is stamped with the number of the search
+ * that last wrote it, and anything with an old stamp counts as untouched.
+ * The open list is a binary heap, and tiles that get a better g are pushed
+ * again instead of being found and updated; the stale copy is skipped
+ * when it comes off the heap.
+ *
+ * The arrays are kept between searches, so keep a PathSearch around
+ * instead of making one for every search.
+ */
+class PathSearch
+{
+    public:
+        PathSearch();
+
+        /**
+         * Finds the shortest path from start to goal.
+         * @param passable Which tiles can be moved through.  The start
+         * doesn't have to be passable, but the goal does.
+         * @param start Where the path starts.
+         * @param goal Where the path should end.
+         * @param radius How far from the start, in rows or columns, the
+         * search is allowed to go.
+         * @return Whether a path was found.  If it was, get_path() has it.
+         */
+        bool a_star(const BitGrid& passable, IntPoint start, IntPoint goal, int radius);
+
+        /**
+         * Finds the shortest path from start to goal with jump point
+         * search.  Every move costs the same on these grids, so most paths
+         * have lots of others just as short that only differ in the order
+         * of their moves.  Jump point search only ever follows one of
+         * them: it runs in a straight line (scanning 64 tiles at a time
+         * along rows) until it hits a wall, the goal, or a tile with a
+         * "forced" neighbor that a wall stopped the straight line from
+         * reaching, and only those jump points go on the open list.
+         *
+         * Takes the same arguments as a_star, and the path it finds is
+         * just as short, though it might not be the same one.
+         */
+        bool jump_point(const BitGrid& passable, IntPoint start, IntPoint goal, int radius);
+
+        /**
+         * Runs a_star or jump_point, depending on the mode.
+         */
+        bool find(SearchMode mode, const BitGrid& passable, IntPoint start, IntPoint goal, int radius);
+
+        /**
+         * The path found by the last search, starting with the goal and
+         * going back to the tile right after the start, so the next step
+         * is at the back.  Empty if there was no path.
+         */
+        const std::vector<IntPoint>& get_path() const;
+
+        /**
+         * How many tiles the last search took off of the open list.
+         */
+        int get_expanded() const;
+
+        /**
+         * An estimate of the cost from one tile to another that never
+         * guesses too high: 14 for every diagonal step and 10 for every
+         * straight one, as if there were no walls.
+         */
+        static int octile(int drow, int dcol);
+
+    private:
+        /**
+         * An entry in the open list.  index is the tile's slot in the
+         * window.
+         */
+        struct OpenNode
+        {
+            int f;
+            int g;
+            int index;
+        };
+
+        /**
+         * Orders the heap so the lowest f comes off first.  Ties go to
+         * the higher g, which is closer to the goal, and then to the
+         * lower index, so the same search always finds the same path.
+         */
+        struct LaterNode
+        {
+            bool operator()(const OpenNode& a, const OpenNode& b) const
+            {
+                if(a.f != b.f)
+                {
+                    return a.f > b.f;
+                }
+                if(a.g != b.g)
+                {
+                    return a.g < b.g;
+                }
+                return a.index > b.index;
+            }
+        };
+
+        /**
+         * The top left corner of the window and how many tiles it is on a
+         * side.
+         */
+        int top;
+        int left;
+        int side;
+
+        std::vector<int> g;
+        std::vector<int> parent;
+
+        /**
+         * The search that last set a tile's g value, and the search that
+         * last closed it.
+         */
+        std::vector<unsigned int> opened;
+        std::vector<unsigned int> closed;
+
+        /**
+         * The number of the current search.  Never 0, so that a freshly
+         * made slot is never mistaken for one from this search.
+         */
+        unsigned int generation;
+
+        std::vector<OpenNode> open;
+        std::vector<IntPoint> path;
+        int expanded;
+
+        /**
+         * Moves the window and starts a new generation, growing the
+         * arrays if the window got bigger.
+         */
+        void begin(int _top, int _left, int _side);
+
+        /**
+         * Follows the parents back from the goal to fill in the path.
+         * Parents that are more than one tile away (which is what jump
+         * point search leaves) get the straight or diagonal line between
+         * them filled in.
+         */
+        void build_path(int goal_index, int start_index);
+
+        /**
+         * Gets the window ready for a search, and makes sure the goal is
+         * inside it and passable.
+         * @return The goal's slot in the window, or -1 if it can't be
+         * reached.
+         */
+        int start_search(const BitGrid& passable, IntPoint start, IntPoint goal, int radius);
+
+        /**
+         * Whether a tile can be moved through.  Tiles outside the window
+         * can't.
+         */
+        bool open_at(const BitGrid& passable, int row, int col) const
+        {
+            return row >= top && col >= left && row < top + side && col < left + side &&
+                passable.test(row, col);
+        }
+
+        /**
+         * Adds a tile to the open list for jump point search, unless it's
+         * closed or already has a g at least as good.
+         */
+        void push_jump(int index, int from, int next_g, IntPoint goal);
+
+        /**
+         * Runs from (row, col) in a direction until it finds a jump point.
+         * (row, col) is the first tile that gets looked at, not the one
+         * the jump started from.
+         * @return The slot of the jump point, or -1 if it ran into a wall
+         * or the edge of the window first.
+         */
+        int jump(const BitGrid& passable, int row, int col, int drow, int dcol, IntPoint goal) const;
+
+        /**
+         * jump() going along a row, a word at a time.
+         */
+        int jump_row(const BitGrid& passable, int row, int col, int dcol, IntPoint goal) const;
+};
+
+#endif
@@ -0,0 +1,162 @@
+/**
+ *  PROFILER.CPP
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <fstream>
+
+#include "profiler.h"
+
+Profiler& Profiler::instance()
+{
+    static Profiler profiler_instance;
+    return profiler_instance;
+}
+
+Profiler::Profiler()
+{
+    show_overlay = false;
+}
+
+int Profiler::get_section(const std::string& section)
+{
+    std::map<std::string, int>::iterator it = section_index.find(section);
+    if(it != section_index.end())
+    {
+        return it->second;
+    }
+
+    Section new_section;
+    new_section.name = section;
+    new_section.current = 0;
+    new_section.ran = false;
+    new_section.next = 0;
+    sections.push_back(new_section);
+    section_index[section] = sections.size() - 1;
+    return sections.size() - 1;
+}
+
+void Profiler::add_time(const std::string& section, long micros)
+{
+    Section* s = &sections[get_section(section)];
+    s->current += micros;
+    s->ran = true;
+}
+
+void Profiler::end_frame()
+{
+    for(int i=0;i<sections.size();i++)
+    {
+        Section* s = &sections[i];
+        if(!s->ran)
+        {
+            continue;
+        }
+
+        //Fill the window up first, then start overwriting the oldest
+        //sample.
+        if(s->samples.size() < WINDOW_SIZE)
+        {
+            s->samples.push_back(s->current);
+        }
+        else
+        {
+            s->samples[s->next] = s->current;
+        }
+        s->next = (s->next + 1) % WINDOW_SIZE;
+        s->current = 0;
+        s->ran = false;
+    }
+}
+
+long Profiler::percentile(const std::string& section, int percent)
+{
+    std::map<std::string, int>::iterator it = section_index.find(section);
+    if(it == section_index.end() || sections[it->second].samples.size() == 0)
+    {
+        return 0;
+    }
+
+    //Copy, so that the order of the ring buffer isn't messed with.
+    std::vector<long> sorted = sections[it->second].samples;
+    int index = (percent * (sorted.size() - 1) + 50) / 100;
+    std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+    return sorted[index];
+}
+
+std::vector<std::string> Profiler::get_sections()
+{
+    std::vector<std::string> names;
+    for(int i=0;i<sections.size();i++)
+    {
+        names.push_back(sections[i].name);
+    }
+    return names;
+}
+
+void Profiler::reset()
+{
+    for(int i=0;i<sections.size();i++)
+    {
+        sections[i].samples.clear();
+        sections[i].current = 0;
+        sections[i].ran = false;
+        sections[i].next = 0;
+    }
+}
+
+bool Profiler::dump_csv(std::string file_name)
+{
+    std::ofstream out(file_name.c_str());
+    if(!out.good())
+    {
+        return false;
+    }
+
+    out<<"section,frames,p50_us,p95_us,p99_us,max_us"<<std::endl;
+    for(int i=0;i<sections.size();i++)
+    {
+        std::string name = sections[i].name;
+        out<<name<<","<<sections[i].samples.size()<<","
+           <<percentile(name, 50)<<","<<percentile(name, 95)<<","
+           <<percentile(name, 99)<<","<<percentile(name, 100)<<std::endl;
+    }
+    return true;
+}
+
+void Profiler::toggle_overlay()
+{
+    show_overlay = !show_overlay;
+}
+
+bool Profiler::overlay_on()
+{
+    return show_overlay;
+}
+
+ScopedTimer::ScopedTimer(const std::string& _section)
+{
+    section = _section;
+    start = pt::microsec_clock::universal_time();
+}
+
+ScopedTimer::~ScopedTimer()
+{
+    pt::ptime end = pt::microsec_clock::universal_time();
+    Profiler::instance().add_time(section, (end - start).total_microseconds());
+}
@@ -0,0 +1,192 @@
+/**
+ *  PROFILER.H
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+namespace pt = boost::posix_time;
+
+/**
+ * A singleton which keeps track of how long each part of a frame takes.
+ *
+ * Timers report how many microseconds a named section took.  Everything that
+ * gets reported during a single frame is added together, and when the frame
+ * ends the total is pushed onto a rolling window of the most recent frames
+ * for that section.  The percentiles are calculated from that window, so
+ * that one slow frame doesn't hide in an average.
+ */
+class Profiler
+{
+    public:
+        /**
+         * Returns the single instance of the profiler, or creates one if it
+         * doesn't exist.
+         */
+        static Profiler& instance();
+
+        /**
+         * Adds time to a section for the current frame.  Sections are
+         * created the first time they are seen.
+         * @param section The name of the section.
+         * @param micros The number of microseconds that passed.
+         */
+        void add_time(const std::string& section, long micros);
+
+        /**
+         * Ends the current frame, pushing the time of every section which
+         * ran this frame into its rolling window.
+         */
+        void end_frame();
+
+        /**
+         * Gets the percentile of the frame times for a section, in
+         * microseconds.  Returns 0 if the section has no samples.
+         * @param section The name of the section.
+         * @param percent The percentile to get (0-100).
+         */
+        long percentile(const std::string& section, int percent);
+
+        /**
+         * Returns the names of all of the sections, in the order that they
+         * were first seen.
+         */
+        std::vector<std::string> get_sections();
+
+        /**
+         * Throws away all of the recorded samples.
+         */
+        void reset();
+
+        /**
+         * Writes the percentiles of every section to a CSV file.
+         * @param file_name The file to write to.
+         * @return True if the file could be written.
+         */
+        bool dump_csv(std::string file_name);
+
+        /**
+         * Flips whether or not the overlay should be drawn.
+         */
+        void toggle_overlay();
+
+        /**
+         * Returns true if the overlay should be drawn.
+         */
+        bool overlay_on();
+
+    private:
+        /**
+         * The number of frames to keep for each section.
+         */
+        static const int WINDOW_SIZE = 256;
+
+        /**
+         * The rolling window of frame times for a single section.
+         */
+        struct Section
+        {
+            std::string name;
+
+            /**
+             * The time accumulated in the current frame.
+             */
+            long current;
+
+            /**
+             * Whether or not the section ran during the current frame.
+             */
+            bool ran;
+
+            /**
+             * The frame times, used as a ring buffer.
+             */
+            std::vector<long> samples;
+
+            /**
+             * The place the next sample will be written to.
+             */
+            int next;
+        };
+
+        /**
+         * Maps the name of a section to its index in sections.
+         */
+        std::map<std::string, int> section_index;
+
+        /**
+         * All of the sections, in the order they were first seen.
+         */
+        std::vector<Section> sections;
+
+        /**
+         * Whether or not the overlay is being drawn.
+         */
+        bool show_overlay;
+
+        /**
+         * Gets the index of a section, creating the section if it
+         * doesn't exist.
+         */
+        int get_section(const std::string& section);
+
+        /**
+         * Constructs the profiler.  Private so that it can't be called
+         * outside of the profiler.
+         */
+        Profiler();
+
+        /**
+         * The copy constructor, made private to guarantee that it can't be
+         * called.
+         */
+        Profiler(Profiler const&);
+
+        /**
+         * The assignment operator, made private so that it can never be
+         * called.
+         */
+        Profiler& operator=(Profiler const&);
+};
+
+/**
+ * Times the scope that it lives in.  When it is destroyed, the time since it
+ * was created is added to the section in the profiler.
+ *
+ * {
+ *     ScopedTimer timer("refresh");
+ *     refresh();
+ * }
+ */
+class ScopedTimer
+{
+    public:
+        ScopedTimer(const std::string& _section);
+        ~ScopedTimer();
+
+    private:
+        std::string section;
+        pt::ptime start;
+};
+
+#endif
@@ -0,0 +1,73 @@
+/**
+ *  SHADOWCAST.CPP
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include "shadowcast.h"
+
+VisibleSet::VisibleSet()
+{
+    reset(0);
+}
+
+VisibleSet::VisibleSet(int _radius)
+{
+    reset(_radius);
+}
+
+void VisibleSet::reset(int _radius)
+{
+    radius = _radius;
+    side = radius * 2 + 1;
+    size_t words = (side * side + 63) / 64;
+    if(bits.size() != words)
+    {
+        bits = std::vector<uint64_t>(words);
+    }
+    clear();
+}
+
+void VisibleSet::clear()
+{
+    std::fill(bits.begin(), bits.end(), 0);
+}
+
+int VisibleSet::get_radius() const
+{
+    return radius;
+}
+
+int VisibleSet::count() const
+{
+    int total = 0;
+    for(size_t i = 0; i < bits.size(); i++)
+    {
+        total += __builtin_popcountll(bits[i]);
+    }
+    return total;
+}
+
+bool VisibleSet::operator==(const VisibleSet& other) const
+{
+    return radius == other.radius && bits == other.bits;
+}
+
+bool VisibleSet::operator!=(const VisibleSet& other) const
+{
+    return !(*this == other);
+}
@@ -0,0 +1,214 @@
+/**
+ *  SHADOWCAST.H
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SHADOWCAST_H
+#define SHADOWCAST_H
+
+#include <vector>
+#include <stdint.h>
+
+/**
+ * The cells that a viewer can see, one bit per cell.  The set covers the
+ * square of (radius * 2 + 1) cells on a side around the viewer, and every
+ * position is relative to the viewer, so (0, 0) is the viewer itself.
+ */
+class VisibleSet
+{
+    private:
+        int radius;
+        int side;
+        std::vector<uint64_t> bits;
+
+    public:
+        VisibleSet();
+        VisibleSet(int _radius);
+
+        /**
+         * Clears the set and makes it big enough for the given radius.
+         */
+        void reset(int _radius);
+
+        /**
+         * Marks every cell as not visible.
+         */
+        void clear();
+
+        int get_radius() const;
+
+        /**
+         * The number of visible cells.
+         */
+        int count() const;
+
+        bool operator==(const VisibleSet& other) const;
+        bool operator!=(const VisibleSet& other) const;
+
+        /**
+         * True if (row, col) is inside the square that the set covers.
+         */
+        bool in_range(int row, int col) const
+        {
+            return row >= -radius && row <= radius && col >= -radius && col <= radius;
+        }
+
+        //These get called for every cell in the field of view, so they
+        //live in the header where they can be inlined.
+        void set(int row, int col)
+        {
+            int index = (row + radius) * side + (col + radius);
+            bits[index >> 6] |= (uint64_t)1 << (index & 63);
+        }
+
+        bool test(int row, int col) const
+        {
+            if(!in_range(row, col))
+            {
+                return false;
+            }
+            int index = (row + radius) * side + (col + radius);
+            return (bits[index >> 6] >> (index & 63)) & 1;
+        }
+};
+
+/**
+ * Symmetric shadowcasting.  The field of view is split into four
+ * quadrants, and each one is scanned a row at a time going away from the
+ * viewer.  Every row remembers the range of slopes that light can still
+ * get through, and an opaque cell splits that range, so each cell is only
+ * looked at once (the diagonals between quadrants are looked at twice).
+ *
+ * It's symmetric: if A can see B, then B can see A.  Floor cells are only
+ * visible if their center is in the lit range, while walls are visible if
+ * any part of them is, so the walls of a room are always lit.
+ *
+ * See https://www.albertford.com/shadowcasting/ for a longer description.
+ */
+namespace shadowcast
+{
+    /**
+     * A slope of num / den, where den is always positive.  Slopes are kept
+     * as fractions so that there is no rounding error.
+     */
+    struct Slope
+    {
+        int num;
+        int den;
+    };
+
+    /**
+     * Rounds down, even for negative numbers.
+     */
+    inline int floor_div(int a, int b)
+    {
+        int q = a / b;
+        if((a % b != 0) && ((a < 0) != (b < 0)))
+        {
+            q--;
+        }
+        return q;
+    }
+
+    /**
+     * Turns (depth, col) in a quadrant into (row, col) relative to the
+     * viewer.  Quadrants are 0: up, 1: down, 2: right, 3: left.
+     */
+    inline void transform(int quadrant, int depth, int col, int& row_out, int& col_out)
+    {
+        switch(quadrant)
+        {
+            case 0: row_out = -depth; col_out = col; break;
+            case 1: row_out = depth; col_out = col; break;
+            case 2: row_out = col; col_out = depth; break;
+            default: row_out = col; col_out = -depth; break;
+        }
+    }
+
+    template<typename Opaque>
+    void scan(int quadrant, int depth, Slope start, Slope end, int radius,
+            const Opaque& is_opaque, VisibleSet& visible)
+    {
+        if(depth > radius)
+        {
+            return;
+        }
+
+        //The first and last columns whose centers are lit, rounding
+        //toward the middle of the row on ties.
+        int min_col = floor_div(2 * depth * start.num + start.den, 2 * start.den);
+        int max_col = -floor_div(-(2 * depth * end.num - end.den), 2 * end.den);
+        int limit = radius * radius + radius;
+
+        //-1 before the first cell, then 0 for floor and 1 for walls.
+        int prev = -1;
+        for(int col = min_col; col <= max_col; col++)
+        {
+            int row_rel, col_rel;
+            transform(quadrant, depth, col, row_rel, col_rel);
+            bool wall = is_opaque(row_rel, col_rel);
+            bool symmetric = col * start.den >= depth * start.num &&
+                col * end.den <= depth * end.num;
+
+            if((wall || symmetric) && row_rel * row_rel + col_rel * col_rel <= limit)
+            {
+                visible.set(row_rel, col_rel);
+            }
+
+            if(prev == 1 && !wall)
+            {
+                start.num = 2 * col - 1;
+                start.den = 2 * depth;
+            }
+            if(prev == 0 && wall)
+            {
+                Slope next_end = {2 * col - 1, 2 * depth};
+                scan(quadrant, depth + 1, start, next_end, radius, is_opaque, visible);
+            }
+            prev = wall ? 1 : 0;
+        }
+
+        if(prev == 0)
+        {
+            scan(quadrant, depth + 1, start, end, radius, is_opaque, visible);
+        }
+    }
+
+    /**
+     * Works out everything that can be seen from the origin.
+     * @param radius How far the viewer can see.
+     * @param is_opaque Something that can be called as is_opaque(row, col),
+     * with the row and column relative to the viewer, and returns true if
+     * light can't get through that cell.  Anything off the edge of the map
+     * should count as opaque.
+     * @param visible Gets reset to the radius and filled in.
+     */
+    template<typename Opaque>
+    void compute(int radius, const Opaque& is_opaque, VisibleSet& visible)
+    {
+        visible.reset(radius);
+        visible.set(0, 0);
+        for(int quadrant = 0; quadrant < 4; quadrant++)
+        {
+            Slope start = {-1, 1};
+            Slope end = {1, 1};
+            scan(quadrant, 1, start, end, radius, is_opaque, visible);
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,136 @@
+/**
+ *  SIGHT_CONE.CPP
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <map>
+#include <mutex>
+#include "sight_cone.h"
+#include "bresenham.h"
+#include "math_helper.h"
+
+namespace
+{
+    /**
+     * True if the direction to the offset is between lower and upper,
+     * which are in percent and can go past either end of 0-100.
+     */
+    bool in_arc(int row, int col, int lower, int upper)
+    {
+        if(upper - lower >= 100)
+        {
+            return true;
+        }
+        double percent = coords_to_rad(IntPoint(row, col)) / (2 * PI) * 100;
+        double from_lower = percent - lower;
+        while(from_lower < 0)
+        {
+            from_lower += 100;
+        }
+        while(from_lower >= 100)
+        {
+            from_lower -= 100;
+        }
+        return from_lower <= upper - lower;
+    }
+
+    /**
+     * Builds a table the same way sight_tiles() used to: a Bresenham line
+     * out to every point on the edge of the circle that's inside the arc.
+     * The circle one smaller gets lines too, to fill in the gaps between
+     * the outer ones.  Cells that more than one line goes through only get
+     * added by the first.
+     */
+    sight_cone::Cone build(int radius, int direction, int view)
+    {
+        //Works out the same bounds as Character::get_fov().
+        int upper = direction + (.5 * view);
+        int lower = direction - (.5 * view);
+
+        IntPoint center = IntPoint(0, 0);
+        std::vector<IntPoint> edge = bresenham_circle(center, radius);
+        if(radius > 1)
+        {
+            std::vector<IntPoint> inner = bresenham_circle(center, radius - 1);
+            edge.insert(edge.end(), inner.begin(), inner.end());
+        }
+
+        int side = radius * 2 + 1;
+        std::vector<int> index(side * side, -1);
+        sight_cone::Cone cone;
+        for(size_t i = 0; i < edge.size(); i++)
+        {
+            if(!in_arc(edge[i].row, edge[i].col, lower, upper))
+            {
+                continue;
+            }
+
+            //bresenham_line() stops just short of the end, so add it on.
+            std::vector<IntPoint> line = bresenham_line(center, edge[i]);
+            line.push_back(edge[i]);
+
+            int parent = -1;
+            for(size_t j = 1; j < line.size(); j++)
+            {
+                int cell_index = (line[j].row + radius) * side + (line[j].col + radius);
+                if(index[cell_index] == -1)
+                {
+                    sight_cone::Cell cell = {line[j].row, line[j].col, parent};
+                    index[cell_index] = cone.size();
+                    cone.push_back(cell);
+                }
+                parent = index[cell_index];
+            }
+        }
+        return cone;
+    }
+}
+
+int sight_cone::facing(int direction)
+{
+    return ((direction % 100) + 100) % 100;
+}
+
+const sight_cone::Cone& sight_cone::get(int radius, int direction, int view)
+{
+    //The AI asks for cones from several threads at once.  Tables never
+    //move once they're in the map, so only the lookup needs the lock.
+    static std::map<long, Cone> tables;
+    static std::mutex tables_mutex;
+    if(radius < 0)
+    {
+        radius = 0;
+    }
+    if(view > 100)
+    {
+        view = 100;
+    }
+    else if(view < 0)
+    {
+        view = 0;
+    }
+    int bucket = facing(direction);
+    long key = ((long)radius * 100 + bucket) * 101 + view;
+
+    std::lock_guard<std::mutex> lock(tables_mutex);
+    std::map<long, Cone>::iterator it = tables.find(key);
+    if(it == tables.end())
+    {
+        it = tables.insert(std::make_pair(key, build(radius, bucket, view))).first;
+    }
+    return it->second;
+}
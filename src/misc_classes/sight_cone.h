@@ -0,0 +1,93 @@
+/**
+ *  SIGHT_CONE.H
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SIGHT_CONE_H
+#define SIGHT_CONE_H
+
+#include <vector>
+#include <stddef.h>
+
+/**
+ * Precomputed tables of the cells that a character can see, for every
+ * combination of sight radius, facing and width of view.  A table gets
+ * built the first time it's asked for and is kept around after that, so
+ * looking around doesn't need any trigonometry or allocation.
+ */
+namespace sight_cone
+{
+    /**
+     * One cell in a sight cone, relative to the viewer.  The parent is the
+     * index of the cell before it on the Bresenham line from the viewer,
+     * or -1 if it's right next to the viewer.  Parents always come before
+     * their children in the table.
+     */
+    struct Cell
+    {
+        int row;
+        int col;
+        int parent;
+    };
+
+    typedef std::vector<Cell> Cone;
+
+    /**
+     * Turns a direction (0-100, where 0 is to the right) into one of the
+     * 100 facings that tables are built for.
+     */
+    int facing(int direction);
+
+    /**
+     * Gets the table for a viewer that can see radius cells away, is
+     * looking in the given direction and can see view percent of the way
+     * around.  Every cell shows up once, and the viewer isn't in it.
+     */
+    const Cone& get(int radius, int direction, int view);
+
+    /**
+     * Walks a sight cone, calling visit(row, col) for every cell that can
+     * be seen.  A cell can be seen if the cell before it on its line can
+     * be seen and doesn't block light, so walls are seen but not what's
+     * behind them.
+     * @param is_opaque Called as is_opaque(row, col) relative to the viewer.
+     * @param clear Scratch space.  It only grows, so if the caller keeps
+     * it around then walking doesn't allocate anything.
+     */
+    template<typename Opaque, typename Visit>
+    void trace(const Cone& cone, const Opaque& is_opaque, std::vector<unsigned char>& clear,
+            Visit& visit)
+    {
+        if(clear.size() < cone.size())
+        {
+            clear.resize(cone.size());
+        }
+        for(size_t i = 0; i < cone.size(); i++)
+        {
+            const Cell& cell = cone[i];
+            if(cell.parent >= 0 && !clear[cell.parent])
+            {
+                clear[i] = 0;
+                continue;
+            }
+            visit(cell.row, cell.col);
+            clear[i] = !is_opaque(cell.row, cell.col);
+        }
+    }
+}
+
+#endif
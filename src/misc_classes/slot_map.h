@@ -0,0 +1,196 @@
+/**
+ *  SLOT_MAP.H
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SLOT_MAP_H
+#define SLOT_MAP_H
+
+#include <vector>
+#include <cstddef>
+
+/**
+ * A reference to something in a SlotMap.  It stays the same for as long
+ * as the thing is in the map, and once it's been taken out the handle
+ * doesn't find anything, even after its slot has been used again.
+ */
+struct SlotHandle
+{
+    unsigned int index;
+
+    /**
+     * Which use of the slot this is.  0 is never used, so a default
+     * handle never finds anything.
+     */
+    unsigned int generation;
+
+    SlotHandle() : index(0), generation(0) {}
+
+    bool is_null() const
+    {
+        return generation == 0;
+    }
+
+    bool operator==(const SlotHandle& other) const
+    {
+        return index == other.index && generation == other.generation;
+    }
+
+    bool operator!=(const SlotHandle& other) const
+    {
+        return !(*this == other);
+    }
+};
+
+/**
+ * Keeps values in one packed array, and hands out SlotHandles for them.
+ * Looking up a handle, adding and removing are all constant time:
+ * removing moves the last value into the gap, and the slot remembers
+ * where its value went.  The values aren't kept in any particular order.
+ */
+template<typename T>
+class SlotMap
+{
+    public:
+        SlotHandle insert(const T& value)
+        {
+            unsigned int index;
+            if(free_slots.empty())
+            {
+                index = slots.size();
+                Slot slot = {1, -1};
+                slots.push_back(slot);
+            }
+            else
+            {
+                index = free_slots.back();
+                free_slots.pop_back();
+            }
+            slots[index].place = values.size();
+            values.push_back(value);
+            owners.push_back(index);
+
+            SlotHandle handle;
+            handle.index = index;
+            handle.generation = slots[index].generation;
+            return handle;
+        }
+
+        /**
+         * Takes a value out.  Its handle, and any copies of it, won't find
+         * anything afterwards.
+         * @return False if the handle didn't find anything.
+         */
+        bool erase(SlotHandle handle)
+        {
+            if(!contains(handle))
+            {
+                return false;
+            }
+            Slot& slot = slots[handle.index];
+            int last = values.size() - 1;
+            values[slot.place] = values[last];
+            owners[slot.place] = owners[last];
+            slots[owners[slot.place]].place = slot.place;
+            values.pop_back();
+            owners.pop_back();
+
+            slot.place = -1;
+            slot.generation++;
+            if(slot.generation == 0)
+            {
+                slot.generation = 1;
+            }
+            free_slots.push_back(handle.index);
+            return true;
+        }
+
+        bool contains(SlotHandle handle) const
+        {
+            return handle.index < slots.size() && slots[handle.index].generation == handle.generation &&
+                slots[handle.index].place >= 0;
+        }
+
+        /**
+         * The value for a handle, or NULL if it's been taken out.
+         */
+        T* get(SlotHandle handle)
+        {
+            return contains(handle) ? &values[slots[handle.index].place] : NULL;
+        }
+
+        const T* get(SlotHandle handle) const
+        {
+            return contains(handle) ? &values[slots[handle.index].place] : NULL;
+        }
+
+        /**
+         * Where a handle's value is in get_values(), or -1 if it's been
+         * taken out.  Removing something can move the last value, so it
+         * only holds until the next erase.
+         */
+        int place(SlotHandle handle) const
+        {
+            return contains(handle) ? slots[handle.index].place : -1;
+        }
+
+        /**
+         * The handle of the value at a place in get_values().
+         */
+        SlotHandle handle_at(int place) const
+        {
+            SlotHandle handle;
+            handle.index = owners[place];
+            handle.generation = slots[handle.index].generation;
+            return handle;
+        }
+
+        int size() const
+        {
+            return values.size();
+        }
+
+        /**
+         * Every value, packed together.
+         */
+        std::vector<T>& get_values()
+        {
+            return values;
+        }
+
+    private:
+        struct Slot
+        {
+            unsigned int generation;
+
+            /**
+             * Where the value is in values, or -1 if the slot is free.
+             */
+            int place;
+        };
+
+        std::vector<Slot> slots;
+        std::vector<T> values;
+
+        /**
+         * The slot of each value.
+         */
+        std::vector<unsigned int> owners;
+        std::vector<unsigned int> free_slots;
+};
+
+#endif
@@ -0,0 +1,160 @@
+/**
+ *  TIMING_WHEEL.CPP
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstddef>
+#include "timing_wheel.h"
+
+TimingWheel::TimingWheel()
+{
+    for(int level = 0; level < LEVELS; level++)
+    {
+        for(int word = 0; word < WORDS; word++)
+        {
+            occupied[level][word] = 0;
+        }
+    }
+    current = 0;
+    count = 0;
+}
+
+void TimingWheel::schedule(int id, long time)
+{
+    Entry entry = {id, time > current ? time : current + 1};
+    place(entry);
+    count++;
+}
+
+void TimingWheel::place(const Entry& entry)
+{
+    long delta = entry.time - current;
+    int level = 0;
+    while(level < LEVELS - 1 && delta >= (1L << (SLOT_BITS * (level + 1))))
+    {
+        level++;
+    }
+
+    long time = entry.time;
+    long reach = 1L << (SLOT_BITS * LEVELS);
+    if(delta >= reach)
+    {
+        //The slot just behind the current one on the top wheel is the
+        //last one to come around.
+        time = current + reach - (1L << (SLOT_BITS * level));
+    }
+    int slot = (time >> (SLOT_BITS * level)) & (SLOTS - 1);
+    slots[level][slot].push_back(entry);
+    occupied[level][slot >> 6] |= (uint64_t)1 << (slot & 63);
+}
+
+bool TimingWheel::take(int level, int slot)
+{
+    uint64_t bit = (uint64_t)1 << (slot & 63);
+    if(!(occupied[level][slot >> 6] & bit))
+    {
+        return false;
+    }
+    occupied[level][slot >> 6] &= ~bit;
+    return true;
+}
+
+void TimingWheel::cascade(int level)
+{
+    if(level >= LEVELS)
+    {
+        return;
+    }
+    int slot = (current >> (SLOT_BITS * level)) & (SLOTS - 1);
+    if(slot == 0)
+    {
+        cascade(level + 1);
+    }
+    if(!take(level, slot))
+    {
+        return;
+    }
+
+    //Swapping with spill instead of copying means that neither one
+    //has to give up the memory it's already got.
+    spill.swap(slots[level][slot]);
+    for(size_t i = 0; i < spill.size(); i++)
+    {
+        place(spill[i]);
+    }
+    spill.clear();
+}
+
+int TimingWheel::next_occupied(int slot) const
+{
+    for(int word = (slot + 1) >> 6; word < WORDS; word++)
+    {
+        uint64_t bits = occupied[0][word];
+        if(word == (slot + 1) >> 6)
+        {
+            //Only the bits after the slot.
+            bits = bits >> ((slot + 1) & 63) << ((slot + 1) & 63);
+        }
+        if(bits != 0)
+        {
+            return (word << 6) + __builtin_ctzll(bits);
+        }
+    }
+    return SLOTS;
+}
+
+void TimingWheel::advance(long time, std::vector<int>& due)
+{
+    while(current < time)
+    {
+        //Skip straight to the next slot with something in it, or to the
+        //end of the first wheel, whichever is sooner.
+        long next = (current & ~(long)(SLOTS - 1)) + next_occupied(current & (SLOTS - 1));
+        if(next > time)
+        {
+            current = time;
+            break;
+        }
+
+        current = next;
+        int slot = current & (SLOTS - 1);
+        if(slot == 0)
+        {
+            cascade(1);
+        }
+        if(take(0, slot))
+        {
+            std::vector<Entry>& entries = slots[0][slot];
+            for(size_t i = 0; i < entries.size(); i++)
+            {
+                due.push_back(entries[i].id);
+            }
+            count -= entries.size();
+            entries.clear();
+        }
+    }
+}
+
+long TimingWheel::get_time() const
+{
+    return current;
+}
+
+int TimingWheel::size() const
+{
+    return count;
+}
@@ -0,0 +1,123 @@
+/**
+ *  TIMING_WHEEL.H
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TIMING_WHEEL_H
+#define TIMING_WHEEL_H
+
+#include <vector>
+#include <stdint.h>
+
+/**
+ * Keeps track of when things are due, in milliseconds, so that only the
+ * things that are due have to be looked at.
+ *
+ * It's a hierarchical timing wheel: four wheels of 256 slots each, where
+ * a slot on the first wheel is a millisecond, a slot on the second is 256
+ * milliseconds, and so on.  Something is put on the finest wheel that
+ * reaches as far as it's due, and every time the wheel below goes all
+ * the way around, the next slot up gets spread out onto it.  Scheduling
+ * is constant time, and so is advancing past empty slots, which get
+ * skipped with a bit scan.
+ *
+ * Anything due further out than the wheels reach (about seven weeks)
+ * waits on the last slot of the top wheel and gets put back whenever that
+ * slot comes around.
+ */
+class TimingWheel
+{
+    public:
+        TimingWheel();
+
+        /**
+         * Schedules an id.  Anything due at or before the current time is
+         * due on the next millisecond instead.
+         * @param time When it's due.
+         */
+        void schedule(int id, long time);
+
+        /**
+         * Moves the clock forward.
+         * @param time The new time.  Nothing happens if it's in the past.
+         * @param due Gets the ids that came due on the way, in the order
+         * they're due.  Ids due on the same millisecond come out in the
+         * order they got to the first wheel, which is always the same for
+         * the same schedule.
+         */
+        void advance(long time, std::vector<int>& due);
+
+        long get_time() const;
+
+        /**
+         * How many ids are waiting.
+         */
+        int size() const;
+
+    private:
+        static const int LEVELS = 4;
+        static const int SLOT_BITS = 8;
+        static const int SLOTS = 1 << SLOT_BITS;
+        static const int WORDS = SLOTS / 64;
+
+        struct Entry
+        {
+            int id;
+            long time;
+        };
+
+        std::vector<Entry> slots[LEVELS][SLOTS];
+
+        /**
+         * One bit for every slot with something in it.
+         */
+        uint64_t occupied[LEVELS][WORDS];
+
+        long current;
+        int count;
+
+        /**
+         * Where a slot's entries go while they're being spread out.
+         */
+        std::vector<Entry> spill;
+
+        /**
+         * Puts an entry on the finest wheel that reaches it.
+         */
+        void place(const Entry& entry);
+
+        /**
+         * Clears a slot's bit.
+         * @return Whether it was set.
+         */
+        bool take(int level, int slot);
+
+        /**
+         * The first slot after this one on the first wheel with something
+         * in it, or SLOTS if there isn't one.
+         */
+        int next_occupied(int slot) const;
+
+        /**
+         * Spreads the slot of a wheel that the clock has just come to
+         * out onto the wheel below it, after doing the same for the
+         * wheels above if they've come around too.
+         */
+        void cascade(int level);
+};
+
+#endif
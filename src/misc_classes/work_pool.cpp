@@ -0,0 +1,155 @@
+/**
+ *  WORK_POOL.CPP
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include "work_pool.h"
+
+WorkPool::WorkPool(int _workers)
+{
+    workers = _workers;
+    if(workers <= 0)
+    {
+        workers = std::max(1, (int)std::thread::hardware_concurrency());
+    }
+    shares.reset(new Share[workers]);
+    for(int i = 0; i < workers; i++)
+    {
+        shares[i].next = 0;
+        shares[i].end = 0;
+    }
+    task = NULL;
+    batch = 0;
+    busy = 0;
+    stopping = false;
+
+    for(int i = 1; i < workers; i++)
+    {
+        threads.push_back(std::thread(&WorkPool::work, this, i));
+    }
+}
+
+WorkPool::~WorkPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    work_ready.notify_all();
+    for(size_t i = 0; i < threads.size(); i++)
+    {
+        threads[i].join();
+    }
+}
+
+void WorkPool::run(int count, const Task& run_task)
+{
+    if(workers == 1 || count <= CLAIM_SIZE)
+    {
+        for(int i = 0; i < count; i++)
+        {
+            run_task(i, 0);
+        }
+        return;
+    }
+
+    for(int i = 0; i < workers; i++)
+    {
+        shares[i].next = (long)count * i / workers;
+        shares[i].end = (long)count * (i + 1) / workers;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        task = &run_task;
+        busy = workers - 1;
+        batch++;
+    }
+    work_ready.notify_all();
+
+    drain(0, run_task);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    work_done.wait(lock, [this]{ return busy == 0; });
+    task = NULL;
+}
+
+int WorkPool::get_workers() const
+{
+    return workers;
+}
+
+void WorkPool::work(int worker)
+{
+    unsigned long last_batch = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    while(true)
+    {
+        work_ready.wait(lock, [this, last_batch]{ return stopping || batch != last_batch; });
+        if(stopping)
+        {
+            return;
+        }
+        last_batch = batch;
+        const Task& run_task = *task;
+        lock.unlock();
+        drain(worker, run_task);
+        lock.lock();
+
+        busy--;
+        if(busy == 0)
+        {
+            work_done.notify_all();
+        }
+    }
+}
+
+void WorkPool::drain(int worker, const Task& run_task)
+{
+    int first;
+    int last;
+    //Start with our own share, then go around the others.
+    for(int offset = 0; offset < workers; offset++)
+    {
+        int share = (worker + offset) % workers;
+        while(claim(share, first, last))
+        {
+            for(int i = first; i < last; i++)
+            {
+                run_task(i, worker);
+            }
+        }
+    }
+}
+
+bool WorkPool::claim(int share, int& first, int& last)
+{
+    //next can go past the end when several workers claim at once, but
+    //everything past the end is ignored.
+    int end = shares[share].end;
+    if(shares[share].next.load(std::memory_order_relaxed) >= end)
+    {
+        return false;
+    }
+    first = shares[share].next.fetch_add(CLAIM_SIZE);
+    if(first >= end)
+    {
+        return false;
+    }
+    last = std::min(end, first + CLAIM_SIZE);
+    return true;
+}
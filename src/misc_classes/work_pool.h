@@ -0,0 +1,121 @@
+/**
+ *  WORK_POOL.H
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef WORK_POOL_H
+#define WORK_POOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+/**
+ * A handful of threads that split up a loop between them, for work that
+ * has to be finished before the frame can go on.
+ *
+ * run() gives every worker an even share of the indices to start on.  A
+ * worker takes a few indices at a time off the front of its share, and
+ * when its share runs out it takes them off the front of the others', so
+ * a worker that got the slow ones doesn't hold everybody up.  The thread
+ * that calls run() is worker 0, and joins in instead of waiting.
+ *
+ * Which worker gets which index isn't fixed, so anything that has to come
+ * out the same every time should only depend on the index.
+ */
+class WorkPool
+{
+    public:
+        typedef std::function<void(int index, int worker)> Task;
+
+        /**
+         * Starts the threads.
+         * @param workers How many workers there should be, counting the
+         * thread that calls run().  0 means one for every core.
+         */
+        WorkPool(int workers = 0);
+
+        /**
+         * Stops the threads.  There can't be a run() going on.
+         */
+        ~WorkPool();
+
+        /**
+         * Calls task once for every index from 0 to count - 1, and returns
+         * once they've all been done.
+         */
+        void run(int count, const Task& task);
+
+        int get_workers() const;
+
+    private:
+        /**
+         * How many indices a worker takes at a time.
+         */
+        static const int CLAIM_SIZE = 4;
+
+        /**
+         * A worker's share of the indices.  Anyone can take from the front
+         * of it.
+         */
+        struct Share
+        {
+            std::atomic<int> next;
+            int end;
+        };
+
+        int workers;
+        std::unique_ptr<Share[]> shares;
+        std::vector<std::thread> threads;
+
+        std::mutex mutex;
+        std::condition_variable work_ready;
+        std::condition_variable work_done;
+
+        const Task* task;
+
+        /**
+         * Goes up for every run(), so the threads can tell a new one from
+         * the one they just did.
+         */
+        unsigned long batch;
+
+        /**
+         * How many threads are still working on the batch.
+         */
+        int busy;
+        bool stopping;
+
+        void work(int worker);
+
+        /**
+         * Does indices until there are none left in any share.
+         */
+        void drain(int worker, const Task& run_task);
+
+        /**
+         * Takes up to CLAIM_SIZE indices off the front of a share.
+         * @return Whether there were any.
+         */
+        bool claim(int share, int& first, int& last);
+};
+
+#endif
@@ -0,0 +1,161 @@
+/**
+ *  BITPLANE.CPP
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <assert.h>
+#include "bitplane.h"
+
+namespace
+{
+    uint64_t low_bits(int count)
+    {
+        return count >= 64 ? ~(uint64_t)0 : (((uint64_t)1 << count) - 1);
+    }
+}
+
+Bitplane::Bitplane()
+{
+    height = 0;
+    width = 0;
+}
+
+Bitplane::Bitplane(int _height, int _width)
+{
+    height = _height;
+    width = _width;
+    words = std::vector<uint64_t>((height * width + 63) / 64);
+}
+
+int Bitplane::get_height() const
+{
+    return height;
+}
+
+int Bitplane::get_width() const
+{
+    return width;
+}
+
+void Bitplane::clear()
+{
+    std::fill(words.begin(), words.end(), 0);
+}
+
+int Bitplane::count() const
+{
+    int total = 0;
+    for(size_t i = 0; i < words.size(); i++)
+    {
+        total += __builtin_popcountll(words[i]);
+    }
+    return total;
+}
+
+bool Bitplane::any(int row, int col, int rect_height, int rect_width) const
+{
+    int first_row = std::max(0, row);
+    int last_row = std::min(height, row + rect_height);
+    int first_col = std::max(0, col);
+    int last_col = std::min(width, col + rect_width);
+    for(int i = first_row; i < last_row; i++)
+    {
+        for(int j = first_col; j < last_col; j += 64)
+        {
+            if(get_bits(i, j, std::min(64, last_col - j)) != 0)
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+uint64_t Bitplane::get_bits(int row, int col, int count) const
+{
+    count = std::min(count, width - col);
+    if(count <= 0 || !in_bounds(row, col))
+    {
+        return 0;
+    }
+
+    int index = row * width + col;
+    int word = index >> 6;
+    int shift = index & 63;
+    uint64_t bits = words[word] >> shift;
+    if(shift != 0 && count > 64 - shift && word + 1 < words.size())
+    {
+        bits |= words[word + 1] << (64 - shift);
+    }
+    return bits & low_bits(count);
+}
+
+void Bitplane::set_bits(int row, int col, int count, uint64_t bits)
+{
+    count = std::min(count, width - col);
+    if(count <= 0 || !in_bounds(row, col))
+    {
+        return;
+    }
+
+    bits &= low_bits(count);
+    int index = row * width + col;
+    int word = index >> 6;
+    int shift = index & 63;
+    words[word] |= bits << shift;
+    if(shift != 0 && count > 64 - shift)
+    {
+        words[word + 1] |= bits >> (64 - shift);
+    }
+}
+
+void Bitplane::merge(const Bitplane& other)
+{
+    assert(other.words.size() == words.size());
+    for(size_t i = 0; i < words.size(); i++)
+    {
+        words[i] |= other.words[i];
+    }
+}
+
+const std::vector<uint64_t>& Bitplane::get_words() const
+{
+    return words;
+}
+
+size_t Bitplane::byte_size() const
+{
+    return (height * width + 7) / 8;
+}
+
+void Bitplane::to_bytes(char* out) const
+{
+    for(size_t i = 0; i < byte_size(); i++)
+    {
+        out[i] = (char)(words[i / 8] >> ((i % 8) * 8));
+    }
+}
+
+void Bitplane::from_bytes(const char* in)
+{
+    clear();
+    for(size_t i = 0; i < byte_size(); i++)
+    {
+        words[i / 8] |= (uint64_t)(unsigned char)in[i] << ((i % 8) * 8);
+    }
+}
@@ -0,0 +1,136 @@
+/**
+ *  BITPLANE.H
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BITPLANE_H
+#define BITPLANE_H
+
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * One bit for every tile of a chunk layer, packed row after row with no
+ * padding, so a 50x100 layer takes 5000 bits (625 bytes).  Chunk layers
+ * use these to remember which of their tiles the main character can see
+ * and has ever seen, instead of keeping it in the tiles themselves.
+ *
+ * Besides looking at single tiles, the bits can be read and written up to
+ * 64 at a time along a row, which is what the renderer and the maps use
+ * to skip over big areas at once.
+ */
+class Bitplane
+{
+    private:
+        int height;
+        int width;
+        std::vector<uint64_t> words;
+
+    public:
+        Bitplane();
+        Bitplane(int _height, int _width);
+
+        int get_height() const;
+        int get_width() const;
+
+        /**
+         * Turns every bit off.
+         */
+        void clear();
+
+        /**
+         * The number of bits that are on.
+         */
+        int count() const;
+
+        /**
+         * True if any bit in the rectangle with its top left corner at
+         * (row, col) is on.  Parts of the rectangle off the edge are
+         * ignored.
+         */
+        bool any(int row, int col, int rect_height, int rect_width) const;
+
+        /**
+         * Reads count bits (up to 64) along a row, starting at (row, col).
+         * Bit 0 of the result is (row, col).  Anything past the end of the
+         * row comes back as 0.
+         */
+        uint64_t get_bits(int row, int col, int count) const;
+
+        /**
+         * Turns on the bits that are on in bits, count of them (up to 64)
+         * along a row starting at (row, col).  Bits past the end of the row
+         * are ignored.
+         */
+        void set_bits(int row, int col, int count, uint64_t bits);
+
+        /**
+         * Turns on every bit that is on in the other plane, a word at a
+         * time.  The planes have to be the same size.
+         */
+        void merge(const Bitplane& other);
+
+        /**
+         * The packed words themselves.  Bit i of the plane is bit (i % 64)
+         * of word (i / 64), where i = row * width + col.
+         */
+        const std::vector<uint64_t>& get_words() const;
+
+        /**
+         * The number of bytes that to_bytes() writes: one bit per tile,
+         * rounded up to a whole byte.
+         */
+        size_t byte_size() const;
+
+        /**
+         * Writes the bits out as byte_size() bytes, for saving.
+         */
+        void to_bytes(char* out) const;
+
+        /**
+         * Reads back bytes written by to_bytes().
+         */
+        void from_bytes(const char* in);
+
+        bool in_bounds(int row, int col) const
+        {
+            return row >= 0 && col >= 0 && row < height && col < width;
+        }
+
+        //The single tile versions are small and get called for every tile
+        //in the field of view, so they're defined here to be inlined.
+        bool test(int row, int col) const
+        {
+            int index = row * width + col;
+            return (words[index >> 6] >> (index & 63)) & 1;
+        }
+
+        void set(int row, int col)
+        {
+            int index = row * width + col;
+            words[index >> 6] |= (uint64_t)1 << (index & 63);
+        }
+
+        void reset(int row, int col)
+        {
+            int index = row * width + col;
+            words[index >> 6] &= ~((uint64_t)1 << (index & 63));
+        }
+};
+
+#endif
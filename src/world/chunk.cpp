@@ -33,6 +33,7 @@
 Chunk::Chunk() {
     cm.height = CHUNK_HEIGHT;
     cm.width = CHUNK_WIDTH;
+    cm.depth = 0;
 }
 
 Chunk::Chunk(MapTile tile_type, int world_row, int world_col, string _save_folder, MapTileMatrix& map) {
@@ -95,6 +96,13 @@ void Chunk::init(MapTile tile_type, int world_row, int world_col, string _save_f
         blend_chunk(world_map, 0, 1);
         blend_chunk(world_map, 0, -1);
     //}
+    build_portals();
+}
+
+void Chunk::build_portals() {
+    for(int i = 0; i < layers.size(); i++) {
+        layers[i].build_portals();
+    }
 }
 
 bool Chunk::build_chunk_with_dungeons() {
@@ -384,10 +392,11 @@ int Chunk::calculate_file_size(int bytes_per_tile) {
 
             for(int k = 0; k < current_plant->get_sprites()->size(); k++) {
                 for(int l = 0; l < (*(current_plant->get_sprites()))[k].size(); l++) {
-                    bytes_per_layer += 2;
+                    bytes_per_layer += 1;
                 }
             }
         }
+        bytes_per_layer += layers[i].get_explored().byte_size();
     }
 
     bytes_per_layer += (BYTES_PER_TILE * cm.width * cm.height * cm.depth);
@@ -424,8 +433,7 @@ int Chunk::serialize_plants(char file[], int layer, int current_byte) {
         for(int j = 0; j < plant_tiles->size(); j++) {
             for(int k = 0; k < ((*plant_tiles)[j]).size(); k++) {
                 file[cb + 0] = ((*plant_tiles)[j])[k].tile_id;
-                file[cb + 1] = ((*plant_tiles)[j])[k].seen;
-                cb += 2;
+                cb += 1;
             }
         }
     }
@@ -475,7 +483,7 @@ int Chunk::serialize_layer_metadata(char file[], int cb) {
 int Chunk::serialize_layers(char file[], int cb) {
     int current_byte=cb;
 
-    char tile_id, seen;
+    char tile_id;
     Tile current_tile;
 
     for(int i = 0; i < cm.depth; i++) {
@@ -483,14 +491,17 @@ int Chunk::serialize_layers(char file[], int cb) {
             for(int k = 0; k < cm.width; k++) {
                 current_tile = *get_tile(i, j, k);
                 tile_id = (char) current_tile.tile_id;
-                seen = (char) current_tile.seen;
 
                 file[current_byte] = tile_id;
-                file[current_byte+1] = seen;
 
                 current_byte += BYTES_PER_TILE;
             }
         }
+
+        //Which tiles have been seen goes after the layer's tiles, packed
+        //one bit per tile.
+        layers[i].get_explored().to_bytes(&file[current_byte]);
+        current_byte += layers[i].get_explored().byte_size();
     }
 
     return current_byte;
@@ -562,8 +573,7 @@ int Chunk::deserialize_plants(char file[], int layer, int current_byte, int num_
                 //TODO plants won't load in correctly. We'll have to find a way
                 //to also hash tiles by id. For now, they'll be rabbit corpses.
                 plant_tiles[j][k] = Tileset::get("RABBIT_CORPSE");
-                plant_tiles[j][k].seen = file[cb + 1];
-                cb += 2;
+                cb += 1;
             }
         }
 
@@ -626,20 +636,20 @@ int Chunk::deserialize_layers(char file_data[], int cb) {
 
     Tile current_tile;
     unsigned int tile_id;
-    bool seen;
     //Undo the serialization.
     for(int i = 0; i < cm.depth; i++) {
         for(int j = 0; j < cm.height; j++) {
             for(int k = 0; k < cm.width; k++) {
                 tile_id = (file_data[current_byte]);
-                seen = file_data[current_byte + 1];
                 current_tile=tiledef::TILE_INDEX[tile_id];
-                current_tile.seen = seen;
 
                 set_tile(i, j, k, current_tile);
                 current_byte += BYTES_PER_TILE;
             }
         }
+
+        layers[i].get_explored().from_bytes(&file_data[current_byte]);
+        current_byte += layers[i].get_explored().byte_size();
     }
 
     return current_byte;
@@ -776,6 +786,30 @@ std::vector<Building>* Chunk::get_buildings(int depth)
     return layers[depth].get_buildings();
 }
 
+const ChunkSummary& Chunk::get_summary(int depth)
+{
+    return layers[depth].get_summary();
+}
+
+Bitplane* Chunk::get_explored(int depth)
+{
+    return &layers[depth].get_explored();
+}
+
+Bitplane* Chunk::get_visible(int depth)
+{
+    return &layers[depth].get_visible();
+}
+
+const ChunkPortals* Chunk::get_portals(int depth) const
+{
+    if(depth < 0 || depth >= layers.size())
+    {
+        return NULL;
+    }
+    return &layers[depth].get_portals();
+}
+
 std::vector<Character*> Chunk::get_character_queue(int depth)
 {
     return layers[depth].get_character_queue();
@@ -48,7 +48,7 @@ class IntPoint;
 
 namespace fs=boost::filesystem;
 
-static const int BYTES_PER_TILE = 2;
+static const int BYTES_PER_TILE = 1;
 static const int CHUNKLAYER_META_BYTES = 6; //spawner row/col, upstairs row/col, downstairs row/col
 static const int CHUNK_META_BYTES = 6; //height, width, depth, chunk_type_id, world_row, world_col
 
@@ -486,6 +486,12 @@ class Chunk{
          */
         void blend_chunk(MapTileMatrix& map, int row_change, int col_change);
 
+        /**
+         * Finds the portals of every layer.  Has to happen after blending,
+         * since that changes the edges.
+         */
+        void build_portals();
+
         /**
          * Blends chunks that should have a "hard line" between them,
          * e.g. water and anything else.
@@ -514,6 +520,27 @@ class Chunk{
          */
         std::vector<Building>* get_buildings(int depth);
 
+        /**
+         * Gets the far away view of one layer of the chunk, for the maps.
+         */
+        const ChunkSummary& get_summary(int depth);
+
+        /**
+         * Which tiles of a layer the main character has seen.
+         */
+        Bitplane* get_explored(int depth);
+
+        /**
+         * Which tiles of a layer the main character can see right now.
+         */
+        Bitplane* get_visible(int depth);
+
+        /**
+         * The portals of a layer, for planning routes between chunks, or
+         * NULL if the chunk doesn't go down that far.
+         */
+        const ChunkPortals* get_portals(int depth) const;
+
         /**
          * Returns the characters which have been created in a parcticular chunk.
          */
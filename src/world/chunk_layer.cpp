@@ -39,6 +39,9 @@ ChunkLayer::ChunkLayer(int _width, int _height, bool _has_layer_below) {
     plants = std::vector<Plant>();
     buildings = std::vector<Building>();
     characters = std::vector<Character*>();
+    summary = ChunkSummary(height, width);
+    explored = Bitplane(height, width);
+    visible = Bitplane(height, width);
     for(int i = 0; i < _height; i++) {
         for(int j = 0; j < _width; j++) {
             ground[i][j] = (*tileset)["BLOCK_WALL"];
@@ -58,6 +61,9 @@ ChunkLayer::ChunkLayer(int _width, int _height) {
     plants = std::vector<Plant>();
     buildings = std::vector<Building>();
     characters = std::vector<Character*>();
+    summary = ChunkSummary(height, width);
+    explored = Bitplane(height, width);
+    visible = Bitplane(height, width);
 
     for(int i = 0; i < _height; i++) {
         for(int j = 0; j < _width; j++) {
@@ -87,6 +93,9 @@ void ChunkLayer::clear() {
     characters = std::vector<Character*>();
 
     tileset = &Tileset::instance()->get_tileset();
+    summary.mark_all_dirty();
+    explored.clear();
+    visible.clear();
 
     for(int i = 0; i < height; i++) {
         for(int j = 0; j < width; j++) {
@@ -112,6 +121,10 @@ void ChunkLayer::swap(const ChunkLayer& l) {
     plants = std::vector<Plant>(l.plants.size());
     buildings = l.buildings;
     characters = l.characters;
+    summary = l.summary;
+    explored = l.explored;
+    visible = l.visible;
+    portals = l.portals;
     for(int i = 0; i < l.plants.size(); i++) {
         plants[i] = l.plants[i];
     }
@@ -147,6 +160,7 @@ void ChunkLayer::set_tile(int row, int col, Tile tile_type) {
     if(row >= 0 && col >= 0 && row < ground.size() && col < ground[row].size())
     {
         ground[row][col] = tile_type;
+        summary.mark_dirty(row, col);
     }
 }
 
@@ -155,6 +169,8 @@ void ChunkLayer::set_tile(IntPoint point, Tile tile_type) {
 }
 
 TileMatrix& ChunkLayer::get_ground() {
+    //Whoever asked for this can change any tile they like.
+    summary.mark_all_dirty();
     return ground;
 }
 
@@ -219,6 +235,8 @@ void ChunkLayer::make_stairs(bool has_layer_below) {
 
     down_stairs.push_back(down_stair);
     up_stairs.push_back(up_stair);
+    summary.mark_dirty(down_stair.row, down_stair.col);
+    summary.mark_dirty(up_stair.row, up_stair.col);
 }
 
 void ChunkLayer::make_stairs_at_coords(int row, int col, Tile stair_type) {
@@ -229,6 +247,7 @@ void ChunkLayer::make_stairs_at_coords(int row, int col, Tile stair_type) {
     } else {
         true;
     }
+    summary.mark_dirty(row, col);
 }
 
 void ChunkLayer::make_spawner(int depth) {
@@ -278,6 +297,7 @@ bool ChunkLayer::in_layer(int x, int y)
 void ChunkLayer::add_building(Building building)
 {
     buildings.push_back(building);
+    summary.mark_area_dirty(building.get_y(), building.get_x(), building.get_height(), building.get_width());
 }
 
 std::vector<Building>* ChunkLayer::get_buildings()
@@ -285,6 +305,27 @@ std::vector<Building>* ChunkLayer::get_buildings()
     return &buildings;
 }
 
+const ChunkSummary& ChunkLayer::get_summary()
+{
+    if(summary.is_dirty())
+    {
+        tileset = &Tileset::instance()->get_tileset();
+        summary.update(ground, buildings, up_stairs, down_stairs,
+                (*tileset)["UP_STAIR"], (*tileset)["DOWN_STAIR"]);
+    }
+    return summary;
+}
+
+Bitplane& ChunkLayer::get_explored()
+{
+    return explored;
+}
+
+Bitplane& ChunkLayer::get_visible()
+{
+    return visible;
+}
+
 std::vector<Character*> ChunkLayer::get_character_queue()
 {
     std::vector<Character*> temp = std::vector<Character*>();
@@ -348,3 +389,11 @@ void ChunkLayer::layer_dump() {
     }
     cout<<"---------------------------------------------"<<endl;
 }
+
+void ChunkLayer::build_portals() {
+    portals.build(ground, up_stairs, down_stairs);
+}
+
+const ChunkPortals& ChunkLayer::get_portals() const {
+    return portals;
+}
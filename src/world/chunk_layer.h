@@ -31,6 +31,9 @@
 #include "room.h"
 #include "plant.h"
 #include "building.h"
+#include "chunk_summary.h"
+#include "bitplane.h"
+#include "chunk_portals.h"
 
 typedef std::vector<std::vector<Tile> > TileMatrix;
 class ChunkLayer {
@@ -71,6 +74,27 @@ class ChunkLayer {
          */
         std::vector<Character*> characters;
 
+        /**
+         * A far away view of the layer for the maps.  Changing a tile marks
+         * its block as dirty, and the block gets summarized again the next
+         * time somebody asks for the summary.
+         */
+        ChunkSummary summary;
+
+        /**
+         * Which tiles the main character has ever seen, and which ones they
+         * can see right now.  These belong to the layer rather than to the
+         * tiles, since lots of places share the same tile objects.
+         */
+        Bitplane explored;
+        Bitplane visible;
+
+        /**
+         * Where paths can leave the layer, for planning routes between
+         * chunks.  Built by build_portals() once the layer is finished.
+         */
+        ChunkPortals portals;
+
         /**
          * Copies over all values from the given layer to this layer.
          * @param l - The layer from which to swap ownership.
@@ -272,6 +296,31 @@ class ChunkLayer {
          */
         std::vector<Building>* get_buildings();
 
+        /**
+         * Returns the summary of this layer, bringing any blocks that have
+         * changed up to date first.
+         */
+        const ChunkSummary& get_summary();
+
+        /**
+         * @return the tiles of this layer that the main character has seen.
+         */
+        Bitplane& get_explored();
+
+        /**
+         * @return the tiles of this layer that the main character can see
+         * right now.
+         */
+        Bitplane& get_visible();
+
+        /**
+         * Finds the portals of the layer.  Call this again if the ground
+         * changes.
+         */
+        void build_portals();
+
+        const ChunkPortals& get_portals() const;
+
 
         /**
          * Returns the characters created by this chunk, or by
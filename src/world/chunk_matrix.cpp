@@ -101,6 +101,15 @@ Chunk* ChunkMatrix::get_chunk_abs(int row, int col) {
     return get_chunk_abs(IntPoint(row, col));
 }
 
+Chunk* ChunkMatrix::find_chunk_abs(IntPoint abs_chunk_loc) {
+    IntPoint localized = IntPoint(abs_chunk_loc.row - offset.row,
+                                  abs_chunk_loc.col - offset.col);
+    if(out_of_bounds(localized)) {
+        return NULL;
+    }
+    return get_chunk_abs(abs_chunk_loc);
+}
+
 Chunk* ChunkMatrix::get_center_chunk() {
     int rowcol = (diameter - 1) / 2;
     //Umm...if diameter is 3, this will give you 1, not 2
@@ -231,6 +240,40 @@ void ChunkMatrix::shift_matrix(IntPoint directions, MapTileMatrix &world_map) {
     cout<<"New offset: "<<offset.row<<", "<<offset.col<<endl;
 }
 
+void ChunkMatrix::resize(int _diameter, MapTileMatrix &world_map) {
+    assert(_diameter%2 != 0);
+    if(_diameter == diameter) {
+        return;
+    }
+
+    IntPoint center = IntPoint(offset.row + (diameter - 1) / 2,
+                               offset.col + (diameter - 1) / 2);
+    IntPoint new_offset = IntPoint(center.row - (_diameter - 1) / 2,
+                                   center.col - (_diameter - 1) / 2);
+    vector<vector<Chunk> > new_model(_diameter, vector<Chunk>(_diameter));
+
+    int world_row, world_col;
+    for(int row = 0; row < _diameter; row++) {
+        world_row = row + new_offset.row;
+        for(int col = 0; col < _diameter; col++) {
+            world_col = col + new_offset.col;
+            IntPoint old_local = IntPoint(world_row - offset.row, world_col - offset.col);
+            if(!out_of_bounds(old_local)) {
+                new_model[row][col] = model[old_local.row][old_local.col];
+            } else if(world_row >= 0 && world_row < WORLD_HEIGHT &&
+                      world_col >= 0 && world_col < WORLD_WIDTH) {
+                new_model[row][col].init(world_map[world_row][world_col],
+                                         world_row, world_col, save_folder, world_map);
+            }
+            //Anything off the edge of the world stays an empty chunk.
+        }
+    }
+
+    model = new_model;
+    diameter = _diameter;
+    offset = new_offset;
+}
+
 /*
 void ChunkMatrix::serialize_all()
 {
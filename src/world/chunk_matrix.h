@@ -124,6 +124,12 @@ class ChunkMatrix
          */
         Chunk* get_chunk_abs(int row, int col);
 
+        /**
+         * Like get_chunk_abs, but returns NULL if the chunk isn't loaded,
+         * instead of the top left chunk.
+         */
+        Chunk* find_chunk_abs(IntPoint abs_chunk_loc);
+
         /**
          * TODO update more code to use this instead of get_chunk_abs(main_char.get_y(),
          * main_char.get_x())
@@ -161,6 +167,15 @@ class ChunkMatrix
          */
         void shift_matrix(IntPoint directions, MapTileMatrix &world_map);
 
+        /**
+         * Grows or shrinks the matrix around the same center chunk.  Chunks
+         * which are in both the old and the new matrix are kept as they are,
+         * and only the new ones are created.
+         * @param _diameter The new diameter.  Must be odd.
+         * @param world_map a reference to the world map.
+         */
+        void resize(int _diameter, MapTileMatrix &world_map);
+
         /**
          * Serializes all the chunks in the chunk_map.
          */
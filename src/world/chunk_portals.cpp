@@ -0,0 +1,128 @@
+/**
+ *  CHUNK_PORTALS.CPP
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "chunk_portals.h"
+
+ChunkPortals::ChunkPortals()
+{
+}
+
+void ChunkPortals::build(const std::vector<std::vector<Tile> >& ground, const std::vector<IntPoint>& up_stairs,
+        const std::vector<IntPoint>& down_stairs)
+{
+    int height = ground.size();
+    int width = height > 0 ? ground[0].size() : 0;
+    passable.resize(height, width);
+    for(int i = 0; i < height; i++)
+    {
+        for(int j = 0; j < width; j++)
+        {
+            passable.assign(i, j, ground[i][j].can_be_moved_through);
+        }
+    }
+
+    portals.clear();
+    add_edge(PORTAL_NORTH, 0, width);
+    add_edge(PORTAL_SOUTH, height - 1, width);
+    add_edge(PORTAL_WEST, 0, height);
+    add_edge(PORTAL_EAST, width - 1, height);
+
+    //Only the first staircase each way is used for changing layers.
+    if(!up_stairs.empty() && passable.in_bounds(up_stairs[0].row, up_stairs[0].col))
+    {
+        add_portal(PORTAL_UP, up_stairs[0], 0, 0);
+    }
+    if(!down_stairs.empty() && passable.in_bounds(down_stairs[0].row, down_stairs[0].col))
+    {
+        add_portal(PORTAL_DOWN, down_stairs[0], 0, 0);
+    }
+
+    int count = portals.size();
+    costs.assign(count * count, FlowField::UNREACHABLE);
+    FlowField field;
+    std::vector<int> from;
+    for(int i = 0; i < count; i++)
+    {
+        costs_from(portals[i].coords, field, from);
+        for(int j = 0; j < count; j++)
+        {
+            costs[i * count + j] = from[j];
+        }
+    }
+}
+
+void ChunkPortals::add_edge(PortalSide side, int fixed, int length)
+{
+    bool rows = side == PORTAL_WEST || side == PORTAL_EAST;
+    int start = -1;
+    for(int i = 0; i <= length; i++)
+    {
+        bool open = i < length && (rows ? passable.test(i, fixed) : passable.test(fixed, i));
+        if(open && start == -1)
+        {
+            start = i;
+        }
+        if(start != -1 && (!open || i - start == MAX_SPAN))
+        {
+            int middle = (start + i - 1) / 2;
+            add_portal(side, rows ? IntPoint(middle, fixed) : IntPoint(fixed, middle), start, i - 1);
+            start = open ? i : -1;
+        }
+    }
+}
+
+void ChunkPortals::add_portal(PortalSide side, IntPoint coords, int first, int last)
+{
+    Portal portal;
+    portal.coords = coords;
+    portal.side = side;
+    portal.first = first;
+    portal.last = last;
+    portals.push_back(portal);
+}
+
+int ChunkPortals::size() const
+{
+    return portals.size();
+}
+
+const Portal& ChunkPortals::get_portal(int index) const
+{
+    return portals[index];
+}
+
+int ChunkPortals::cost(int from, int to) const
+{
+    return costs[from * portals.size() + to];
+}
+
+const BitGrid& ChunkPortals::get_passable() const
+{
+    return passable;
+}
+
+void ChunkPortals::costs_from(IntPoint point, FlowField& field, std::vector<int>& result) const
+{
+    field.build_area(passable, point, 0, 0, passable.get_height(), passable.get_width());
+    result.resize(portals.size());
+    for(size_t i = 0; i < portals.size(); i++)
+    {
+        result[i] = field.distance(portals[i].coords);
+    }
+}
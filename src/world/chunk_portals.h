@@ -0,0 +1,137 @@
+/**
+ *  CHUNK_PORTALS.H
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CHUNK_PORTALS_H
+#define CHUNK_PORTALS_H
+
+#include <vector>
+
+#include "int_point.h"
+#include "bit_grid.h"
+#include "flow_field.h"
+#include "defs.h"
+
+/**
+ * Which edge of a layer a portal is on, or which way its staircase goes.
+ */
+enum PortalSide
+{
+    PORTAL_NORTH,
+    PORTAL_SOUTH,
+    PORTAL_WEST,
+    PORTAL_EAST,
+    PORTAL_UP,
+    PORTAL_DOWN
+};
+
+/**
+ * A place where a path can leave a chunk layer: a run of open tiles along
+ * one of its edges, or a staircase.
+ */
+struct Portal
+{
+    /**
+     * The tile in the middle of the run, or the staircase.
+     */
+    IntPoint coords;
+
+    PortalSide side;
+
+    /**
+     * The first and last column (for the north and south edges) or row
+     * (for the west and east edges) of the run.
+     */
+    int first;
+    int last;
+};
+
+/**
+ * The portals of one chunk layer, and the cost of getting from each of
+ * them to each of the others without leaving the layer.  This is the
+ * part of the route planner's graph that only depends on the layer
+ * itself, so it's worked out once when the chunk is made and kept with
+ * it.  Which portals join up with the neighboring chunks is worked out
+ * when a route is planned, since those chunks might not exist yet.
+ */
+class ChunkPortals
+{
+    public:
+        /**
+         * Runs of open tiles longer than this are split up, so that a wide
+         * open edge doesn't force every route through its middle.
+         */
+        static const int MAX_SPAN = 20;
+
+        ChunkPortals();
+
+        /**
+         * Finds the portals of a layer and the costs between them.
+         * @param ground The tiles of the layer.
+         * @param up_stairs The up staircases of the layer.
+         * @param down_stairs The down staircases of the layer.
+         */
+        void build(const std::vector<std::vector<Tile> >& ground, const std::vector<IntPoint>& up_stairs,
+                const std::vector<IntPoint>& down_stairs);
+
+        int size() const;
+        const Portal& get_portal(int index) const;
+
+        /**
+         * The cost of getting from one portal to another inside of the
+         * layer, or FlowField::UNREACHABLE.
+         */
+        int cost(int from, int to) const;
+
+        /**
+         * Which tiles of the layer can be moved through.  Only the ground
+         * counts; plants and buildings are left for the path that follows
+         * the route to deal with.
+         */
+        const BitGrid& get_passable() const;
+
+        /**
+         * Works out the cost from a point in the layer to every portal.
+         * @param point The point, in the layer's coordinates.
+         * @param field Used for the search, and left holding the distances
+         * to the point from the rest of the layer.
+         * @param result Gets one cost for each portal.
+         */
+        void costs_from(IntPoint point, FlowField& field, std::vector<int>& result) const;
+
+    private:
+        BitGrid passable;
+        std::vector<Portal> portals;
+
+        /**
+         * size() * size() costs, a row for each portal it starts from.
+         */
+        std::vector<int> costs;
+
+        /**
+         * Adds a portal for every run of open tiles along one edge.
+         * @param side Which edge.
+         * @param fixed The row or column that the edge is on.
+         * @param length How many tiles long the edge is.
+         */
+        void add_edge(PortalSide side, int fixed, int length);
+
+        void add_portal(PortalSide side, IntPoint coords, int first, int last);
+};
+
+#endif
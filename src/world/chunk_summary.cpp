@@ -0,0 +1,229 @@
+/**
+ *  CHUNK_SUMMARY.CPP
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include "chunk_summary.h"
+
+ChunkSummary::ChunkSummary()
+{
+    rows = 0;
+    cols = 0;
+    num_dirty = 0;
+}
+
+ChunkSummary::ChunkSummary(int height, int width)
+{
+    rows = (height + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    cols = (width + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    SummaryCell empty = {0, 0, -1, false, false};
+    cells = std::vector<SummaryCell>(rows * cols, empty);
+    dirty = std::vector<bool>(rows * cols, true);
+    num_dirty = rows * cols;
+}
+
+void ChunkSummary::mark_dirty(int row, int col)
+{
+    int block_row = row / BLOCK_SIZE;
+    int block_col = col / BLOCK_SIZE;
+    if(row < 0 || col < 0 || block_row >= rows || block_col >= cols)
+    {
+        return;
+    }
+
+    int index = block_row * cols + block_col;
+    if(!dirty[index])
+    {
+        dirty[index] = true;
+        num_dirty++;
+    }
+}
+
+void ChunkSummary::mark_area_dirty(int row, int col, int height, int width)
+{
+    int first_row = std::max(0, row / BLOCK_SIZE);
+    int first_col = std::max(0, col / BLOCK_SIZE);
+    int last_row = std::min(rows - 1, (row + height - 1) / BLOCK_SIZE);
+    int last_col = std::min(cols - 1, (col + width - 1) / BLOCK_SIZE);
+    for(int i = first_row; i <= last_row; i++)
+    {
+        for(int j = first_col; j <= last_col; j++)
+        {
+            mark_dirty(i * BLOCK_SIZE, j * BLOCK_SIZE);
+        }
+    }
+}
+
+void ChunkSummary::mark_all_dirty()
+{
+    std::fill(dirty.begin(), dirty.end(), true);
+    num_dirty = rows * cols;
+}
+
+bool ChunkSummary::is_dirty() const
+{
+    return num_dirty > 0;
+}
+
+void ChunkSummary::summarize_block(int block_row, int block_col, const TileMatrix& ground)
+{
+    counts.clear();
+    int end_row = std::min((int)ground.size(), (block_row + 1) * BLOCK_SIZE);
+    for(int i = block_row * BLOCK_SIZE; i < end_row; i++)
+    {
+        int end_col = std::min((int)ground[i].size(), (block_col + 1) * BLOCK_SIZE);
+        for(int j = block_col * BLOCK_SIZE; j < end_col; j++)
+        {
+            //There are only ever a handful of different tiles in a block,
+            //so a list is quicker than a map here.
+            int id = ground[i][j].tile_id;
+            size_t k = 0;
+            while(k < counts.size() && counts[k].first != id)
+            {
+                k++;
+            }
+            if(k == counts.size())
+            {
+                counts.push_back(std::pair<int, int>(id, 0));
+            }
+            counts[k].second++;
+        }
+    }
+
+    SummaryCell* cell = &cells[block_row * cols + block_col];
+    cell->building = false;
+    cell->stairs = false;
+    if(counts.empty())
+    {
+        return;
+    }
+
+    //Ties go to whichever tile was seen first, so the result doesn't
+    //flicker between updates.
+    size_t best = 0;
+    for(size_t k = 1; k < counts.size(); k++)
+    {
+        if(counts[k].second > counts[best].second)
+        {
+            best = k;
+        }
+    }
+
+    //Find a tile with that id to get its character and color from.
+    for(int i = block_row * BLOCK_SIZE; i < end_row; i++)
+    {
+        int end_col = std::min((int)ground[i].size(), (block_col + 1) * BLOCK_SIZE);
+        for(int j = block_col * BLOCK_SIZE; j < end_col; j++)
+        {
+            if(ground[i][j].tile_id == counts[best].first)
+            {
+                cell->char_count = ground[i][j].char_count;
+                cell->color = ground[i][j].color;
+                cell->tile_id = ground[i][j].tile_id;
+                return;
+            }
+        }
+    }
+}
+
+void ChunkSummary::update(const TileMatrix& ground, std::vector<Building>& buildings,
+        const std::vector<IntPoint>& up_stairs, const std::vector<IntPoint>& down_stairs,
+        const Tile& up_stair, const Tile& down_stair)
+{
+    if(num_dirty == 0)
+    {
+        return;
+    }
+
+    for(int i = 0; i < rows; i++)
+    {
+        for(int j = 0; j < cols; j++)
+        {
+            if(dirty[i * cols + j])
+            {
+                summarize_block(i, j, ground);
+            }
+        }
+    }
+
+    for(size_t b = 0; b < buildings.size(); b++)
+    {
+        Building* building = &buildings[b];
+        int first_row = std::max(0, building->get_y() / BLOCK_SIZE);
+        int first_col = std::max(0, building->get_x() / BLOCK_SIZE);
+        int last_row = std::min(rows - 1, (building->get_y() + building->get_height() - 1) / BLOCK_SIZE);
+        int last_col = std::min(cols - 1, (building->get_x() + building->get_width() - 1) / BLOCK_SIZE);
+        for(int i = first_row; i <= last_row; i++)
+        {
+            for(int j = first_col; j <= last_col; j++)
+            {
+                if(dirty[i * cols + j])
+                {
+                    SummaryCell* cell = &cells[i * cols + j];
+                    Tile wall = building->get_wall();
+                    cell->building = true;
+                    cell->char_count = wall.char_count;
+                    cell->color = wall.color;
+                }
+            }
+        }
+    }
+
+    for(size_t s = 0; s < up_stairs.size() + down_stairs.size(); s++)
+    {
+        bool up = s < up_stairs.size();
+        IntPoint point = up ? up_stairs[s] : down_stairs[s - up_stairs.size()];
+        int block_row = point.row / BLOCK_SIZE;
+        int block_col = point.col / BLOCK_SIZE;
+        if(point.row < 0 || point.col < 0 || block_row >= rows || block_col >= cols ||
+                !dirty[block_row * cols + block_col])
+        {
+            continue;
+        }
+
+        //Layers without anything below them still have a down stair in
+        //the list, so make sure there's really a staircase there.
+        const Tile& stair = up ? up_stair : down_stair;
+        if(ground[point.row][point.col].tile_id != stair.tile_id)
+        {
+            continue;
+        }
+        SummaryCell* cell = &cells[block_row * cols + block_col];
+        cell->stairs = true;
+        cell->char_count = stair.char_count;
+        cell->color = stair.color;
+    }
+
+    std::fill(dirty.begin(), dirty.end(), false);
+    num_dirty = 0;
+}
+
+int ChunkSummary::get_rows() const
+{
+    return rows;
+}
+
+int ChunkSummary::get_cols() const
+{
+    return cols;
+}
+
+const SummaryCell& ChunkSummary::get_cell(int block_row, int block_col) const
+{
+    return cells[block_row * cols + block_col];
+}
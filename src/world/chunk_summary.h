@@ -0,0 +1,133 @@
+/**
+ *  CHUNK_SUMMARY.H
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CHUNK_SUMMARY_H
+#define CHUNK_SUMMARY_H
+
+#include <vector>
+#include <utility>
+
+#include "defs.h"
+#include "int_point.h"
+#include "building.h"
+
+typedef std::vector<std::vector<Tile> > TileMatrix;
+
+/**
+ * What a single block of a chunk layer looks like from far away.
+ */
+struct SummaryCell {
+    /**
+     * The character and color to draw the block with.  This is the most
+     * common tile in the block, unless it has a building or stairs in it.
+     */
+    int char_count;
+    int color;
+
+    /**
+     * The id of the most common tile in the block.
+     */
+    int tile_id;
+
+    /**
+     * True if any part of a building is in the block.  The block is drawn
+     * as the building's wall.
+     */
+    bool building;
+
+    /**
+     * True if there is a staircase in the block.  Stairs are what you're
+     * looking for on a map, so they are drawn over everything else.
+     */
+    bool stairs;
+};
+
+/**
+ * A low resolution copy of one chunk layer: one cell for every
+ * BLOCK_SIZE x BLOCK_SIZE block of tiles.  The world map and the minimap
+ * draw these instead of looking at every tile.
+ *
+ * The summary keeps track of which blocks have changed since it was last
+ * brought up to date, so when a tile changes only the block it's in gets
+ * looked at again.
+ */
+class ChunkSummary {
+    private:
+        int rows;
+        int cols;
+
+        std::vector<SummaryCell> cells;
+
+        /**
+         * Which blocks need to be summarized again.
+         */
+        std::vector<bool> dirty;
+        int num_dirty;
+
+        /**
+         * How many times each tile id shows up in the block being
+         * summarized.  Kept around so summarizing doesn't allocate.
+         */
+        std::vector<std::pair<int, int> > counts;
+
+        void summarize_block(int block_row, int block_col, const TileMatrix& ground);
+
+    public:
+        /**
+         * The number of tiles along each side of a block.
+         */
+        static const int BLOCK_SIZE = 10;
+
+        ChunkSummary();
+
+        /**
+         * @param height The height of the layer in tiles.
+         * @param width The width of the layer in tiles.
+         */
+        ChunkSummary(int height, int width);
+
+        /**
+         * Marks the block holding the given tile as changed.
+         */
+        void mark_dirty(int row, int col);
+
+        /**
+         * Marks every block that overlaps the given rectangle of tiles.
+         */
+        void mark_area_dirty(int row, int col, int height, int width);
+
+        void mark_all_dirty();
+
+        bool is_dirty() const;
+
+        /**
+         * Summarizes every block that has changed since the last update.
+         * Buildings are drawn over the ground, and stairs over both.
+         */
+        void update(const TileMatrix& ground, std::vector<Building>& buildings,
+                const std::vector<IntPoint>& up_stairs, const std::vector<IntPoint>& down_stairs,
+                const Tile& up_stair, const Tile& down_stair);
+
+        int get_rows() const;
+        int get_cols() const;
+
+        const SummaryCell& get_cell(int block_row, int block_col) const;
+};
+
+#endif
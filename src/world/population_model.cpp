@@ -0,0 +1,122 @@
+/**
+ *  POPULATION_MODEL.CPP
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstdlib>
+#include "population_model.h"
+#include "constants.h"
+
+PopulationModel::PopulationModel()
+{
+    total = 0;
+    elapsed = 0;
+    seed = 1;
+}
+
+long PopulationModel::key(IntPoint chunk, int depth) const
+{
+    return ((long)depth * WORLD_HEIGHT + chunk.row) * WORLD_WIDTH + chunk.col;
+}
+
+int PopulationModel::random()
+{
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 16) & 0x7fff;
+}
+
+void PopulationModel::add(IntPoint chunk, int depth, int type)
+{
+    groups[key(chunk, depth)].push_back(type);
+    total++;
+}
+
+void PopulationModel::take(IntPoint chunk, int depth, std::vector<int>& types)
+{
+    types.clear();
+    std::map<long, std::vector<int> >::iterator it = groups.find(key(chunk, depth));
+    if(it == groups.end())
+    {
+        return;
+    }
+    types.swap(it->second);
+    groups.erase(it);
+    total -= types.size();
+}
+
+void PopulationModel::step(long delta_ms, IntPoint center, int radius)
+{
+    elapsed += delta_ms;
+    if(elapsed < STEP_MS)
+    {
+        return;
+    }
+    elapsed -= STEP_MS;
+
+    //Work out all of the moves first, so nobody moves twice in one step.
+    struct Move
+    {
+        IntPoint chunk;
+        int depth;
+        int type;
+    };
+    std::vector<Move> moves;
+    std::map<long, std::vector<int> >::iterator it = groups.begin();
+    while(it != groups.end())
+    {
+        int depth = it->first / (WORLD_WIDTH * WORLD_HEIGHT);
+        int cell = it->first % (WORLD_WIDTH * WORLD_HEIGHT);
+        IntPoint chunk = IntPoint(cell / WORLD_WIDTH, cell % WORLD_WIDTH);
+        std::vector<int>& types = it->second;
+        for(int i = (int)types.size() - 1; i >= 0; i--)
+        {
+            if(random() % MOVE_CHANCE != 0)
+            {
+                continue;
+            }
+            IntPoint next = IntPoint(chunk.row + random() % 3 - 1, chunk.col + random() % 3 - 1);
+            bool loaded = std::abs(next.row - center.row) <= radius && std::abs(next.col - center.col) <= radius;
+            if(next == chunk || loaded || next.row < 0 || next.col < 0 ||
+                    next.row >= WORLD_HEIGHT || next.col >= WORLD_WIDTH)
+            {
+                continue;
+            }
+            Move move = {next, depth, types[i]};
+            moves.push_back(move);
+            types.erase(types.begin() + i);
+        }
+
+        if(types.empty())
+        {
+            groups.erase(it++);
+        }
+        else
+        {
+            it++;
+        }
+    }
+
+    for(size_t i = 0; i < moves.size(); i++)
+    {
+        groups[key(moves[i].chunk, moves[i].depth)].push_back(moves[i].type);
+    }
+}
+
+int PopulationModel::size() const
+{
+    return total;
+}
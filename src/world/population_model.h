@@ -0,0 +1,93 @@
+/**
+ *  POPULATION_MODEL.H
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POPULATION_MODEL_H
+#define POPULATION_MODEL_H
+
+#include <vector>
+#include <map>
+
+#include "int_point.h"
+
+/**
+ * The characters living in chunks that aren't loaded.  Nobody is close
+ * enough to see them, so there's no need to keep them as characters:
+ * every chunk layer just remembers what kinds of enemies are in it, and
+ * every now and then some of them wander off to a neighbouring chunk.
+ * When a chunk is loaded again, the characters that ended up in it are
+ * made back into enemies.
+ *
+ * The wandering uses its own random numbers, so the model goes the same
+ * way every time for the same characters leaving at the same times.
+ */
+class PopulationModel
+{
+    public:
+        PopulationModel();
+
+        /**
+         * Puts a character in a chunk layer.
+         * @param chunk The chunk, in world coordinates.
+         * @param type What kind of character it is.
+         */
+        void add(IntPoint chunk, int depth, int type);
+
+        /**
+         * Takes everyone out of a chunk layer.
+         * @param types Gets what kind of character each of them is.  It's
+         * cleared first.
+         */
+        void take(IntPoint chunk, int depth, std::vector<int>& types);
+
+        /**
+         * Moves the model's clock forward.  Every STEP_MS, each character
+         * has a one in MOVE_CHANCE chance of moving to one of the eight
+         * chunks around it.  Nobody moves off of the world, or into the
+         * chunks around center that are loaded.
+         * @param center The chunk the main character is in.
+         * @param radius How many chunks out from center are loaded.
+         */
+        void step(long delta_ms, IntPoint center, int radius);
+
+        /**
+         * The number of characters in the model.
+         */
+        int size() const;
+
+    private:
+        static const long STEP_MS = 10000;
+        static const int MOVE_CHANCE = 4;
+
+        /**
+         * The kinds of characters in each chunk layer that has anybody
+         * in it, keyed by key().  It's kept in order so that stepping goes
+         * through the chunks in the same order every time.
+         */
+        std::map<long, std::vector<int> > groups;
+
+        int total;
+        long elapsed;
+        unsigned int seed;
+
+        long key(IntPoint chunk, int depth) const;
+
+        int random();
+};
+
+#endif
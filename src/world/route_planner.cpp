@@ -0,0 +1,232 @@
+/**
+ *  ROUTE_PLANNER.CPP
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include "route_planner.h"
+#include "path_search.h"
+#include "utility.h"
+
+namespace
+{
+    long long node_key(IntPoint chunk, int depth, int portal)
+    {
+        return (((long long)chunk.row * 4096 + chunk.col) * 64 + depth) * 1024 + portal;
+    }
+}
+
+RoutePlanner::RoutePlanner()
+{
+    expanded = 0;
+}
+
+bool RoutePlanner::plan(ChunkMatrix& chunks, RouteStop start, RouteStop _goal, bool use_stairs)
+{
+    nodes.clear();
+    node_index.clear();
+    open.clear();
+    route.clear();
+    expanded = 0;
+    goal = _goal;
+    goal_abs = utility::get_abs(goal.chunk, goal.coords);
+
+    Chunk* start_chunk = chunks.find_chunk_abs(start.chunk);
+    Chunk* goal_chunk = chunks.find_chunk_abs(goal.chunk);
+    if(start_chunk == NULL || goal_chunk == NULL || start_chunk->get_portals(start.depth) == NULL ||
+            goal_chunk->get_portals(goal.depth) == NULL)
+    {
+        return false;
+    }
+
+    const ChunkPortals* goal_portals = goal_chunk->get_portals(goal.depth);
+    goal_portals->costs_from(goal.coords, field, goal_costs);
+
+    //If they're in the same layer of the same chunk, the field already
+    //knows how far apart they are.
+    if(start.chunk == goal.chunk && start.depth == goal.depth &&
+            field.distance(start.coords) != FlowField::UNREACHABLE)
+    {
+        reach(goal.chunk, goal.depth, GOAL_PORTAL, goal.coords, field.distance(start.coords), -1);
+    }
+
+    const ChunkPortals* start_portals = start_chunk->get_portals(start.depth);
+    start_portals->costs_from(start.coords, field, start_costs);
+    for(int i = 0; i < start_portals->size(); i++)
+    {
+        if(start_costs[i] != FlowField::UNREACHABLE)
+        {
+            reach(start.chunk, start.depth, i, start_portals->get_portal(i).coords, start_costs[i], -1);
+        }
+    }
+
+    while(!open.empty())
+    {
+        std::pop_heap(open.begin(), open.end(), LaterNode());
+        OpenNode current = open.back();
+        open.pop_back();
+        Node& node = nodes[current.index];
+        if(node.closed || current.g != node.g)
+        {
+            continue;
+        }
+        node.closed = true;
+        expanded++;
+
+        if(node.portal == GOAL_PORTAL)
+        {
+            build_route(chunks, current.index);
+            return true;
+        }
+        expand(chunks, current.index, use_stairs);
+    }
+    return false;
+}
+
+void RoutePlanner::reach(IntPoint chunk, int depth, int portal, IntPoint coords, int g, int parent)
+{
+    long long key = node_key(chunk, depth, portal);
+    std::map<long long, int>::iterator it = node_index.find(key);
+    int index;
+    if(it == node_index.end())
+    {
+        index = nodes.size();
+        Node node = {chunk, depth, portal, g, parent, false};
+        nodes.push_back(node);
+        node_index[key] = index;
+    }
+    else
+    {
+        index = it->second;
+        if(nodes[index].closed || nodes[index].g <= g)
+        {
+            return;
+        }
+        nodes[index].g = g;
+        nodes[index].parent = parent;
+    }
+
+    IntPoint abs = utility::get_abs(chunk, coords);
+    OpenNode entry = {g + PathSearch::octile(goal_abs.row - abs.row, goal_abs.col - abs.col), g, index};
+    open.push_back(entry);
+    std::push_heap(open.begin(), open.end(), LaterNode());
+}
+
+void RoutePlanner::expand(ChunkMatrix& chunks, int index, bool use_stairs)
+{
+    Node node = nodes[index];
+    Chunk* chunk = chunks.find_chunk_abs(node.chunk);
+    const ChunkPortals* portals = chunk->get_portals(node.depth);
+    const Portal& portal = portals->get_portal(node.portal);
+
+    for(int i = 0; i < portals->size(); i++)
+    {
+        int cost = portals->cost(node.portal, i);
+        if(i != node.portal && cost != FlowField::UNREACHABLE)
+        {
+            reach(node.chunk, node.depth, i, portals->get_portal(i).coords, node.g + cost, index);
+        }
+    }
+
+    if(node.chunk == goal.chunk && node.depth == goal.depth &&
+            goal_costs[node.portal] != FlowField::UNREACHABLE)
+    {
+        reach(goal.chunk, goal.depth, GOAL_PORTAL, goal.coords, node.g + goal_costs[node.portal], index);
+    }
+
+    if(portal.side == PORTAL_UP || portal.side == PORTAL_DOWN)
+    {
+        int depth = node.depth + (portal.side == PORTAL_DOWN ? 1 : -1);
+        PortalSide other_side = portal.side == PORTAL_DOWN ? PORTAL_UP : PORTAL_DOWN;
+        const ChunkPortals* other = chunk->get_portals(depth);
+        for(int i = 0; use_stairs && other != NULL && i < other->size(); i++)
+        {
+            if(other->get_portal(i).side == other_side)
+            {
+                reach(node.chunk, depth, i, other->get_portal(i).coords, node.g + 10, index);
+            }
+        }
+    }
+    else
+    {
+        cross_edge(chunks, index, portal);
+    }
+}
+
+void RoutePlanner::cross_edge(ChunkMatrix& chunks, int index, const Portal& portal)
+{
+    Node node = nodes[index];
+    IntPoint next_chunk = node.chunk;
+    PortalSide other_side;
+    switch(portal.side)
+    {
+        case PORTAL_NORTH: next_chunk.row--; other_side = PORTAL_SOUTH; break;
+        case PORTAL_SOUTH: next_chunk.row++; other_side = PORTAL_NORTH; break;
+        case PORTAL_WEST: next_chunk.col--; other_side = PORTAL_EAST; break;
+        default: next_chunk.col++; other_side = PORTAL_WEST; break;
+    }
+
+    Chunk* chunk = chunks.find_chunk_abs(next_chunk);
+    const ChunkPortals* other = chunk == NULL ? NULL : chunk->get_portals(node.depth);
+    if(other == NULL)
+    {
+        return;
+    }
+
+    IntPoint from = utility::get_abs(node.chunk, portal.coords);
+    for(int i = 0; i < other->size(); i++)
+    {
+        const Portal& next = other->get_portal(i);
+        if(next.side == other_side && next.first <= portal.last && next.last >= portal.first)
+        {
+            IntPoint to = utility::get_abs(next_chunk, next.coords);
+            int cost = PathSearch::octile(to.row - from.row, to.col - from.col);
+            reach(next_chunk, node.depth, i, next.coords, node.g + cost, index);
+        }
+    }
+}
+
+void RoutePlanner::build_route(ChunkMatrix& chunks, int index)
+{
+    for(; index != -1; index = nodes[index].parent)
+    {
+        const Node& node = nodes[index];
+        RouteStop stop;
+        stop.chunk = node.chunk;
+        stop.depth = node.depth;
+        if(node.portal == GOAL_PORTAL)
+        {
+            stop.coords = goal.coords;
+        }
+        else
+        {
+            stop.coords = chunks.find_chunk_abs(node.chunk)->get_portals(node.depth)->get_portal(node.portal).coords;
+        }
+        route.push_back(stop);
+    }
+    std::reverse(route.begin(), route.end());
+}
+
+const std::vector<RouteStop>& RoutePlanner::get_route() const
+{
+    return route;
+}
+
+int RoutePlanner::get_expanded() const
+{
+    return expanded;
+}
@@ -0,0 +1,154 @@
+/**
+ *  ROUTE_PLANNER.H
+ *
+ *  This file is part of ROGUELIKETHING.
+ *
+ *  ROGUELIKETHING is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  ROGUELIKETHING is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with ROGUELIKETHING.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ROUTE_PLANNER_H
+#define ROUTE_PLANNER_H
+
+#include <vector>
+#include <map>
+
+#include "int_point.h"
+#include "flow_field.h"
+#include "chunk_matrix.h"
+
+/**
+ * A tile somewhere in the world.
+ */
+struct RouteStop
+{
+    IntPoint chunk;
+    IntPoint coords;
+    int depth;
+};
+
+/**
+ * Plans routes that are too long for PathSearch, across chunks and
+ * between layers.
+ *
+ * Rather than looking at tiles, it searches the portals of the chunks
+ * (see ChunkPortals) with A*.  The costs between portals in the same
+ * chunk layer were worked out when the chunk was made, portals on either
+ * side of a chunk edge are joined if their runs of open tiles overlap,
+ * and staircases join layers.  The result is the list of portals to go
+ * through, which can each be walked to with PathSearch.
+ *
+ * Only chunks that are loaded are searched.
+ */
+class RoutePlanner
+{
+    public:
+        RoutePlanner();
+
+        /**
+         * Plans a route.
+         * @param chunks The loaded chunks.
+         * @param start Where the route starts.
+         * @param goal Where the route ends.
+         * @param use_stairs Whether the route can change layers.
+         * @return Whether there's a route.  If there is, get_route() has it.
+         */
+        bool plan(ChunkMatrix& chunks, RouteStop start, RouteStop goal, bool use_stairs);
+
+        /**
+         * The stops along the last route that was planned, in order, not
+         * including the start.  The last one is the goal.
+         */
+        const std::vector<RouteStop>& get_route() const;
+
+        /**
+         * How many portals the last plan took off of the open list.
+         */
+        int get_expanded() const;
+
+    private:
+        /**
+         * A portal that the search has reached.  portal is GOAL_PORTAL
+         * for the goal itself.
+         */
+        struct Node
+        {
+            IntPoint chunk;
+            int depth;
+            int portal;
+            int g;
+            int parent;
+            bool closed;
+        };
+
+        struct OpenNode
+        {
+            int f;
+            int g;
+            int index;
+        };
+
+        struct LaterNode
+        {
+            bool operator()(const OpenNode& a, const OpenNode& b) const
+            {
+                if(a.f != b.f)
+                {
+                    return a.f > b.f;
+                }
+                return a.index > b.index;
+            }
+        };
+
+        static const int GOAL_PORTAL = 1023;
+
+        std::vector<Node> nodes;
+        std::map<long long, int> node_index;
+        std::vector<OpenNode> open;
+        std::vector<RouteStop> route;
+        int expanded;
+
+        RouteStop goal;
+        IntPoint goal_abs;
+
+        /**
+         * Used to find the costs from the start and goal to the portals of
+         * their layers.
+         */
+        FlowField field;
+        std::vector<int> start_costs;
+        std::vector<int> goal_costs;
+
+        /**
+         * Reaches a portal with the given cost, if that's cheaper than
+         * the way it was reached before.
+         */
+        void reach(IntPoint chunk, int depth, int portal, IntPoint coords, int g, int parent);
+
+        /**
+         * Reaches every portal that the node's portal can get to.
+         */
+        void expand(ChunkMatrix& chunks, int index, bool use_stairs);
+
+        /**
+         * Reaches the portals on the other side of a chunk edge.
+         */
+        void cross_edge(ChunkMatrix& chunks, int index, const Portal& portal);
+
+        /**
+         * Fills in the route by following the parents back from a node.
+         */
+        void build_route(ChunkMatrix& chunks, int index);
+};
+
+#endif